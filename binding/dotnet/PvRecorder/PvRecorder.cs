@@ -85,6 +85,12 @@ namespace Pv
         [DllImport(LIBRARY, CallingConvention = CallingConvention.Cdecl)]
         private static extern PvRecorderStatus pv_recorder_read(IntPtr handle, short[] frame);
 
+        [DllImport(LIBRARY, CallingConvention = CallingConvention.Cdecl)]
+        private static extern PvRecorderStatus pv_recorder_read_float(IntPtr handle, float[] frame);
+
+        [DllImport(LIBRARY, CallingConvention = CallingConvention.Cdecl)]
+        private static extern PvRecorderStatus pv_recorder_read_frames(IntPtr handle, short[] pcm, int numFrames, bool waitForAllFrames, out int numFramesRead);
+
         [DllImport(LIBRARY, CallingConvention = CallingConvention.Cdecl)]
         private static extern IntPtr pv_recorder_set_debug_logging(IntPtr handle, bool isDebugLoggingEnabled);
 
@@ -164,6 +170,7 @@ namespace Pv
             }
 
             FrameLength = frameLength;
+            BufferedFramesCount = bufferedFramesCount;
             SampleRate = pv_recorder_sample_rate();
             Version = Marshal.PtrToStringAnsi(pv_recorder_version());
         }
@@ -207,6 +214,57 @@ namespace Pv
             return frame;
         }
 
+        /// <summary>
+        /// Synchronously reads a frame of audio samples converted to floating point in [-1, 1]. Call between `Start()` and `Stop()`.
+        /// </summary>
+        /// <returns>An array of audio samples with length of `frameLength` that was provided upon initialization.</returns>
+        public float[] ReadFloat()
+        {
+            float[] frame = new float[FrameLength];
+            PvRecorderStatus status = pv_recorder_read_float(_libraryPointer, frame);
+            if (status != PvRecorderStatus.SUCCESS)
+            {
+                throw PvRecorderStatusToException(status);
+            }
+            return frame;
+        }
+
+        /// <summary>
+        /// Synchronously reads several frames of audio samples at once. Call between `Start()` and `Stop()`.
+        /// </summary>
+        /// <param name="numFrames">
+        /// Maximum number of frames to read. Must be between 1 and the `bufferedFramesCount` that was provided upon initialization,
+        /// or below it when waiting for all frames, since a full buffer is only reached by overwriting unread audio.
+        /// </param>
+        /// <param name="waitForAllFrames">
+        /// If true, blocks until `numFrames` frames are available. Otherwise blocks until at least one frame is available
+        /// and returns all frames that are available, up to `numFrames`.
+        /// </param>
+        /// <returns>An array of frames, each an array of audio samples with length of `frameLength`.</returns>
+        public short[][] ReadFrames(int numFrames, bool waitForAllFrames = true)
+        {
+            int maxFrames = (waitForAllFrames && BufferedFramesCount > 1) ? BufferedFramesCount - 1 : BufferedFramesCount;
+            if (numFrames <= 0 || numFrames > maxFrames)
+            {
+                throw new PvRecorderInvalidArgumentException($"Number of frames of {numFrames} is invalid - must be between 1 and {maxFrames}.");
+            }
+
+            short[] pcm = new short[numFrames * FrameLength];
+            PvRecorderStatus status = pv_recorder_read_frames(_libraryPointer, pcm, numFrames, waitForAllFrames, out int numFramesRead);
+            if (status != PvRecorderStatus.SUCCESS)
+            {
+                throw PvRecorderStatusToException(status);
+            }
+
+            short[][] frames = new short[numFramesRead][];
+            for (int i = 0; i < numFramesRead; i++)
+            {
+                frames[i] = new short[FrameLength];
+                Array.Copy(pcm, i * FrameLength, frames[i], 0, FrameLength);
+            }
+            return frames;
+        }
+
         /// <summary>
         /// Enable or disable debug logging. Debug logs will indicate when there are overflows
         /// in the internal frame buffer and when an audio source is generating frames of silence.
@@ -225,6 +283,14 @@ namespace Pv
             get; private set;
         }
 
+        /// <summary>
+        /// Gets the number of frames buffered internally by the recorder.
+        /// </summary>
+        public int BufferedFramesCount
+        {
+            get; private set;
+        }
+
         /// <summary>
         /// Gets whether the recorder is currently capturing audio or not.
         /// </summary>
@@ -51,6 +51,47 @@ namespace PvRecorderTest
             }
         }
 
+        [TestMethod]
+        public void TestReadFloat()
+        {
+            using (PvRecorder recorder = PvRecorder.Create(FRAME_LENGTH, deviceIndex: 0))
+            {
+                recorder.Start();
+
+                float[] frame = recorder.ReadFloat();
+                Assert.AreEqual(FRAME_LENGTH, frame.Length);
+                foreach (float sample in frame)
+                {
+                    Assert.IsTrue(sample >= -1.0f && sample <= 1.0f);
+                }
+
+                recorder.Stop();
+            }
+        }
+
+        [TestMethod]
+        public void TestReadFrames()
+        {
+            using (PvRecorder recorder = PvRecorder.Create(FRAME_LENGTH, deviceIndex: 0, bufferedFramesCount: 10))
+            {
+                recorder.Start();
+
+                short[][] frames = recorder.ReadFrames(4);
+                Assert.AreEqual(4, frames.Length);
+                foreach (short[] frame in frames)
+                {
+                    Assert.AreEqual(FRAME_LENGTH, frame.Length);
+                }
+
+                frames = recorder.ReadFrames(4, waitForAllFrames: false);
+                Assert.IsTrue(frames.Length >= 1 && frames.Length <= 4);
+
+                Assert.ThrowsException<PvRecorderInvalidArgumentException>(() => recorder.ReadFrames(11));
+
+                recorder.Stop();
+            }
+        }
+
         [TestMethod]
         public void TestGetAudioDevices()
         {
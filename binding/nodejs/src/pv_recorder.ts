@@ -27,6 +27,7 @@ class PvRecorder {
 
   private readonly _handle: number;
   private readonly _frameLength: number;
+  private readonly _bufferedFramesCount: number;
   private readonly _sampleRate: number;
   private readonly _version: string;
 
@@ -56,6 +57,7 @@ class PvRecorder {
     }
     this._handle = pvRecorderHandleAndStatus.handle;
     this._frameLength = frameLength;
+    this._bufferedFramesCount = bufferedFramesCount;
     this._sampleRate = PvRecorder._pvRecorder.sample_rate();
     this._version = PvRecorder._pvRecorder.version();
   }
@@ -140,6 +142,94 @@ class PvRecorder {
     return pcm;
   }
 
+  /**
+   * Asynchronous call to read a frame of audio data as floating-point samples in [-1, 1]. The conversion is done
+   * natively.
+   *
+   * @returns {Promise<Float32Array>} Audio data frame.
+   */
+  public async readFloat(): Promise<Float32Array> {
+    return new Promise<Float32Array>((resolve, reject) => {
+      setTimeout(() => {
+        const pcm = new Float32Array(this._frameLength);
+        const status = PvRecorder._pvRecorder.read_float(this._handle, pcm);
+        if (status !== PvRecorderStatus.SUCCESS) {
+          reject(pvRecorderStatusToException(status, "PvRecorder failed to read audio data frame."));
+        }
+        resolve(pcm);
+      });
+    });
+  }
+
+  /**
+   * Synchronous call to read a frame of audio data as floating-point samples in [-1, 1]. The conversion is done
+   * natively.
+   *
+   * @returns {Float32Array} Audio data frame.
+   */
+  public readFloatSync(): Float32Array {
+    const pcm = new Float32Array(this._frameLength);
+    const status = PvRecorder._pvRecorder.read_float(this._handle, pcm);
+    if (status !== PvRecorderStatus.SUCCESS) {
+      throw pvRecorderStatusToException(status, "PvRecorder failed to read audio data frame.");
+    }
+    return pcm;
+  }
+
+  /**
+   * Asynchronous call to read several frames of audio data at once.
+   *
+   * @param numFrames Maximum number of frames to read. Must be between 1 and `bufferedFramesCount`, or below it when
+   * waiting for all frames, since a full buffer is only reached by overwriting unread audio.
+   * @param waitForAllFrames If true, waits until `numFrames` frames are available. Otherwise waits until at least one
+   * frame is available and returns all frames that are available, up to `numFrames`.
+   * @returns {Promise<Int16Array[]>} Audio data frames.
+   */
+  public async readFrames(numFrames: number, waitForAllFrames = true): Promise<Int16Array[]> {
+    return new Promise<Int16Array[]>((resolve, reject) => {
+      setTimeout(() => {
+        try {
+          resolve(this.readFramesSync(numFrames, waitForAllFrames));
+        } catch (err: any) {
+          reject(err);
+        }
+      });
+    });
+  }
+
+  /**
+   * Synchronous call to read several frames of audio data at once.
+   *
+   * @param numFrames Maximum number of frames to read. Must be between 1 and `bufferedFramesCount`, or below it when
+   * waiting for all frames, since a full buffer is only reached by overwriting unread audio.
+   * @param waitForAllFrames If true, blocks until `numFrames` frames are available. Otherwise blocks until at least
+   * one frame is available and returns all frames that are available, up to `numFrames`.
+   * @returns {Int16Array[]} Audio data frames. The frames are views into a single buffer.
+   */
+  public readFramesSync(numFrames: number, waitForAllFrames = true): Int16Array[] {
+    let maxFrames = this._bufferedFramesCount;
+    if (waitForAllFrames && maxFrames > 1) {
+      maxFrames -= 1;
+    }
+    if (!Number.isInteger(numFrames) || numFrames <= 0 || numFrames > maxFrames) {
+      throw pvRecorderStatusToException(
+        PvRecorderStatus.INVALID_ARGUMENT,
+        `Number of frames of ${numFrames} is invalid - must be between 1 and ${maxFrames}.`);
+    }
+
+    const pcm = new Int16Array(numFrames * this._frameLength);
+    const result = PvRecorder._pvRecorder.read_frames(this._handle, pcm, numFrames, waitForAllFrames);
+    if (result.status !== PvRecorderStatus.SUCCESS) {
+      throw pvRecorderStatusToException(result.status, "PvRecorder failed to read audio data frames.");
+    }
+
+    const frames: Int16Array[] = [];
+    for (let i = 0; i < result.num_frames_read; i++) {
+      frames.push(pcm.subarray(i * this._frameLength, (i + 1) * this._frameLength));
+    }
+    return frames;
+  }
+
   /**
    * Enable or disable debug logging for PvRecorder. Debug logs will indicate when there are overflows in the internal
    * frame buffer and when an audio source is generating frames of silence.
@@ -42,6 +42,43 @@ describe("Test PvRecorder", () => {
     recorder.release();
   });
 
+  test("read float", async () => {
+    const recorder = new PvRecorder(512, 0);
+    recorder.start();
+
+    const frame = recorder.readFloatSync();
+    expect(frame.length).toEqual(recorder.frameLength);
+    for (const sample of frame) {
+      expect(Math.abs(sample)).toBeLessThanOrEqual(1);
+    }
+
+    expect((await recorder.readFloat()).length).toEqual(recorder.frameLength);
+
+    recorder.release();
+  });
+
+  test("read frames", async () => {
+    const recorder = new PvRecorder(512, 0, 10);
+    recorder.start();
+
+    let frames = recorder.readFramesSync(4);
+    expect(frames.length).toEqual(4);
+    for (const frame of frames) {
+      expect(frame.length).toEqual(recorder.frameLength);
+    }
+
+    frames = await recorder.readFrames(4, false);
+    expect(frames.length).toBeGreaterThanOrEqual(1);
+    expect(frames.length).toBeLessThanOrEqual(4);
+
+    expect(() => recorder.readFramesSync(11)).toThrow(Error);
+    expect(() => recorder.readFramesSync(10)).toThrow(Error);
+    await expect(recorder.readFrames(10)).rejects.toThrow(Error);
+    expect(recorder.readFramesSync(10, false).length).toBeGreaterThanOrEqual(1);
+
+    recorder.release();
+  });
+
   test("set debug logging", () => {
     const recorder = new PvRecorder(512, 0);
     recorder.setDebugLogging(true);
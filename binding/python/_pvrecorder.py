@@ -141,6 +141,7 @@ class PvRecorder(object):
 
         self._handle = POINTER(self.CPvRecorder)()
         self._frame_length = frame_length
+        self._buffered_frames_count = buffered_frames_count
 
         status = init_func(frame_length, device_index, buffered_frames_count, byref(self._handle))
         if status is not self.PvRecorderStatuses.SUCCESS:
@@ -166,6 +167,20 @@ class PvRecorder(object):
         self._read_func.argtypes = [POINTER(self.CPvRecorder), POINTER(c_int16)]
         self._read_func.restype = self.PvRecorderStatuses
 
+        self._read_float_func = library.pv_recorder_read_float
+        self._read_float_func.argtypes = [POINTER(self.CPvRecorder), POINTER(c_float)]
+        self._read_float_func.restype = self.PvRecorderStatuses
+
+        self._read_frames_func = library.pv_recorder_read_frames
+        self._read_frames_func.argtypes = [
+            POINTER(self.CPvRecorder),
+            POINTER(c_int16),
+            c_int32,
+            c_bool,
+            POINTER(c_int32)
+        ]
+        self._read_frames_func.restype = self.PvRecorderStatuses
+
         self._get_is_recording_func = library.pv_recorder_get_is_recording
         self._get_is_recording_func.argtypes = [POINTER(self.CPvRecorder)]
         self._get_is_recording_func.restype = c_bool
@@ -213,6 +228,48 @@ class PvRecorder(object):
             raise self._PVRECORDER_STATUS_TO_EXCEPTION[status]("Failed to read from device.")
         return list(pcm[0:self._frame_length])
 
+    def read_float(self) -> List[float]:
+        """Synchronous call to read a frame of audio as floating-point samples in [-1, 1]. The conversion is done in the
+        native library.
+
+        :return: A frame with size `frame_length` matching the value given to `__init__()`.
+        """
+
+        pcm = (c_float * self._frame_length)()
+        status = self._read_float_func(self._handle, pcm)
+        if status is not self.PvRecorderStatuses.SUCCESS:
+            raise self._PVRECORDER_STATUS_TO_EXCEPTION[status]("Failed to read from device.")
+        return list(pcm[0:self._frame_length])
+
+    def read_frames(self, num_frames: int, wait_for_all_frames: bool = True) -> List[List[int]]:
+        """Synchronous call to read several frames of audio at once.
+
+        :param num_frames: Maximum number of frames to read. Must be between 1 and `buffered_frames_count` that was
+        given to `__init__()`, or below it when waiting for all frames, since a full buffer is only reached by
+        overwriting unread audio.
+        :param wait_for_all_frames: If `True`, blocks until `num_frames` frames are available. Otherwise blocks until at
+        least one frame is available and returns all frames that are available, up to `num_frames`.
+        :return: A list of frames, each with size `frame_length` matching the value given to `__init__()`.
+        """
+
+        max_frames = self._buffered_frames_count
+        if wait_for_all_frames and max_frames > 1:
+            max_frames -= 1
+        if num_frames <= 0 or num_frames > max_frames:
+            raise ValueError(
+                "Number of frames of %d is invalid - must be between 1 and %d." % (num_frames, max_frames))
+
+        pcm = (c_int16 * (num_frames * self._frame_length))()
+        num_frames_read = c_int32()
+        status = self._read_frames_func(self._handle, pcm, num_frames, wait_for_all_frames, byref(num_frames_read))
+        if status is not self.PvRecorderStatuses.SUCCESS:
+            raise self._PVRECORDER_STATUS_TO_EXCEPTION[status]("Failed to read from device.")
+
+        return [
+            list(pcm[(i * self._frame_length):((i + 1) * self._frame_length)])
+            for i in range(num_frames_read.value)
+        ]
+
     def set_debug_logging(self, is_debug_logging_enabled: bool) -> None:
         """
         Enable or disable debug logging for PvRecorder. Debug logs will indicate when there are overflows
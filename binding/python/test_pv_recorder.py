@@ -41,6 +41,31 @@ class PvRecorderTestCase(unittest.TestCase):
         recorder.stop()
         recorder.delete()
 
+    def test_read_float(self):
+        recorder = PvRecorder(512, 0)
+        recorder.start()
+        frame = recorder.read_float()
+        self.assertEqual(len(frame), 512)
+        for sample in frame:
+            self.assertLessEqual(abs(sample), 1.0)
+        recorder.stop()
+        recorder.delete()
+
+    def test_read_frames(self):
+        recorder = PvRecorder(512, 0, 10)
+        recorder.start()
+        frames = recorder.read_frames(4)
+        self.assertEqual(len(frames), 4)
+        for frame in frames:
+            self.assertEqual(len(frame), 512)
+        frames = recorder.read_frames(4, wait_for_all_frames=False)
+        self.assertGreaterEqual(len(frames), 1)
+        self.assertLessEqual(len(frames), 4)
+        with self.assertRaises(ValueError):
+            recorder.read_frames(11)
+        recorder.stop()
+        recorder.delete()
+
     def test_set_debug_logging(self):
         recorder = PvRecorder(512, 0)
         recorder.set_debug_logging(True)
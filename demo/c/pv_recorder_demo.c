@@ -27,12 +27,13 @@ void interrupt_handler(int _) {
 static struct option long_options[] = {
         {"show_audio_devices", no_argument,       NULL, 's'},
         {"output_wav_path",    required_argument, NULL, 'o'},
-        {"audio_device_index", required_argument, NULL, 'd'}
+        {"audio_device_index", required_argument, NULL, 'd'},
+        {"trace_path",         required_argument, NULL, 't'}
 };
 
 static void print_usage(const char *program_name) {
     fprintf(stderr,
-            "Usage : %s -o OUTPUT_WAV_PATH [-d AUDIO_DEVICE_INDEX]\n"
+            "Usage : %s -o OUTPUT_WAV_PATH [-d AUDIO_DEVICE_INDEX] [-t TRACE_PATH]\n"
             "        %s --show_audio_devices\n",
             program_name,
             program_name);
@@ -90,12 +91,28 @@ static void write_wav_header(FILE *file, int32_t num_samples) {
     fwrite(&subchunk2_size, sizeof(subchunk2_size), 1, file);
 }
 
+static void write_trace(pv_recorder_t *recorder, const char *trace_path) {
+    // Paths ending in `.csv` get CSV, anything else a Chrome trace.
+    const size_t length = strlen(trace_path);
+    const bool is_csv = (length >= 4) && (strcmp(trace_path + length - 4, ".csv") == 0);
+
+    pv_recorder_status_t status = pv_recorder_write_trace_log(
+            recorder,
+            trace_path,
+            is_csv ? PV_RECORDER_TRACE_FORMAT_CSV : PV_RECORDER_TRACE_FORMAT_CHROME_TRACE);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        fprintf(stderr, "Failed to write trace with %s.\n", pv_recorder_status_to_string(status));
+        exit(1);
+    }
+}
+
 int main(int argc, char *argv[]) {
     const char *output_wav_path = NULL;
+    const char *trace_path = NULL;
     int32_t device_index = -1;
 
     int c;
-    while ((c = getopt_long(argc, argv, "so:d:", long_options, NULL)) != -1) {
+    while ((c = getopt_long(argc, argv, "so:d:t:", long_options, NULL)) != -1) {
         switch (c) {
             case 's':
                 show_audio_devices();
@@ -106,6 +123,9 @@ int main(int argc, char *argv[]) {
             case 'd':
                 device_index = (int32_t) strtol(optarg, NULL, 10);
                 break;
+            case 't':
+                trace_path = optarg;
+                break;
             default:
                 exit(1);
         }
@@ -122,10 +142,17 @@ int main(int argc, char *argv[]) {
     fprintf(stdout, "Initializing pv_recorder...\n");
     const int32_t frame_length = 512;
     pv_recorder_t *recorder = NULL;
-    pv_recorder_status_t status = pv_recorder_init(
+    pv_recorder_options_t options = pv_recorder_options_init();
+    if (trace_path) {
+        // About one second of events, at one frame per callback.
+        options.trace_log_length = 4096;
+        remove(trace_path);
+    }
+    pv_recorder_status_t status = pv_recorder_init_ex(
             frame_length,
             device_index,
             10,
+            &options,
             &recorder);
     if (status != PV_RECORDER_STATUS_SUCCESS) {
         fprintf(stderr, "Failed to initialize device with %s.\n", pv_recorder_status_to_string(status));
@@ -173,6 +200,10 @@ int main(int argc, char *argv[]) {
         }
 
         num_sample_recorded += frame_length;
+
+        if (trace_path && ((num_sample_recorded % (frame_length * 16)) == 0)) {
+            write_trace(recorder, trace_path);
+        }
     }
 
     rewind(file);
@@ -187,6 +218,10 @@ int main(int argc, char *argv[]) {
         exit(1);
     }
 
+    if (trace_path) {
+        write_trace(recorder, trace_path);
+    }
+
     fprintf(stdout, "Deleting pv_recorder...\n");
     pv_recorder_delete(recorder);
     free(pcm);
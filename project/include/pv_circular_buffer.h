@@ -16,7 +16,10 @@
 #include <stdint.h>
 
 /**
- * Forward declaration of pv_circular_buffer object. It handles reading and writing to a buffer.
+ * Forward declaration of pv_circular_buffer object. It handles reading and writing to a buffer. One producer thread
+ * calling `pv_circular_buffer_write()` and one consumer thread calling `pv_circular_buffer_read()` can use the same
+ * object concurrently without any external locking. The producer never waits on the consumer. When the producer laps
+ * the consumer, the oldest elements are overwritten and the consumer skips ahead to the oldest element still held.
  */
 typedef struct pv_circular_buffer pv_circular_buffer_t;
 
@@ -44,6 +47,23 @@ pv_circular_buffer_status_t pv_circular_buffer_init(
         int32_t element_size,
         pv_circular_buffer_t **object);
 
+/**
+ * Constructor for pv_circular_buffer object that also keeps elements after they are read, so that they can be read
+ * again with `pv_circular_buffer_read_history()`.
+ *
+ * @param element_count Capacity of the buffer to read and write.
+ * @param history_count Number of elements kept behind the read position.
+ * @param element_size Size of each element in the buffer.
+ * @param object[out] Circular buffer object.
+ * @return Status Code. Returns PV_CIRCULAR_BUFFER_STATUS_OUT_OF_MEMORY or PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT
+ * on failure.
+ */
+pv_circular_buffer_status_t pv_circular_buffer_init_with_history(
+        int32_t element_count,
+        int32_t history_count,
+        int32_t element_size,
+        pv_circular_buffer_t **object);
+
 /**
  * Destructor for pv_circular_buffer object.
  *
@@ -52,7 +72,7 @@ pv_circular_buffer_status_t pv_circular_buffer_init(
 void pv_circular_buffer_delete(pv_circular_buffer_t *object);
 
 /**
- * Reads and copies the elements to the provided buffer.
+ * Reads and copies the elements to the provided buffer. Must only be called from the consumer thread.
  *
  * @param object Circular buffer object.
  * @param buffer[out] A pointer to copy the elements into.
@@ -65,9 +85,28 @@ int32_t pv_circular_buffer_read(
         void *buffer,
         int32_t buffer_length);
 
+/**
+ * Reads from an independent cursor instead of the consumer's read position, so that several readers can follow the
+ * same producer. The cursor only affects what this function returns: the producer does not wait for it, and it is
+ * moved past any elements the producer overwrote before they were read. Each cursor must only be used from one thread
+ * at a time. Start a cursor at `pv_circular_buffer_get_write_position()`.
+ *
+ * @param object Circular buffer object.
+ * @param position[in,out] Position of the cursor. Moved past the elements copied and any that were skipped.
+ * @param buffer[out] A pointer to copy the elements into.
+ * @param buffer_length The maximum number of elements to copy.
+ * @return Returns the number of elements copied, or PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT on failure.
+ */
+int32_t pv_circular_buffer_read_at(
+        pv_circular_buffer_t *object,
+        uint64_t *position,
+        void *buffer,
+        int32_t buffer_length);
+
 /**
  * Writes and copies the elements of `buffer` to the object's buffer. Overwrites existing frames if the buffer
- * is full and returns PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW which is not a failure.
+ * is full and returns PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW which is not a failure. Must only be called from the
+ * producer thread. It is wait-free.
  *
  * @param object Circular buffer object.
  * @param buffer A pointer to copy its elements to the object's buffer.
@@ -80,7 +119,116 @@ pv_circular_buffer_status_t pv_circular_buffer_write(
         int32_t buffer_length);
 
 /**
- * Reset the buffer pointers to start.
+ * Gets a pointer to the unread elements without copying them. The elements stay in the buffer until
+ * `pv_circular_buffer_commit()` is called. Must only be called from the consumer thread.
+ *
+ * On platforms where the storage is mirrored in virtual memory, all available elements are contiguous. Otherwise the
+ * returned run stops at the end of the storage and the rest can be peeked after committing it.
+ *
+ * @param object Circular buffer object.
+ * @param buffer[out] Pointer to the first unread element.
+ * @param buffer_length Maximum number of elements to peek.
+ * @return Returns the number of contiguous elements available at `buffer`.
+ */
+int32_t pv_circular_buffer_peek(
+        pv_circular_buffer_t *object,
+        const void **buffer,
+        int32_t buffer_length);
+
+/**
+ * Marks elements obtained from `pv_circular_buffer_peek()` as read. Must only be called from the consumer thread.
+ *
+ * @param object Circular buffer object.
+ * @param length Number of elements to mark as read.
+ * @return Status Code. Returns PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT on failure. Returns
+ * PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW if the producer overwrote the peeked elements before they were committed,
+ * in which case their contents must be discarded.
+ */
+pv_circular_buffer_status_t pv_circular_buffer_commit(pv_circular_buffer_t *object, int32_t length);
+
+/**
+ * Copies the `buffer_length` elements right before the read position, i.e. the most recently read or skipped ones,
+ * without moving the read position. The copy ends at the end of `buffer`. Fewer elements are copied if fewer were
+ * written, or if the producer lapped the consumer and overwrote the oldest of them, in which case the start of
+ * `buffer` is left untouched. Must only be called from the consumer thread.
+ *
+ * @param object Circular buffer object.
+ * @param buffer[out] A pointer to copy the elements into.
+ * @param buffer_length Number of elements to copy. At most the history count given at construction.
+ * @return Returns the number of elements copied, or PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT on failure.
+ */
+int32_t pv_circular_buffer_read_history(
+        pv_circular_buffer_t *object,
+        void *buffer,
+        int32_t buffer_length);
+
+/**
+ * Gets the number of elements available for reading. Can be called from either the producer or the consumer thread.
+ *
+ * @param object Circular buffer object.
+ * @return Number of unread elements, at most the capacity of the buffer.
+ */
+int32_t pv_circular_buffer_get_count(pv_circular_buffer_t *object);
+
+/**
+ * Gets the number of elements available for reading from a cursor used with `pv_circular_buffer_read_at()`. Can be
+ * called from any thread.
+ *
+ * @param object Circular buffer object.
+ * @param position Position of the cursor.
+ * @return Number of elements after the cursor, at most the capacity of the buffer.
+ */
+int32_t pv_circular_buffer_get_count_at(pv_circular_buffer_t *object, const uint64_t *position);
+
+/**
+ * Gets the position of the next element to be written, counted from the first element ever written. Can be called
+ * from any thread.
+ *
+ * @param object Circular buffer object.
+ * @return Number of elements written so far.
+ */
+uint64_t pv_circular_buffer_get_write_position(pv_circular_buffer_t *object);
+
+/**
+ * Gets the position of the next element to read, counted from the first element ever written. Elements that were
+ * skipped or discarded are included, so the position identifies an element for the lifetime of the buffer.
+ *
+ * @param object Circular buffer object.
+ * @return Position of the next unread element.
+ */
+uint64_t pv_circular_buffer_get_read_position(pv_circular_buffer_t *object);
+
+/**
+ * Gets the total number of elements the consumer skipped because the producer overwrote them before they were read.
+ * Elements discarded by `pv_circular_buffer_reset()` are not included. Can be called from any thread.
+ *
+ * @param object Circular buffer object.
+ * @return Number of overwritten elements.
+ */
+uint64_t pv_circular_buffer_get_dropped_count(pv_circular_buffer_t *object);
+
+/**
+ * Discards the unread elements before `position`, e.g. a write position that another thread recorded with
+ * `pv_circular_buffer_get_write_position()` for the consumer to skip to. Does nothing if the read position is already
+ * at or past `position`. Discarded elements are not counted as dropped. Must only be called from the consumer thread.
+ *
+ * @param object Circular buffer object.
+ * @param position Position to move the read position forward to.
+ * @return Whether the read position moved.
+ */
+bool pv_circular_buffer_discard_until(pv_circular_buffer_t *object, uint64_t position);
+
+/**
+ * Skips unread elements and counts them as dropped, for a consumer that gives them up because it cannot use them.
+ * Must only be called from the consumer thread.
+ *
+ * @param object Circular buffer object.
+ * @param length Number of elements to skip. At most the number of unread elements.
+ */
+void pv_circular_buffer_drop(pv_circular_buffer_t *object, int32_t length);
+
+/**
+ * Discards all unread elements. Must only be called from the consumer thread, or while there is no producer.
  *
  * @param object Circular buffer object.
  */
@@ -0,0 +1,92 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_DECIMATOR_H
+#define PV_DECIMATOR_H
+
+#include <stdint.h>
+
+/**
+ * Forward declaration of pv_decimator object. It halves the sample rate of interleaved `float` audio one or more times
+ * with a cascade of halfband filters. Every stage feeds the next, so the output of each stage is available at no
+ * extra cost, e.g. 8kHz and 4kHz from one 16kHz input. Each stage passes up to 85% of its output Nyquist frequency
+ * and attenuates by more than 90dB from 115% of it. Output frame `n` of stage `s` is taken at input frame `n * 2^s`.
+ */
+typedef struct pv_decimator pv_decimator_t;
+
+/**
+ * Status codes.
+ */
+typedef enum {
+    PV_DECIMATOR_STATUS_SUCCESS = 0,
+    PV_DECIMATOR_STATUS_OUT_OF_MEMORY,
+    PV_DECIMATOR_STATUS_INVALID_ARGUMENT,
+} pv_decimator_status_t;
+
+/**
+ * Constructor for pv_decimator object.
+ *
+ * @param num_channels Number of interleaved channels.
+ * @param num_stages Number of halving stages.
+ * @param max_input_frames Maximum number of frames passed to one call of `pv_decimator_process()`.
+ * @param object[out] Decimator object.
+ * @return Status Code. Returns PV_DECIMATOR_STATUS_OUT_OF_MEMORY or PV_DECIMATOR_STATUS_INVALID_ARGUMENT on failure.
+ */
+pv_decimator_status_t pv_decimator_init(
+        int32_t num_channels,
+        int32_t num_stages,
+        int32_t max_input_frames,
+        pv_decimator_t **object);
+
+/**
+ * Destructor for pv_decimator object.
+ *
+ * @param object Decimator object.
+ */
+void pv_decimator_delete(pv_decimator_t *object);
+
+/**
+ * Clears the filter history of every stage, as if no input had been processed.
+ *
+ * @param object Decimator object.
+ */
+void pv_decimator_reset(pv_decimator_t *object);
+
+/**
+ * Gets the largest number of frames a stage produces per call to `pv_decimator_process()`.
+ *
+ * @param object Decimator object.
+ * @param stage Stage, from 0 for the input to `num_stages`.
+ * @return Maximum number of output frames per call.
+ */
+int32_t pv_decimator_get_max_output_frames(pv_decimator_t *object, int32_t stage);
+
+/**
+ * Runs a block of audio through every stage. Consumes all input; the output of each stage is then available from
+ * `pv_decimator_get_output()` until the next call.
+ *
+ * @param object Decimator object.
+ * @param input Interleaved input frames. Must stay valid until the next call, since it is the output of stage 0.
+ * @param num_input_frames Number of input frames, at most `max_input_frames`.
+ */
+void pv_decimator_process(pv_decimator_t *object, const float *input, int32_t num_input_frames);
+
+/**
+ * Gets the frames a stage produced in the last call to `pv_decimator_process()`.
+ *
+ * @param object Decimator object.
+ * @param stage Stage, from 0 for the input to `num_stages`. Stage `s` runs at the input rate divided by `2^s`.
+ * @param num_frames[out] Number of interleaved frames.
+ * @return Interleaved frames, owned by the decimator.
+ */
+const float *pv_decimator_get_output(pv_decimator_t *object, int32_t stage, int32_t *num_frames);
+
+#endif // PV_DECIMATOR_H
@@ -0,0 +1,62 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_LEVEL_METER_H
+#define PV_LEVEL_METER_H
+
+#include <stdint.h>
+
+/**
+ * Level measurements of a block of audio, normalized so that full scale is 1. The measure functions accumulate into
+ * it, so a zero-initialized result can be passed through several calls to measure a block that arrives in pieces.
+ */
+typedef struct {
+    float peak;
+    double sum_squares;
+    int32_t num_samples;
+    int32_t num_clipped;
+} pv_level_meter_result_t;
+
+/**
+ * Measures 16-bit samples. A sample is clipped if it is at either end of the range. Uses AVX2 or SSE2 on x86 and NEON
+ * on ARM when available.
+ *
+ * @param pcm Samples.
+ * @param num_samples Number of samples.
+ * @param result[in,out] Result to accumulate into.
+ */
+void pv_level_meter_measure_s16(const int16_t *pcm, int32_t num_samples, pv_level_meter_result_t *result);
+
+/**
+ * Measures signed samples held in `int32_t`.
+ *
+ * @param pcm Samples.
+ * @param num_samples Number of samples.
+ * @param num_bits Number of significant bits, e.g. 24 for 24-bit samples in the low bits of `int32_t`.
+ * @param result[in,out] Result to accumulate into.
+ */
+void pv_level_meter_measure_s32(
+        const int32_t *pcm,
+        int32_t num_samples,
+        int32_t num_bits,
+        pv_level_meter_result_t *result);
+
+/**
+ * Measures floating-point samples. A sample is clipped if its magnitude is at least 1. Uses SSE2 on x86 and NEON on
+ * ARM when available.
+ *
+ * @param pcm Samples.
+ * @param num_samples Number of samples.
+ * @param result[in,out] Result to accumulate into.
+ */
+void pv_level_meter_measure_f32(const float *pcm, int32_t num_samples, pv_level_meter_result_t *result);
+
+#endif //PV_LEVEL_METER_H
@@ -64,6 +64,139 @@ PV_API pv_recorder_status_t pv_recorder_init(
         int32_t buffered_frames_count,
         pv_recorder_t **object);
 
+/**
+ * Sample formats PvRecorder can deliver. `PV_RECORDER_SAMPLE_FORMAT_S24_32` holds 24-bit samples in the low bits of a
+ * sign-extended `int32_t`. `PV_RECORDER_SAMPLE_FORMAT_F32` holds `float` samples in [-1, 1].
+ */
+typedef enum {
+    PV_RECORDER_SAMPLE_FORMAT_S16 = 0,
+    PV_RECORDER_SAMPLE_FORMAT_S24_32,
+    PV_RECORDER_SAMPLE_FORMAT_S32,
+    PV_RECORDER_SAMPLE_FORMAT_F32
+} pv_recorder_sample_format_t;
+
+/**
+ * Performance profiles. LOW_LATENCY uses short periods of about 10ms, CONSERVATIVE uses periods of about 100ms, which
+ * wake the audio thread less often.
+ */
+typedef enum {
+    PV_RECORDER_PERFORMANCE_PROFILE_LOW_LATENCY = 0,
+    PV_RECORDER_PERFORMANCE_PROFILE_CONSERVATIVE
+} pv_recorder_performance_profile_t;
+
+/**
+ * Scheduling policies for the threads that handle audio. DEFAULT leaves the thread as created by the backend.
+ */
+typedef enum {
+    PV_RECORDER_THREAD_SCHEDULING_DEFAULT = 0,
+    PV_RECORDER_THREAD_SCHEDULING_FIFO,
+    PV_RECORDER_THREAD_SCHEDULING_RR
+} pv_recorder_thread_scheduling_t;
+
+/**
+ * Resamplers for converting the device's sample rate to `sample_rate`. DEFAULT lets miniaudio convert in its data
+ * converter, with a low-order linear resampler. The POLYPHASE resamplers capture at the device's native rate and
+ * resample with windowed-sinc filters of increasing length, which pass more of the band below the Nyquist frequency
+ * and reject more aliasing at a higher CPU cost.
+ */
+typedef enum {
+    PV_RECORDER_RESAMPLER_DEFAULT = 0,
+    PV_RECORDER_RESAMPLER_POLYPHASE_LOW,
+    PV_RECORDER_RESAMPLER_POLYPHASE_MEDIUM,
+    PV_RECORDER_RESAMPLER_POLYPHASE_HIGH
+} pv_recorder_resampler_t;
+
+/**
+ * Options for `pv_recorder_init_ex()`. Initialize with `pv_recorder_options_init()` and then change the fields of
+ * interest, so that fields added in later versions keep their defaults.
+ *
+ * `sample_rate` and `num_channels` set the audio format delivered to the caller. A value of 0 selects the device's
+ * native value, which avoids resampling or channel mixing, e.g. to capture every microphone of an array. Channels are
+ * interleaved, or split per channel by `pv_recorder_read_planar()`. `sample_format` sets the type of each sample. When
+ * the requested configuration matches the device, audio is captured without any conversion.
+ *
+ * `history_ms` is how much audio is kept after it is read, for `pv_recorder_read_history()`.
+ *
+ * `device_id` selects the device by one of the IDs returned by `pv_recorder_get_available_device_ids()`, instead of
+ * `device_index`, which must then be (-1). Unlike an index, an ID keeps pointing at the same device when other
+ * devices are added or removed, and across restarts of the process.
+ *
+ * `performance_profile`, `period_length` and `num_periods` configure the device buffer. The period is the amount of
+ * audio delivered per audio callback, in samples per channel at `sample_rate`, and bounds the latency from capture to
+ * read. A `period_length` or `num_periods` of 0 leaves it to the backend, based on `performance_profile`. With
+ * `is_period_aligned_to_frame` set, `period_length` is rounded to a multiple of `frame_length`, or set to
+ * `frame_length` if it is 0, so that every callback completes whole frames and a reader wakes up once per frame.
+ * Backends treat these values as hints. `pv_recorder_get_period()` reports what the device uses.
+ *
+ * `thread_scheduling`, `thread_priority` and `thread_cpu_mask` apply to the thread that runs the audio callback and
+ * to the thread that runs the frame callback. The audio callback thread is only configured on backends where
+ * miniaudio creates it (ALSA, PulseAudio, WASAPI, DirectSound and WinMM). Other backends, such as Core Audio, run it
+ * on a system thread that is already scheduled for audio, and report the request as unsupported.
+ * `thread_scheduling` selects SCHED_FIFO or SCHED_RR with `thread_priority` between 1 and 99, or the lowest real-time
+ * priority if it is 0. On macOS, whose lowest real-time priority is below the default one, 0 keeps the thread's
+ * priority instead. On Windows both select time-critical priority. `thread_cpu_mask` pins the threads to the CPUs
+ * whose bits are set; 0 leaves them unpinned.
+ * Real-time scheduling usually requires privileges such as CAP_SYS_NICE or an RLIMIT_RTPRIO limit, so
+ * `pv_recorder_get_thread_config_status()` reports whether each request took effect.
+ *
+ * `trace_log_length` is the number of events held by the trace log, see `pv_recorder_drain_trace_log()`. 0 disables
+ * tracing.
+ *
+ * `resampler` selects how audio is resampled when the device does not run at `sample_rate`. With a POLYPHASE
+ * resampler the device is opened at its native rate, so `period_length` is converted to a duration and callbacks are
+ * no longer guaranteed to complete whole frames. Combining it with `is_period_aligned_to_frame` is therefore rejected
+ * with PV_RECORDER_STATUS_INVALID_ARGUMENT. It has no effect when `sample_rate` is 0.
+ *
+ * With more than one channel, `frame_length` and all sample counts and indices reported by PvRecorder count one
+ * sample per channel.
+ */
+typedef struct {
+    int32_t sample_rate;
+    int32_t num_channels;
+    pv_recorder_sample_format_t sample_format;
+    int32_t history_ms;
+    const char *device_id;
+    pv_recorder_performance_profile_t performance_profile;
+    int32_t period_length;
+    int32_t num_periods;
+    bool is_period_aligned_to_frame;
+    pv_recorder_thread_scheduling_t thread_scheduling;
+    int32_t thread_priority;
+    uint64_t thread_cpu_mask;
+    int32_t trace_log_length;
+    pv_recorder_resampler_t resampler;
+} pv_recorder_options_t;
+
+/**
+ * Gets the default options, which match `pv_recorder_init()`: 16kHz, 1 channel, 16-bit samples, no history, the
+ * device selected by `device_index` and the backend's low-latency buffer configuration.
+ *
+ * @return Default options.
+ */
+PV_API pv_recorder_options_t pv_recorder_options_init(void);
+
+/**
+ * Creates a PvRecorder instance with the given audio format. See `pv_recorder_init()` for the other parameters.
+ *
+ * The functions that take `int16_t` buffers require PV_RECORDER_SAMPLE_FORMAT_S16 and return
+ * PV_RECORDER_STATUS_INVALID_STATE otherwise. Audio in any format can be read with `pv_recorder_read_pcm()`.
+ *
+ * @param frame_length The length of audio frame to get for each read call.
+ * @param device_index The index of the audio device to use. A value of (-1) will resort to default device.
+ * @param buffered_frames_count The number of audio frames buffered internally for reading.
+ * @param options Audio format options.
+ * @param[out] object PvRecorder object to be initialized.
+ * @return Status Code. PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_BACKEND_ERROR,
+ * PV_RECORDER_STATUS_DEVICE_INITIALIZED or PV_RECORDER_STATUS_OUT_OF_MEMORY on failure. An unknown `device_id`
+ * returns PV_RECORDER_STATUS_INVALID_ARGUMENT.
+ */
+PV_API pv_recorder_status_t pv_recorder_init_ex(
+        int32_t frame_length,
+        int32_t device_index,
+        int32_t buffered_frames_count,
+        const pv_recorder_options_t *options,
+        pv_recorder_t **object);
+
 /**
  * Releases resources acquired by PvRecorder.
  *
@@ -91,7 +224,10 @@ PV_API pv_recorder_status_t pv_recorder_stop(pv_recorder_t *object);
 
 /**
  * Synchronous call to read frames. Copies amount of frames to `frame` array provided to input.
- * Array size must match the `frame_length` value that was given to `pv_recorder_init()`.
+ * Array size must match the `frame_length` value that was given to `pv_recorder_init()`. Blocks until a full frame has
+ * been captured or the recorder is stopped. If the recorder is stopped while waiting, `frame` is filled with silence
+ * and PV_RECORDER_STATUS_SUCCESS is returned, as in earlier versions; the other read functions return
+ * PV_RECORDER_STATUS_INVALID_STATE instead.
  *
  * @param object PvRecorder object.
  * @param frame[out] An array for the frame to be copied to.
@@ -101,9 +237,460 @@ PV_API pv_recorder_status_t pv_recorder_stop(pv_recorder_t *object);
  */
 PV_API pv_recorder_status_t pv_recorder_read(pv_recorder_t *object, int16_t *frame);
 
+/**
+ * Same as `pv_recorder_read()` for any sample format. Copies `frame_length` * `num_channels` interleaved samples of
+ * the format the recorder was created with to `pcm`.
+ *
+ * @param object PvRecorder object.
+ * @param pcm[out] A buffer of at least `frame_length` * `num_channels` samples.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_INVALID_STATE or
+ * PV_RECORDER_STATUS_IO_ERROR on failure. Returns PV_RECORDER_STATUS_INVALID_STATE if the recorder is stopped while
+ * waiting for audio.
+ */
+PV_API pv_recorder_status_t pv_recorder_read_pcm(pv_recorder_t *object, void *pcm);
+
+/**
+ * Same as `pv_recorder_read_pcm()`, but converts the samples to `float` in [-1, 1]. Integer samples are divided by
+ * their full scale, e.g. 32768 for PV_RECORDER_SAMPLE_FORMAT_S16, in one vectorized pass straight out of the internal
+ * buffer. With PV_RECORDER_SAMPLE_FORMAT_F32 the samples are already `float`, so no conversion is done; the device
+ * delivers them directly if it supports `float`, otherwise the audio backend converts them.
+ *
+ * @param object PvRecorder object.
+ * @param pcm[out] A buffer of at least `frame_length` * `num_channels` samples.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_INVALID_STATE or
+ * PV_RECORDER_STATUS_IO_ERROR on failure. Returns PV_RECORDER_STATUS_INVALID_STATE if the recorder is stopped while
+ * waiting for audio.
+ */
+PV_API pv_recorder_status_t pv_recorder_read_float(pv_recorder_t *object, float *pcm);
+
+/**
+ * Same as `pv_recorder_read_pcm()`, but splits the frame into one buffer per channel, in the sample format the
+ * recorder was created with, and only copies the selected channels. The split is vectorized for 2 and 4 channels.
+ *
+ * @param object PvRecorder object.
+ * @param channels Indices of the channels to read, each at most once, in any order. If NULL, the first
+ * `num_selected_channels` channels are read.
+ * @param num_selected_channels Number of channels to read, between 1 and `num_channels`.
+ * @param pcm[out] `num_selected_channels` buffers of at least `frame_length` samples each. `pcm[i]` receives channel
+ * `channels[i]`.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_INVALID_STATE or
+ * PV_RECORDER_STATUS_IO_ERROR on failure. Returns PV_RECORDER_STATUS_INVALID_STATE if the recorder is stopped while
+ * waiting for audio.
+ */
+PV_API pv_recorder_status_t pv_recorder_read_planar(
+        pv_recorder_t *object,
+        const int32_t *channels,
+        int32_t num_selected_channels,
+        void **pcm);
+
+/**
+ * Timing information about a frame returned by `pv_recorder_read_with_info()`.
+ *
+ * `timestamp_ns` is the estimated capture time of the first sample of the frame, in nanoseconds on the system's
+ * monotonic clock (`CLOCK_MONOTONIC` on Linux and macOS, `QueryPerformanceCounter` on Windows). It is derived from the
+ * time of the most recent audio callback, adjusted for the number of samples captured after the frame.
+ *
+ * `sample_index` is the position of the first sample of the frame among all samples captured since the recorder was
+ * created. Consecutive frames differ by `frame_length` unless samples were dropped.
+ *
+ * `dropped_samples` is the number of samples lost because the internal buffer overflowed since the previous call to
+ * `pv_recorder_read_with_info()`. Samples discarded by `pv_recorder_stop()` are not counted.
+ */
+typedef struct {
+    int64_t timestamp_ns;
+    uint64_t sample_index;
+    uint64_t dropped_samples;
+} pv_recorder_frame_info_t;
+
+/**
+ * Same as `pv_recorder_read()`, but also reports when the frame was captured and whether audio was lost before it.
+ *
+ * @param object PvRecorder object.
+ * @param frame[out] An array for the frame captured.
+ * @param info[out] Timing information for the frame.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_INVALID_STATE or
+ * PV_RECORDER_STATUS_IO_ERROR on failure. Returns PV_RECORDER_STATUS_INVALID_STATE if the recorder is stopped while
+ * waiting for audio.
+ */
+PV_API pv_recorder_status_t pv_recorder_read_with_info(
+        pv_recorder_t *object,
+        int16_t *frame,
+        pv_recorder_frame_info_t *info);
+
+/**
+ * Synchronous call to read several frames at once. Copies up to `num_frames` frames of `frame_length` samples each,
+ * back to back, into `pcm`. Amortizes the per-call overhead of `pv_recorder_read()` for callers that process audio in
+ * batches.
+ *
+ * @param object PvRecorder object.
+ * @param pcm[out] An array of at least `num_frames` * `frame_length` samples for the frames to be copied to.
+ * @param num_frames Maximum number of frames to read. Must be between 1 and the `buffered_frames_count` that was given
+ * to `pv_recorder_init()`, or below it when waiting for all frames: a full buffer is only reached by overwriting unread
+ * audio. A `buffered_frames_count` of 1 allows 1 frame either way.
+ * @param wait_for_all_frames If true, blocks until `num_frames` frames have been captured. Otherwise blocks until at
+ * least one frame has been captured and returns all whole frames that are available, up to `num_frames`. After an
+ * overflow, the read skips ahead to the next frame boundary, so that frames keep their alignment.
+ * @param num_frames_read[out] Number of frames copied to `pcm`.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_INVALID_STATE or
+ * PV_RECORDER_STATUS_IO_ERROR on failure. Returns PV_RECORDER_STATUS_INVALID_STATE if the recorder is stopped while
+ * waiting for audio.
+ */
+PV_API pv_recorder_status_t pv_recorder_read_frames(
+        pv_recorder_t *object,
+        int16_t *pcm,
+        int32_t num_frames,
+        bool wait_for_all_frames,
+        int32_t *num_frames_read);
+
+/**
+ * Zero-copy alternative to `pv_recorder_read()`. Blocks until a full frame has been captured and returns a pointer to
+ * it inside the internal buffer. The frame has `frame_length` samples and stays valid until `pv_recorder_release()`,
+ * `pv_recorder_stop()` or `pv_recorder_delete()` is called. Calling it again before releasing returns the same frame.
+ * Until the frame is released, the reads that copy frames out, i.e. `pv_recorder_read()`, `pv_recorder_read_pcm()`,
+ * `pv_recorder_read_float()`, `pv_recorder_read_planar()`, `pv_recorder_read_with_info()` and
+ * `pv_recorder_read_frames()`, return PV_RECORDER_STATUS_INVALID_STATE, since they would return the peeked frame again.
+ *
+ * On Linux the internal buffer is mirrored in virtual memory, so frames are never copied. On other platforms a frame
+ * that wraps around the end of the internal buffer is copied once into internal storage.
+ *
+ * @param object PvRecorder object.
+ * @param frame[out] Pointer to the captured frame.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_INVALID_STATE or
+ * PV_RECORDER_STATUS_IO_ERROR on failure. Returns PV_RECORDER_STATUS_INVALID_STATE if the recorder is stopped while
+ * waiting for audio.
+ */
+PV_API pv_recorder_status_t pv_recorder_peek(pv_recorder_t *object, const int16_t **frame);
+
+/**
+ * Releases the frame obtained from `pv_recorder_peek()` so that its space can be reused for new audio.
+ *
+ * @param object PvRecorder object.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT or PV_RECORDER_STATUS_INVALID_STATE on failure.
+ * Returns PV_RECORDER_STATUS_IO_ERROR if the frame was overwritten by newer audio before it was released, because
+ * frames were not consumed fast enough. In that case the contents seen through the peeked pointer are not reliable.
+ */
+PV_API pv_recorder_status_t pv_recorder_release(pv_recorder_t *object);
+
+/**
+ * Copies the most recent `num_samples` samples up to the read position without consuming anything, e.g. to get the
+ * audio that led up to a wake word detected in the frame just read. After `pv_recorder_read()` the copy ends with the
+ * frame it returned. Inside a frame callback it ends right before the frame being delivered. Audio skipped by the VAD
+ * gate or lost to an overflow is included as it was captured. If less audio was recorded, the start of `pcm` is
+ * filled with zeros.
+ *
+ * Requires history to be enabled through `pv_recorder_options_t.history_ms`. Must be called from the thread that reads
+ * frames, or from the frame callback.
+ *
+ * @param object PvRecorder object.
+ * @param pcm[out] Buffer of at least `num_samples` samples (times the number of channels) to copy the audio into.
+ * @param num_samples Number of samples to copy. At most `history_ms` worth of audio.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT or PV_RECORDER_STATUS_INVALID_STATE on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_read_history(pv_recorder_t *object, int16_t *pcm, int32_t num_samples);
+
+/**
+ * Maximum number of subscribers per PvRecorder instance.
+ */
+#define PV_RECORDER_MAX_SUBSCRIBERS (8)
+
+/**
+ * Forward declaration for a subscriber to a PvRecorder instance.
+ */
+typedef struct pv_recorder_subscriber pv_recorder_subscriber_t;
+
+/**
+ * Adds a subscriber that reads the same audio as the main reader of the recorder, with its own read position and
+ * frame length, without opening the device again. Subscribers share the recorder's buffer: audio is not copied per
+ * subscriber, and each one sees every sample captured since recording started. The audio device never waits for a
+ * subscriber, so one that falls more than the buffer size behind loses the oldest audio, counted by
+ * `pv_recorder_subscriber_get_dropped_samples()`, without affecting the others. The VAD gate does not apply to
+ * subscribers. The overflow counts in `pv_recorder_get_stats()` only describe the main reader, so they also grow when
+ * an application reads through subscribers alone.
+ *
+ * Must be called while the recorder is stopped. Subscribers that are not removed are freed by `pv_recorder_delete()`.
+ *
+ * @param object PvRecorder object.
+ * @param frame_length Number of samples returned by each `pv_recorder_subscriber_read()`. At most
+ * `frame_length * buffered_frames_count` of the recorder.
+ * @param[out] subscriber Subscriber object.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT or PV_RECORDER_STATUS_OUT_OF_MEMORY on failure.
+ * Returns PV_RECORDER_STATUS_INVALID_STATE if called while recording or if there are already
+ * PV_RECORDER_MAX_SUBSCRIBERS subscribers.
+ */
+PV_API pv_recorder_status_t pv_recorder_subscribe(
+        pv_recorder_t *object,
+        int32_t frame_length,
+        pv_recorder_subscriber_t **subscriber);
+
+/**
+ * Removes and frees a subscriber. Must be called while the recorder is stopped.
+ *
+ * @param subscriber Subscriber object.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT or PV_RECORDER_STATUS_INVALID_STATE on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_unsubscribe(pv_recorder_subscriber_t *subscriber);
+
+/**
+ * Blocks until a frame is available for the subscriber and copies it into `frame`. Each subscriber must be read from
+ * one thread at a time, but different subscribers and the main reader can be read from different threads concurrently.
+ * Requires PV_RECORDER_SAMPLE_FORMAT_S16.
+ *
+ * @param subscriber Subscriber object.
+ * @param[out] frame Buffer of the subscriber's `frame_length` samples (times the number of channels).
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_INVALID_STATE or
+ * PV_RECORDER_STATUS_IO_ERROR on failure. Returns PV_RECORDER_STATUS_INVALID_STATE if the recorder is stopped. Audio
+ * still buffered at a stop is discarded, so after a restart the subscriber reads from the start of the new recording.
+ */
+PV_API pv_recorder_status_t pv_recorder_subscriber_read(pv_recorder_subscriber_t *subscriber, int16_t *frame);
+
+/**
+ * Gets the number of samples the subscriber lost because it did not read them before they were overwritten.
+ *
+ * @param subscriber Subscriber object.
+ * @param[out] dropped_samples Number of samples lost since the subscriber was created.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_subscriber_get_dropped_samples(
+        pv_recorder_subscriber_t *subscriber,
+        uint64_t *dropped_samples);
+
+/**
+ * Maximum number of output streams per PvRecorder instance.
+ */
+#define PV_RECORDER_MAX_OUTPUTS (8)
+
+/**
+ * Forward declaration for an output stream of a PvRecorder instance.
+ */
+typedef struct pv_recorder_output pv_recorder_output_t;
+
+/**
+ * Adds an output stream that delivers the recorder's audio at a lower sample rate, with its own frame length, buffer
+ * and read call, without opening the device again. Each output buffers `buffered_frames_count` of its own frames.
+ *
+ * All outputs share one anti-aliased conversion chain, run in the audio callback. The audio is resampled once to the
+ * highest output rate if that differs from the recorder's, then halved by a cascade of halfband filters. An output at
+ * the highest rate divided by 2, 4, 8, ... reads a stage of the cascade directly, so e.g. 16kHz and 8kHz outputs cost
+ * one resampler and one halfband stage. Outputs at other rates are resampled from the nearest stage above them.
+ *
+ * As for subscribers, the VAD gate does not apply to outputs, and the audio device never waits for an output: one that
+ * falls behind loses the oldest audio, counted by `pv_recorder_output_get_dropped_samples()`.
+ *
+ * Must be called while the recorder is stopped. Requires PV_RECORDER_SAMPLE_FORMAT_S16. Outputs that are not removed
+ * are freed by `pv_recorder_delete()`.
+ *
+ * @param object PvRecorder object.
+ * @param sample_rate Sample rate of the output, at most the recorder's.
+ * @param frame_length Number of samples returned by each `pv_recorder_output_read()`.
+ * @param[out] output Output object.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT or PV_RECORDER_STATUS_OUT_OF_MEMORY on failure.
+ * Returns PV_RECORDER_STATUS_INVALID_STATE if called while recording, with another sample format, or if there are
+ * already PV_RECORDER_MAX_OUTPUTS outputs.
+ */
+PV_API pv_recorder_status_t pv_recorder_add_output(
+        pv_recorder_t *object,
+        int32_t sample_rate,
+        int32_t frame_length,
+        pv_recorder_output_t **output);
+
+/**
+ * Removes and frees an output stream. Must be called while the recorder is stopped.
+ *
+ * @param output Output object.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_INVALID_STATE or
+ * PV_RECORDER_STATUS_OUT_OF_MEMORY on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_remove_output(pv_recorder_output_t *output);
+
+/**
+ * Blocks until a frame is available from the output and copies it into `frame`. Each output must be read from one
+ * thread at a time, but different outputs, subscribers and the main reader can be read from different threads
+ * concurrently.
+ *
+ * @param output Output object.
+ * @param[out] frame Buffer of the output's `frame_length` samples (times the number of channels).
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_INVALID_STATE or
+ * PV_RECORDER_STATUS_IO_ERROR on failure. Returns PV_RECORDER_STATUS_INVALID_STATE if the recorder is stopped.
+ */
+PV_API pv_recorder_status_t pv_recorder_output_read(pv_recorder_output_t *output, int16_t *frame);
+
+/**
+ * Gets the number of samples the output lost because it did not read them before they were overwritten.
+ *
+ * @param output Output object.
+ * @param[out] dropped_samples Number of samples lost since the output was created.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_output_get_dropped_samples(
+        pv_recorder_output_t *output,
+        uint64_t *dropped_samples);
+
+/**
+ * Maximum number of workers of the work queue.
+ */
+#define PV_RECORDER_MAX_WORKERS (32)
+
+/**
+ * Sets up a work queue that hands each captured frame to exactly one of `num_workers` threads calling
+ * `pv_recorder_dequeue()`, as opposed to subscribers, which all see every frame. The queue is independent of the main
+ * reader and of subscribers. Passing 0 removes it. Must be called while the recorder is stopped.
+ *
+ * @param object PvRecorder object.
+ * @param num_workers Number of workers, at most PV_RECORDER_MAX_WORKERS.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT or PV_RECORDER_STATUS_OUT_OF_MEMORY on failure.
+ * Returns PV_RECORDER_STATUS_INVALID_STATE if called while recording.
+ */
+PV_API pv_recorder_status_t pv_recorder_set_num_workers(pv_recorder_t *object, int32_t num_workers);
+
+/**
+ * Blocks until a frame no other worker has taken is available, and copies it into `frame`. Workers take frames with
+ * a compare-and-swap on a shared counter and copy them straight out of the capture buffer, so no lock is shared
+ * between workers or with the audio device. Idle workers sleep on their own event and the audio device only wakes as
+ * many of them as there are new frames.
+ *
+ * `sequence_number` counts frames from the start of recording and can be used to put results back in order. Frames
+ * that no worker took before they were overwritten are skipped and show up as gaps in the sequence. Frames no worker
+ * took before `pv_recorder_stop()` are dropped, and the sequence starts again at 0 on the next start.
+ *
+ * Each `worker_id` must only be used by one thread at a time. Requires PV_RECORDER_SAMPLE_FORMAT_S16.
+ *
+ * @param object PvRecorder object.
+ * @param worker_id Index of the calling worker, from 0 to `num_workers - 1`.
+ * @param[out] frame Buffer of `frame_length` samples (times the number of channels).
+ * @param[out] sequence_number Index of the frame since recording started.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_INVALID_STATE or
+ * PV_RECORDER_STATUS_IO_ERROR on failure. Returns PV_RECORDER_STATUS_INVALID_STATE if the recorder is stopped.
+ */
+PV_API pv_recorder_status_t pv_recorder_dequeue(
+        pv_recorder_t *object,
+        int32_t worker_id,
+        int16_t *frame,
+        uint64_t *sequence_number);
+
+/**
+ * Callback that receives captured audio frames in push mode.
+ *
+ * @param frame A frame of `frame_length` samples. Only valid for the duration of the call.
+ * @param user_data The `user_data` pointer given to `pv_recorder_set_frame_callback()`.
+ */
+typedef void (*pv_recorder_frame_callback_t)(const int16_t *frame, void *user_data);
+
+/**
+ * Switches PvRecorder to push mode. While recording, a thread owned by PvRecorder waits for audio and calls
+ * `frame_callback` once for every frame, in order. All frames buffered since the previous wakeup are delivered
+ * together. The callback must return quickly enough to keep up with the audio device, or frames will be dropped.
+ *
+ * While a callback is set, `pv_recorder_read()`, `pv_recorder_read_frames()` and `pv_recorder_peek()` return
+ * PV_RECORDER_STATUS_INVALID_STATE. Passing NULL as `frame_callback` switches back to reading frames explicitly.
+ * Must be called while the recorder is stopped.
+ *
+ * @param object PvRecorder object.
+ * @param frame_callback Function called for each frame, or NULL.
+ * @param user_data Pointer passed through to `frame_callback`.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT or PV_RECORDER_STATUS_INVALID_STATE on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_set_frame_callback(
+        pv_recorder_t *object,
+        pv_recorder_frame_callback_t frame_callback,
+        void *user_data);
+
+/**
+ * Gets a file descriptor for use with `poll()`, `epoll` or `io_uring` in an event loop. It is readable while
+ * `pv_recorder_read()` would return without blocking: either a full frame is buffered, or the recorder is stopped,
+ * including when the audio device stops unexpectedly. PvRecorder resets it as frames are consumed, so callers must
+ * only wait on it and never read from or close it. It is valid until `pv_recorder_delete()` is called. Only available
+ * on Linux.
+ *
+ * @param object PvRecorder object.
+ * @param fd[out] The file descriptor.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT on failure. Returns PV_RECORDER_STATUS_INVALID_STATE
+ * on platforms without support.
+ */
+PV_API pv_recorder_status_t pv_recorder_get_fd(pv_recorder_t *object, int32_t *fd);
+
+/**
+ * Number of buckets in `pv_recorder_stats_t.period_size_histogram`.
+ */
+#define PV_RECORDER_STATS_PERIOD_HISTOGRAM_SIZE (16)
+
+/**
+ * Number of buckets in `pv_recorder_stats_t.read_latency_histogram`.
+ */
+#define PV_RECORDER_STATS_LATENCY_HISTOGRAM_SIZE (24)
+
+/**
+ * Runtime statistics of a PvRecorder instance, accumulated since it was created.
+ *
+ * `callback_count` is the number of times the audio device delivered audio. `overflow_count` is how many of those
+ * deliveries overwrote audio that was not read yet, and `dropped_samples` is the total number of samples lost that way.
+ * Both are counted by the audio callback against the main read position, so they also grow while audio is only
+ * consumed through subscribers, outputs or workers. `dropped_samples` also includes the samples a reader skips after
+ * an overflow to resume at a frame boundary.
+ *
+ * `buffer_high_water_mark` is the largest number of samples held in the internal buffer, out of `buffer_capacity`.
+ *
+ * `period_size_histogram[i]` counts deliveries of `[2^i, 2^(i+1))` samples. The last bucket also counts larger ones.
+ *
+ * `callback_duration_*_ns` is the time PvRecorder spends in the audio device callback.
+ *
+ * `read_latency_histogram[i]` counts frames returned to the caller `[2^i, 2^(i+1))` microseconds after the last
+ * sample of the frame arrived. The first bucket also counts shorter latencies and the last one longer latencies. It
+ * covers every read function as well as frames delivered through a frame callback.
+ *
+ * `num_gated_frames` is the number of frames discarded by the VAD gate. See `pv_recorder_set_vad_gate()`.
+ */
+typedef struct {
+    uint64_t callback_count;
+    uint64_t overflow_count;
+    uint64_t dropped_samples;
+    int32_t buffer_high_water_mark;
+    int32_t buffer_capacity;
+    uint64_t period_size_histogram[PV_RECORDER_STATS_PERIOD_HISTOGRAM_SIZE];
+    int64_t callback_duration_min_ns;
+    int64_t callback_duration_avg_ns;
+    int64_t callback_duration_max_ns;
+    uint64_t read_latency_histogram[PV_RECORDER_STATS_LATENCY_HISTOGRAM_SIZE];
+    uint64_t num_gated_frames;
+} pv_recorder_stats_t;
+
+/**
+ * Gets a snapshot of the runtime statistics. Can be called from any thread while recording. Counters are updated
+ * independently, so a snapshot taken while recording may be off by one delivery between fields.
+ *
+ * @param object PvRecorder object.
+ * @param stats[out] The statistics.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_get_stats(pv_recorder_t *object, pv_recorder_stats_t *stats);
+
+/**
+ * Input level measured by PvRecorder on every period delivered by the audio device.
+ *
+ * `peak` and `rms` describe the most recent period across all channels, normalized so that full scale is 1. They may
+ * come from consecutive periods when read while recording. `num_clipped_samples` is the number of samples at full
+ * scale since the recorder was created. `is_muted` is set once the input has been silent for two seconds and cleared
+ * by the next period that is not.
+ */
+typedef struct {
+    float peak;
+    float rms;
+    uint64_t num_clipped_samples;
+    bool is_muted;
+} pv_recorder_level_t;
+
+/**
+ * Gets the input level. Can be called from any thread and does not depend on debug logging.
+ *
+ * @param object PvRecorder object.
+ * @param level[out] The input level.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_get_level(pv_recorder_t *object, pv_recorder_level_t *level);
+
 /**
  * Enable or disable debug logging for PvRecorder. Debug logs will indicate when there are overflows in the internal
- * frame buffer and when an audio source is generating frames of silence.
+ * frame buffer and when an audio source is generating frames of silence. They are printed by the read functions, never
+ * by the audio callback.
  *
  * @param object PvRecorder object.
  * @param is_debug_logging_enabled Boolean indicating whether the debug logging is enabled or disabled.
@@ -112,6 +699,77 @@ PV_API void pv_recorder_set_debug_logging(
         pv_recorder_t *object,
         bool is_debug_logging_enabled);
 
+/**
+ * Types of trace events. The value of an event is:
+ *
+ * CALLBACK_BEGIN: samples delivered by the device in the callback.
+ * CALLBACK_END: samples written to the buffer by the callback.
+ * OVERFLOW: samples written by a callback that overwrote unread audio.
+ * READ: position of the end of the read, counted in samples since the recorder was created.
+ */
+typedef enum {
+    PV_RECORDER_TRACE_EVENT_CALLBACK_BEGIN = 0,
+    PV_RECORDER_TRACE_EVENT_CALLBACK_END,
+    PV_RECORDER_TRACE_EVENT_OVERFLOW,
+    PV_RECORDER_TRACE_EVENT_READ
+} pv_recorder_trace_event_type_t;
+
+/**
+ * A trace event. `timestamp_ns` is taken from a monotonic clock.
+ */
+typedef struct {
+    int64_t timestamp_ns;
+    pv_recorder_trace_event_type_t type;
+    int64_t value;
+} pv_recorder_trace_event_t;
+
+/**
+ * Formats for `pv_recorder_write_trace_log()`. CHROME_TRACE is the JSON trace event format read by chrome://tracing
+ * and Perfetto. CSV has one event per line.
+ */
+typedef enum {
+    PV_RECORDER_TRACE_FORMAT_CHROME_TRACE = 0,
+    PV_RECORDER_TRACE_FORMAT_CSV
+} pv_recorder_trace_format_t;
+
+/**
+ * Removes the oldest events from the trace log enabled by `trace_log_length` in `pv_recorder_options_t`. The audio
+ * callback and the read functions log events into a fixed-size ring without locks, allocation or I/O, so tracing
+ * does not disturb the audio thread. New events are dropped while the log is full, so drain it often enough. Only one
+ * thread at a time can drain the log.
+ *
+ * @param object PvRecorder object.
+ * @param events[out] Events, oldest first.
+ * @param max_events Maximum number of events to get.
+ * @param num_events[out] Number of events stored in `events`.
+ * @param num_lost_events[out] Number of events dropped because the log was full, since the last call.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT on failure, and PV_RECORDER_STATUS_INVALID_STATE
+ * if tracing is not enabled.
+ */
+PV_API pv_recorder_status_t pv_recorder_drain_trace_log(
+        pv_recorder_t *object,
+        pv_recorder_trace_event_t *events,
+        int32_t max_events,
+        int32_t *num_events,
+        uint64_t *num_lost_events);
+
+/**
+ * Drains the trace log and appends the events to a file, creating it if needed. Call it periodically, from a thread
+ * that does not handle audio, to record a trace of any length. A Chrome trace is written as a JSON array without the
+ * closing bracket, which trace viewers accept, so that later calls can keep appending to it. Events dropped because the
+ * log was full are recorded as a `lost_events` entry with their count.
+ *
+ * @param object PvRecorder object.
+ * @param path Path of the file.
+ * @param format File format.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT or PV_RECORDER_STATUS_IO_ERROR on failure, and
+ * PV_RECORDER_STATUS_INVALID_STATE if tracing is not enabled.
+ */
+PV_API pv_recorder_status_t pv_recorder_write_trace_log(
+        pv_recorder_t *object,
+        const char *path,
+        pv_recorder_trace_format_t format);
+
 /**
  * Gets whether the given `pv_recorder_t` instance is currently recording audio or not.
  *
@@ -128,10 +786,137 @@ PV_API bool pv_recorder_get_is_recording(pv_recorder_t *object);
  */
 PV_API const char *pv_recorder_get_selected_device(pv_recorder_t *object);
 
+/**
+ * Gets the buffer configuration the device of the given `pv_recorder_t` instance runs with. The backend may have
+ * adjusted the values requested in `pv_recorder_options_t`.
+ *
+ * @param object PvRecorder object.
+ * @param[out] period_length Audio delivered per callback, in samples per channel at the device's sample rate.
+ * @param[out] num_periods Number of periods in the device buffer.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_get_period(
+        pv_recorder_t *object,
+        int32_t *period_length,
+        int32_t *num_periods);
+
+/**
+ * Outcome of a thread configuration request. A request is PENDING until the thread has run after
+ * `pv_recorder_start()`, since the audio thread is created by the backend and is configured from its first callback.
+ */
+typedef enum {
+    PV_RECORDER_THREAD_CONFIG_NOT_REQUESTED = 0,
+    PV_RECORDER_THREAD_CONFIG_PENDING,
+    PV_RECORDER_THREAD_CONFIG_APPLIED,
+    PV_RECORDER_THREAD_CONFIG_FAILED,
+    PV_RECORDER_THREAD_CONFIG_UNSUPPORTED
+} pv_recorder_thread_config_result_t;
+
+/**
+ * Outcome of the thread options in `pv_recorder_options_t`, for the thread that runs the audio callback (capture) and
+ * the thread that runs the frame callback (consumer).
+ */
+typedef struct {
+    pv_recorder_thread_config_result_t capture_scheduling;
+    pv_recorder_thread_config_result_t capture_affinity;
+    pv_recorder_thread_config_result_t consumer_scheduling;
+    pv_recorder_thread_config_result_t consumer_affinity;
+} pv_recorder_thread_config_status_t;
+
+/**
+ * Gets whether the scheduling and CPU affinity requested in `pv_recorder_options_t` were applied. Failures do not stop
+ * recording; the thread keeps running with its previous configuration.
+ *
+ * @param object PvRecorder object.
+ * @param[out] status Outcome of each request.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_get_thread_config_status(
+        pv_recorder_t *object,
+        pv_recorder_thread_config_status_t *status);
+
+/**
+ * Audio format of a device. A `sample_rate` or `num_channels` of 0 means the device accepts any value.
+ */
+typedef struct {
+    int32_t sample_rate;
+    int32_t num_channels;
+    pv_recorder_sample_format_t sample_format;
+} pv_recorder_device_format_t;
+
+/**
+ * Gets the format the device of the given `pv_recorder_t` instance captures in, and whether audio is converted to the
+ * format requested in `pv_recorder_init_ex()`. Conversion (resampling, channel mixing or sample format conversion)
+ * runs in the audio callback and costs CPU on every period. Choosing a device format from
+ * `pv_recorder_get_device_formats()` avoids it.
+ *
+ * @param object PvRecorder object.
+ * @param[out] device_format Format of the device.
+ * @param[out] is_conversion_needed Whether captured audio is converted before it is buffered.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_get_device_format(
+        pv_recorder_t *object,
+        pv_recorder_device_format_t *device_format,
+        bool *is_conversion_needed);
+
+/**
+ * Audio backends. Only the backends supported by the platform are compiled in.
+ */
+typedef enum {
+    PV_RECORDER_BACKEND_WASAPI = 0,
+    PV_RECORDER_BACKEND_DSOUND,
+    PV_RECORDER_BACKEND_WINMM,
+    PV_RECORDER_BACKEND_COREAUDIO,
+    PV_RECORDER_BACKEND_PULSEAUDIO,
+    PV_RECORDER_BACKEND_ALSA,
+    PV_RECORDER_BACKEND_JACK
+} pv_recorder_backend_t;
+
+/**
+ * Sets the audio backends to try, in order, when the audio context is created. By default every compiled-in backend
+ * is probed, which on systems without a sound server can spend most of the startup time waiting for PulseAudio or
+ * JACK to fail before ALSA is used. Listing only the expected backend, e.g. PV_RECORDER_BACKEND_ALSA, makes startup
+ * fast and predictable.
+ *
+ * The setting applies to the whole process, since all recorders share one context, and must be made while no recorder
+ * exists and no device change callback is set. It drops the cached device list. Passing zero backends restores the
+ * default order.
+ *
+ * @param backends Ordered list of backends. Can be NULL if `num_backends` is 0.
+ * @param num_backends Number of backends in the list.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT or PV_RECORDER_STATUS_INVALID_STATE on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_set_backends(const pv_recorder_backend_t *backends, int32_t num_backends);
+
+/**
+ * Gets the backend that is used for recording and device enumeration. Creates the audio context, and enumerates the
+ * devices, if that has not happened yet.
+ *
+ * @param[out] backend Backend in use.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_BACKEND_ERROR,
+ * PV_RECORDER_STATUS_OUT_OF_MEMORY or PV_RECORDER_STATUS_RUNTIME_ERROR on failure. RUNTIME_ERROR means the backend is
+ * not one of `pv_recorder_backend_t`.
+ */
+PV_API pv_recorder_status_t pv_recorder_get_backend(pv_recorder_backend_t *backend);
+
+/**
+ * Provides string representations of the given backend.
+ *
+ * @param backend Backend.
+ * @return String representation.
+ */
+PV_API const char *pv_recorder_backend_to_string(pv_recorder_backend_t backend);
+
 /**
  * Gets the list of available audio devices that can be used for recording.
  * Free the returned `device_list` array using `pv_recorder_free_device_list()`.
  *
+ * The list is enumerated once per process and cached, together with the audio context shared by all recorders, so
+ * repeated calls do not probe the audio backends again. The indices match `device_index` of `pv_recorder_init()`.
+ * Call `pv_recorder_refresh_available_devices()` to pick up devices that were added or removed, and
+ * `pv_recorder_get_backend()` to find out which backend the list comes from.
+ *
  * @param[out] device_list_length The number of available audio devices.
  * @param[out] device_list The output array containing the list of available audio devices.
  * @return Status Code. Returns PV_RECORDER_STATUS_OUT_OF_MEMORY, PV_RECORDER_STATUS_BACKEND_ERROR or
@@ -141,6 +926,56 @@ PV_API pv_recorder_status_t pv_recorder_get_available_devices(
         int32_t *device_list_length,
         char ***device_list);
 
+/**
+ * Enumerates the audio devices again and updates the list returned by `pv_recorder_get_available_devices()` and used
+ * to resolve `device_index` in `pv_recorder_init()`. Recorders that already exist keep their device.
+ *
+ * @return Status Code. Returns PV_RECORDER_STATUS_OUT_OF_MEMORY, PV_RECORDER_STATUS_BACKEND_ERROR or
+ * PV_RECORDER_STATUS_INVALID_STATE on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_refresh_available_devices(void);
+
+/**
+ * Gets stable IDs of the available audio devices, in the same order as `pv_recorder_get_available_devices()`. An ID
+ * has the form `<backend>:<identifier>` and can be passed as `device_id` in `pv_recorder_options_t`.
+ * Free the returned `device_id_list` array using `pv_recorder_free_available_devices()`.
+ *
+ * @param[out] device_list_length The number of available audio devices.
+ * @param[out] device_id_list The output array containing the IDs of available audio devices.
+ * @return Status Code. Returns PV_RECORDER_STATUS_OUT_OF_MEMORY, PV_RECORDER_STATUS_BACKEND_ERROR or
+ * PV_RECORDER_STATUS_INVALID_ARGUMENT on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_get_available_device_ids(
+        int32_t *device_list_length,
+        char ***device_id_list);
+
+/**
+ * Callback invoked when the list of available audio devices changes. It runs on a background thread, after the list
+ * returned by `pv_recorder_get_available_devices()` has been updated.
+ */
+typedef void (*pv_recorder_device_change_callback_t)(void *user_data);
+
+/**
+ * Sets the callback invoked when audio devices are added or removed. There is one callback per process; setting a new
+ * one replaces the previous one and passing NULL removes it. Concurrent calls are serialized, and the last one to run
+ * wins. This function must not be called from the callback.
+ *
+ * A background thread enumerates the devices every `rescan_interval_ms`, and also as soon as a recorder's device is
+ * stopped or rerouted by the backend, and invokes the callback only if the list differs. With a `rescan_interval_ms`
+ * of 0 it enumerates only on those backend notifications. The thread sleeps in between. Replacing or removing a
+ * callback with a nonzero interval can block for up to that interval.
+ *
+ * @param device_change_callback Callback, or NULL.
+ * @param user_data Pointer passed to the callback.
+ * @param rescan_interval_ms Interval between enumerations, in milliseconds.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT, PV_RECORDER_STATUS_BACKEND_ERROR or
+ * PV_RECORDER_STATUS_OUT_OF_MEMORY on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_set_device_change_callback(
+        pv_recorder_device_change_callback_t device_change_callback,
+        void *user_data,
+        int32_t rescan_interval_ms);
+
 /**
  * Frees the device list initialized by `pv_recorder_get_available_devices()`.
  *
@@ -151,6 +986,31 @@ PV_API void pv_recorder_free_available_devices(
         int32_t device_list_length,
         char **device_list);
 
+/**
+ * Gets the formats an audio device supports natively, as reported by the backend. Requesting one of them in
+ * `pv_recorder_init_ex()` captures audio without conversion. Formats the backend reports in a sample type that
+ * PvRecorder does not deliver are left out. Free the returned `device_formats` array using
+ * `pv_recorder_free_device_formats()`.
+ *
+ * @param device_index The index of the audio device, as in `pv_recorder_get_available_devices()`. A value of (-1)
+ * selects the default device.
+ * @param[out] num_device_formats The number of formats.
+ * @param[out] device_formats The output array containing the formats.
+ * @return Status Code. Returns PV_RECORDER_STATUS_OUT_OF_MEMORY, PV_RECORDER_STATUS_BACKEND_ERROR or
+ * PV_RECORDER_STATUS_INVALID_ARGUMENT on failure.
+ */
+PV_API pv_recorder_status_t pv_recorder_get_device_formats(
+        int32_t device_index,
+        int32_t *num_device_formats,
+        pv_recorder_device_format_t **device_formats);
+
+/**
+ * Frees the formats returned by `pv_recorder_get_device_formats()`.
+ *
+ * @param device_formats The array containing the formats.
+ */
+PV_API void pv_recorder_free_device_formats(pv_recorder_device_format_t *device_formats);
+
 /**
  * Provides string representations of the given status code.
  *
@@ -159,6 +1019,44 @@ PV_API void pv_recorder_free_available_devices(
  */
 PV_API const char *pv_recorder_status_to_string(pv_recorder_status_t status);
 
+/**
+ * Options for `pv_recorder_set_vad_gate()`. Initialize with `pv_recorder_vad_gate_options_init()`.
+ *
+ * The gate tracks the noise floor of the input and opens when the energy of a frame rises `open_threshold_db` above
+ * it. It stays open while frames stay `close_threshold_db` above the noise floor and for `hangover_frames` frames
+ * after that. When it opens, the `pre_roll_frames` frames before the one that opened it are released too, so that the
+ * onset of speech is not cut off.
+ */
+typedef struct {
+    float open_threshold_db;
+    float close_threshold_db;
+    int32_t hangover_frames;
+    int32_t pre_roll_frames;
+} pv_recorder_vad_gate_options_t;
+
+/**
+ * Gets the default VAD gate options: open at 9dB and close at 5dB above the noise floor, 10 frames of hangover and 3
+ * frames of pre-roll.
+ *
+ * @return Default options.
+ */
+PV_API pv_recorder_vad_gate_options_t pv_recorder_vad_gate_options_init(void);
+
+/**
+ * Enables or disables an energy-based voice activity gate. While enabled, the read functions and the frame callback
+ * only return frames that contain speech-like energy and block or wait through silence. Discarded frames are counted
+ * in `pv_recorder_stats_t.num_gated_frames`, and `pv_recorder_frame_info_t.sample_index` can be used to tell where
+ * audio was skipped. The gate restarts learning the noise floor every time recording starts.
+ *
+ * @param object PvRecorder object.
+ * @param options Gate options, or NULL to disable the gate.
+ * @return Status Code. Returns PV_RECORDER_STATUS_INVALID_ARGUMENT or PV_RECORDER_STATUS_OUT_OF_MEMORY on failure.
+ * Returns PV_RECORDER_STATUS_INVALID_STATE if called while recording.
+ */
+PV_API pv_recorder_status_t pv_recorder_set_vad_gate(
+        pv_recorder_t *object,
+        const pv_recorder_vad_gate_options_t *options);
+
 /**
  * Gets the audio sample rate used by PvRecorder.
  *
@@ -166,6 +1064,31 @@ PV_API const char *pv_recorder_status_to_string(pv_recorder_status_t status);
  */
 PV_API int32_t pv_recorder_sample_rate(void);
 
+/**
+ * Gets the sample rate of the audio delivered by the given `pv_recorder_t` instance. Differs from
+ * `pv_recorder_sample_rate()` when a rate was requested through `pv_recorder_init_ex()`.
+ *
+ * @param object PvRecorder object.
+ * @return Sample rate, or 0 if `object` is NULL.
+ */
+PV_API int32_t pv_recorder_get_sample_rate(pv_recorder_t *object);
+
+/**
+ * Gets the number of interleaved channels delivered by the given `pv_recorder_t` instance.
+ *
+ * @param object PvRecorder object.
+ * @return Number of channels, or 0 if `object` is NULL.
+ */
+PV_API int32_t pv_recorder_get_num_channels(pv_recorder_t *object);
+
+/**
+ * Gets the sample format delivered by the given `pv_recorder_t` instance.
+ *
+ * @param object PvRecorder object.
+ * @return Sample format, or PV_RECORDER_SAMPLE_FORMAT_S16 if `object` is NULL.
+ */
+PV_API pv_recorder_sample_format_t pv_recorder_get_sample_format(pv_recorder_t *object);
+
 /**
  * Gets the PvRecorder version.
  *
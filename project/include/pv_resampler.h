@@ -0,0 +1,99 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_RESAMPLER_H
+#define PV_RESAMPLER_H
+
+#include <stdint.h>
+
+/**
+ * Forward declaration of pv_resampler object. It converts interleaved `float` audio between two sample rates with a
+ * polyphase windowed-sinc filter. The ratio of the rates is exact, so the output does not drift. The filter is
+ * aligned so that output sample `n` is taken at input time `n * input_rate / output_rate`; audio comes out as soon as
+ * the filter has seen half its length past that time.
+ */
+typedef struct pv_resampler pv_resampler_t;
+
+/**
+ * Status codes.
+ */
+typedef enum {
+    PV_RESAMPLER_STATUS_SUCCESS = 0,
+    PV_RESAMPLER_STATUS_OUT_OF_MEMORY,
+    PV_RESAMPLER_STATUS_INVALID_ARGUMENT,
+} pv_resampler_status_t;
+
+/**
+ * Quality levels. Higher levels use longer filters, with a narrower transition band and more stopband attenuation,
+ * at a higher CPU cost. The filter length scales with the downsampling factor so that the transition band is the same
+ * fraction of the output rate.
+ */
+typedef enum {
+    PV_RESAMPLER_QUALITY_LOW = 0,
+    PV_RESAMPLER_QUALITY_MEDIUM,
+    PV_RESAMPLER_QUALITY_HIGH
+} pv_resampler_quality_t;
+
+/**
+ * Constructor for pv_resampler object.
+ *
+ * @param input_rate Input sample rate.
+ * @param output_rate Output sample rate.
+ * @param num_channels Number of interleaved channels.
+ * @param max_input_frames Maximum number of frames passed to one call of `pv_resampler_process()`.
+ * @param quality Quality level.
+ * @param object[out] Resampler object.
+ * @return Status Code. Returns PV_RESAMPLER_STATUS_OUT_OF_MEMORY or PV_RESAMPLER_STATUS_INVALID_ARGUMENT on failure,
+ * including for rates whose exact ratio would need an impractically large filter bank.
+ */
+pv_resampler_status_t pv_resampler_init(
+        int32_t input_rate,
+        int32_t output_rate,
+        int32_t num_channels,
+        int32_t max_input_frames,
+        pv_resampler_quality_t quality,
+        pv_resampler_t **object);
+
+/**
+ * Destructor for pv_resampler object.
+ *
+ * @param object Resampler object.
+ */
+void pv_resampler_delete(pv_resampler_t *object);
+
+/**
+ * Clears the filter history, as if no input had been processed.
+ *
+ * @param object Resampler object.
+ */
+void pv_resampler_reset(pv_resampler_t *object);
+
+/**
+ * Gets the number of frames needed at `output` for any call to `pv_resampler_process()`.
+ *
+ * @param object Resampler object.
+ * @return Maximum number of output frames per call.
+ */
+int32_t pv_resampler_get_max_output_frames(pv_resampler_t *object);
+
+/**
+ * Resamples a block of audio. Consumes all input and returns every output frame the filter can produce so far. Uses
+ * AVX2 or SSE on x86 and NEON on ARM when available.
+ *
+ * @param object Resampler object.
+ * @param input Interleaved input frames.
+ * @param num_input_frames Number of input frames, at most `max_input_frames`.
+ * @param output[out] Interleaved output frames. Must hold `pv_resampler_get_max_output_frames()` frames.
+ * @return Number of output frames.
+ */
+int32_t pv_resampler_process(pv_resampler_t *object, const float *input, int32_t num_input_frames, float *output);
+
+#endif // PV_RESAMPLER_H
@@ -0,0 +1,75 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_SAMPLE_CONVERTER_H
+#define PV_SAMPLE_CONVERTER_H
+
+#include <stdint.h>
+
+/**
+ * Converts 16-bit samples to `float` in [-1, 1), dividing by 32768. Uses AVX2 or SSE2 on x86 and NEON on ARM when
+ * available. Every kernel gives the same result, since each sample is converted exactly.
+ *
+ * @param pcm Samples.
+ * @param num_samples Number of samples.
+ * @param output[out] Converted samples. Must not overlap `pcm`.
+ */
+void pv_sample_converter_s16_to_f32(const int16_t *pcm, int32_t num_samples, float *output);
+
+/**
+ * Converts signed samples held in `int32_t` to `float` in [-1, 1]. 32-bit samples near full scale may round to 1.
+ *
+ * @param pcm Samples.
+ * @param num_samples Number of samples.
+ * @param num_bits Number of significant bits, e.g. 24 for 24-bit samples in the low bits of `int32_t`.
+ * @param output[out] Converted samples. Must not overlap `pcm`.
+ */
+void pv_sample_converter_s32_to_f32(const int32_t *pcm, int32_t num_samples, int32_t num_bits, float *output);
+
+/**
+ * Converts `float` samples to 16-bit, multiplying by 32768 and rounding to the nearest integer. Samples outside
+ * [-1, 1) are clipped. Uses SSE2 on x86 and NEON on 64-bit ARM when available.
+ *
+ * @param pcm Samples.
+ * @param num_samples Number of samples.
+ * @param output[out] Converted samples.
+ */
+void pv_sample_converter_f32_to_s16(const float *pcm, int32_t num_samples, int16_t *output);
+
+/**
+ * Converts `float` samples to signed samples held in `int32_t`. Samples outside [-1, 1) are clipped.
+ *
+ * @param pcm Samples.
+ * @param num_samples Number of samples.
+ * @param num_bits Number of significant bits, e.g. 24 for 24-bit samples in the low bits of `int32_t`.
+ * @param output[out] Converted samples.
+ */
+void pv_sample_converter_f32_to_s32(const float *pcm, int32_t num_samples, int32_t num_bits, int32_t *output);
+
+/**
+ * Splits interleaved frames into one buffer per channel. Uses SSE2 on x86 and NEON on ARM for 2 and 4 channels, and
+ * also 3 channels on ARM. Other channel counts are copied one sample at a time.
+ *
+ * @param pcm Interleaved frames.
+ * @param num_frames Number of frames.
+ * @param num_channels Number of channels in each frame.
+ * @param sample_size Size of a sample in bytes, either 2 or 4. Samples are only copied, so 4 covers both `int32_t` and
+ * `float`.
+ * @param outputs[out] `num_channels` buffers of `num_frames` samples. A NULL entry skips that channel.
+ */
+void pv_sample_converter_deinterleave(
+        const void *pcm,
+        int32_t num_frames,
+        int32_t num_channels,
+        int32_t sample_size,
+        void **outputs);
+
+#endif //PV_SAMPLE_CONVERTER_H
@@ -0,0 +1,85 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_TRACE_LOG_H
+#define PV_TRACE_LOG_H
+
+#include <stdint.h>
+
+/**
+ * Forward declaration of pv_trace_log object. It is a fixed-size ring of timestamped events. Any number of threads can
+ * call `pv_trace_log_write()` concurrently; it never blocks, allocates or makes a system call, so it is safe on a
+ * real-time audio thread. One thread at a time drains it with `pv_trace_log_read()`. When the log is full, new events
+ * are dropped and counted as lost.
+ */
+typedef struct pv_trace_log pv_trace_log_t;
+
+/**
+ * Status codes.
+ */
+typedef enum {
+    PV_TRACE_LOG_STATUS_SUCCESS = 0,
+    PV_TRACE_LOG_STATUS_OUT_OF_MEMORY,
+    PV_TRACE_LOG_STATUS_INVALID_ARGUMENT,
+} pv_trace_log_status_t;
+
+/**
+ * A logged event. The meaning of `type` and `value` is up to the caller.
+ */
+typedef struct {
+    int64_t timestamp_ns;
+    int32_t type;
+    int64_t value;
+} pv_trace_log_event_t;
+
+/**
+ * Constructor for pv_trace_log object.
+ *
+ * @param capacity Number of events held. Rounded up to a power of two.
+ * @param object[out] Trace log object.
+ * @return Status Code. Returns PV_TRACE_LOG_STATUS_OUT_OF_MEMORY or PV_TRACE_LOG_STATUS_INVALID_ARGUMENT on failure.
+ */
+pv_trace_log_status_t pv_trace_log_init(int32_t capacity, pv_trace_log_t **object);
+
+/**
+ * Destructor for pv_trace_log object.
+ *
+ * @param object Trace log object.
+ */
+void pv_trace_log_delete(pv_trace_log_t *object);
+
+/**
+ * Appends an event.
+ *
+ * @param object Trace log object.
+ * @param type Event type.
+ * @param timestamp_ns Time of the event.
+ * @param value Event value.
+ */
+void pv_trace_log_write(pv_trace_log_t *object, int32_t type, int64_t timestamp_ns, int64_t value);
+
+/**
+ * Removes the oldest events from the log, in the order they were written. Stops early at an event that is still being
+ * written.
+ *
+ * @param object Trace log object.
+ * @param events[out] Events read.
+ * @param max_events Maximum number of events to read.
+ * @param num_lost_events[out] Number of events dropped because the log was full, since the last call.
+ * @return Number of events read.
+ */
+int32_t pv_trace_log_read(
+        pv_trace_log_t *object,
+        pv_trace_log_event_t *events,
+        int32_t max_events,
+        uint64_t *num_lost_events);
+
+#endif // PV_TRACE_LOG_H
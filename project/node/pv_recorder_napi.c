@@ -284,6 +284,211 @@ napi_value napi_pv_recorder_read(napi_env env, napi_callback_info info) {
     return result;
 }
 
+napi_value napi_pv_recorder_read_float(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2];
+    napi_status status = napi_get_cb_info(env, info, &argc, args, NULL, NULL);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get input arguments");
+        return NULL;
+    }
+
+    uint64_t object_id = 0;
+    bool lossless = false;
+    status = napi_get_value_bigint_uint64(env, args[0], &object_id, &lossless);
+    if ((status != napi_ok) || !lossless) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get the address of the instance of PvRecorder properly");
+        return NULL;
+    }
+
+    napi_typedarray_type arr_type = -1;
+    size_t length = 0;
+    void *frame = NULL;
+    napi_value arr_value = NULL;
+    size_t offset = 0;
+    status = napi_get_typedarray_info(env, args[1], &arr_type, &length, &frame, &arr_value, &offset);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Unable to get the input frame");
+        return NULL;
+    }
+    if (arr_type != napi_float32_array) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Invalid type of input frame. The input frame has to be 'Float32Array'");
+        return NULL;
+    }
+    if (length == 0) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Invalid frame length");
+        return NULL;
+    }
+    if (offset != 0) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Invalid shape of input frame");
+        return NULL;
+    }
+
+
+    pv_recorder_status_t pv_recorder_status = pv_recorder_read_float(
+            (pv_recorder_t *)(uintptr_t) object_id,
+            (float *) frame);
+
+    napi_value result;
+    status = napi_create_int32(env, pv_recorder_status, &result);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to allocate memory for the read float result");
+        return NULL;
+    }
+
+    return result;
+}
+
+napi_value napi_pv_recorder_read_frames(napi_env env, napi_callback_info info) {
+    size_t argc = 4;
+    napi_value args[4];
+    napi_status status = napi_get_cb_info(env, info, &argc, args, NULL, NULL);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get input arguments");
+        return NULL;
+    }
+
+    uint64_t object_id = 0;
+    bool lossless = false;
+    status = napi_get_value_bigint_uint64(env, args[0], &object_id, &lossless);
+    if ((status != napi_ok) || !lossless) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                "Unable to get the address of the instance of PvRecorder properly");
+        return NULL;
+    }
+
+    napi_typedarray_type arr_type = -1;
+    size_t length = 0;
+    void *pcm = NULL;
+    napi_value arr_value = NULL;
+    size_t offset = 0;
+    status = napi_get_typedarray_info(env, args[1], &arr_type, &length, &pcm, &arr_value, &offset);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Unable to get the input pcm");
+        return NULL;
+    }
+    if (arr_type != napi_int16_array) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Invalid type of input pcm. The input pcm has to be 'Int16Array'");
+        return NULL;
+    }
+    if (offset != 0) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Invalid shape of input pcm");
+        return NULL;
+    }
+
+    int32_t num_frames;
+    status = napi_get_value_int32(env, args[2], &num_frames);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Unable to get the number of frames");
+        return NULL;
+    }
+
+    bool wait_for_all_frames;
+    status = napi_get_value_bool(env, args[3], &wait_for_all_frames);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT),
+                "Unable to get the wait for all frames flag");
+        return NULL;
+    }
+
+    int32_t num_frames_read = 0;
+    pv_recorder_status_t pv_recorder_status = pv_recorder_read_frames(
+            (pv_recorder_t *)(uintptr_t) object_id,
+            (int16_t *) pcm,
+            num_frames,
+            wait_for_all_frames,
+            &num_frames_read);
+
+    napi_value object_js = NULL;
+    napi_value num_frames_read_js = NULL;
+    napi_value status_js = NULL;
+    const char *ERROR_MSG = "Unable to allocate memory for the read frames result";
+
+    status = napi_create_object(env, &object_js);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                ERROR_MSG);
+        return NULL;
+    }
+
+    status = napi_create_int32(env, num_frames_read, &num_frames_read_js);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                ERROR_MSG);
+        return NULL;
+    }
+    status = napi_set_named_property(env, object_js, "num_frames_read", num_frames_read_js);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                ERROR_MSG);
+        return NULL;
+    }
+    status = napi_create_int32(env, pv_recorder_status, &status_js);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                ERROR_MSG);
+        return NULL;
+    }
+    status = napi_set_named_property(env, object_js, "status", status_js);
+    if (status != napi_ok) {
+        napi_throw_error(
+                env,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_RUNTIME_ERROR),
+                ERROR_MSG);
+        return NULL;
+    }
+
+    return object_js;
+}
+
 napi_value napi_pv_recorder_get_is_recording(napi_env env, napi_callback_info info) {
     size_t argc = 1;
     napi_value args[1];
@@ -506,6 +711,14 @@ napi_value Init(napi_env env, napi_value exports) {
     status = napi_define_properties(env, exports, 1, &desc);
     assert(status == napi_ok);
 
+    desc = DECLARE_NAPI_METHOD("read_float", napi_pv_recorder_read_float);
+    status = napi_define_properties(env, exports, 1, &desc);
+    assert(status == napi_ok);
+
+    desc = DECLARE_NAPI_METHOD("read_frames", napi_pv_recorder_read_frames);
+    status = napi_define_properties(env, exports, 1, &desc);
+    assert(status == napi_ok);
+
     desc = DECLARE_NAPI_METHOD("get_is_recording", napi_pv_recorder_get_is_recording);
     status = napi_define_properties(env, exports, 1, &desc);
     assert(status == napi_ok);
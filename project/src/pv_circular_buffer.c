@@ -9,27 +9,128 @@
     specific language governing permissions and limitations under the License.
 */
 
+#if defined(__PV_RECORDER_PLATFORM_LINUX__) || defined(__PV_RECORDER_PLATFORM_RASPBERRYPI__)
+
+#define _GNU_SOURCE
+#define PV_CIRCULAR_BUFFER_MIRRORING
+
+#endif
+
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(PV_CIRCULAR_BUFFER_MIRRORING)
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#endif
+
 #include "pv_circular_buffer.h"
 
+#define PV_CIRCULAR_BUFFER_CACHE_LINE_SIZE (64)
+
+/**
+ * Element counters are monotonic and never wrap in practice. The position of an element inside `buffer` is its counter
+ * modulo `slot_count`, which is at least `capacity + history_count`. Elements older than `capacity` are treated as lost
+ * to the consumer even if their slot was not reused yet, which leaves at least `history_count` slots behind the read
+ * position untouched by the producer until it laps the consumer. When `is_mirrored` is set, the storage is mapped twice
+ * back to back in virtual memory so that any run of up to `slot_count` elements is contiguous. Producer and consumer
+ * state live on separate cache lines so that they do not false-share.
+ */
 struct pv_circular_buffer {
     void *buffer;
     int32_t capacity;
-    int32_t count;
+    int32_t history_count;
+    int32_t slot_count;
     int32_t element_size;
-    int32_t read_index;
-    int32_t write_index;
+    bool is_mirrored;
+
+    // Producer state. `write_begin` is published before elements are overwritten and `write_end` after they are
+    // written, which lets the consumer detect when the producer lapped it during a copy.
+    __attribute__((aligned(PV_CIRCULAR_BUFFER_CACHE_LINE_SIZE))) uint64_t write_begin;
+    uint64_t write_end;
+    uint64_t read_count_cache;
+
+    // Consumer state. `dropped_count` counts the elements the consumer skipped because they were overwritten.
+    __attribute__((aligned(PV_CIRCULAR_BUFFER_CACHE_LINE_SIZE))) uint64_t read_count;
+    uint64_t dropped_count;
 };
 
+static void pv_circular_buffer_skip_to(pv_circular_buffer_t *object, uint64_t read_count) {
+    const uint64_t dropped_count = object->dropped_count + (read_count - object->read_count);
+    __atomic_store_n(&object->dropped_count, dropped_count, __ATOMIC_RELAXED);
+    __atomic_store_n(&object->read_count, read_count, __ATOMIC_RELEASE);
+}
+
+static bool pv_circular_buffer_map_mirrored(pv_circular_buffer_t *object) {
+
+#if defined(PV_CIRCULAR_BUFFER_MIRRORING)
+
+    const size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+    const size_t min_size = (size_t) object->slot_count * (size_t) object->element_size;
+    const size_t size = ((min_size + page_size - 1) / page_size) * page_size;
+    if ((size % (size_t) object->element_size) != 0) {
+        return false;
+    }
+
+    const int fd = memfd_create("pv_circular_buffer", MFD_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    if (ftruncate(fd, (off_t) size) != 0) {
+        close(fd);
+        return false;
+    }
+
+    char *base = mmap(NULL, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+
+    if ((mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) ||
+        (mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)) {
+        munmap(base, 2 * size);
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+
+    object->buffer = base;
+    object->slot_count = (int32_t) (size / (size_t) object->element_size);
+    object->is_mirrored = true;
+
+    return true;
+
+#else
+
+    (void) object;
+    return false;
+
+#endif
+
+}
+
 pv_circular_buffer_status_t pv_circular_buffer_init(
         int32_t element_count,
         int32_t element_size,
         pv_circular_buffer_t **object) {
+    return pv_circular_buffer_init_with_history(element_count, 0, element_size, object);
+}
+
+pv_circular_buffer_status_t pv_circular_buffer_init_with_history(
+        int32_t element_count,
+        int32_t history_count,
+        int32_t element_size,
+        pv_circular_buffer_t **object) {
     if (element_count <= 0) {
         return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
     }
+    if ((history_count < 0) || (history_count > (INT32_MAX - element_count))) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
     if (element_size <= 0) {
         return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
     }
@@ -44,15 +145,19 @@ pv_circular_buffer_status_t pv_circular_buffer_init(
         return PV_CIRCULAR_BUFFER_STATUS_OUT_OF_MEMORY;
     }
 
-    o->buffer = malloc(element_count * element_size);
-    if (!(o->buffer)) {
-        pv_circular_buffer_delete(o);
-        return PV_CIRCULAR_BUFFER_STATUS_OUT_OF_MEMORY;
-    }
-
     o->capacity = element_count;
+    o->history_count = history_count;
+    o->slot_count = element_count + history_count;
     o->element_size = element_size;
 
+    if (!pv_circular_buffer_map_mirrored(o)) {
+        o->buffer = malloc((size_t) o->slot_count * (size_t) element_size);
+        if (!(o->buffer)) {
+            pv_circular_buffer_delete(o);
+            return PV_CIRCULAR_BUFFER_STATUS_OUT_OF_MEMORY;
+        }
+    }
+
     *object = o;
 
     return PV_CIRCULAR_BUFFER_STATUS_SUCCESS;
@@ -60,11 +165,97 @@ pv_circular_buffer_status_t pv_circular_buffer_init(
 
 void pv_circular_buffer_delete(pv_circular_buffer_t *object) {
     if (object) {
+
+#if defined(PV_CIRCULAR_BUFFER_MIRRORING)
+
+        if (object->is_mirrored) {
+            munmap(object->buffer, 2 * (size_t) object->slot_count * (size_t) object->element_size);
+        } else {
+            free(object->buffer);
+        }
+
+#else
+
         free(object->buffer);
+
+#endif
+
         free(object);
     }
 }
 
+static void pv_circular_buffer_copy_out(
+        const pv_circular_buffer_t *object,
+        uint64_t position,
+        void *buffer,
+        int32_t length) {
+    const int32_t index = (int32_t) (position % (uint64_t) object->slot_count);
+    const int32_t available = object->is_mirrored ? length : (object->slot_count - index);
+    const int32_t to_copy = (length < available) ? length : available;
+
+    memcpy(buffer, (char *) object->buffer + (index * object->element_size), to_copy * object->element_size);
+
+    const int32_t remaining = length - to_copy;
+    if (remaining > 0) {
+        memcpy((char *) buffer + (to_copy * object->element_size), object->buffer, remaining * object->element_size);
+    }
+}
+
+static void pv_circular_buffer_copy_in(
+        pv_circular_buffer_t *object,
+        uint64_t position,
+        const void *buffer,
+        int32_t length) {
+    const int32_t index = (int32_t) (position % (uint64_t) object->slot_count);
+    const int32_t available = object->is_mirrored ? length : (object->slot_count - index);
+    const int32_t to_copy = (length < available) ? length : available;
+
+    memcpy((char *) object->buffer + (index * object->element_size), buffer, to_copy * object->element_size);
+
+    const int32_t remaining = length - to_copy;
+    if (remaining > 0) {
+        memcpy(
+                object->buffer,
+                (const char *) buffer + (to_copy * object->element_size),
+                remaining * object->element_size);
+    }
+}
+
+/**
+ * Copies up to `buffer_length` elements starting at `*read_count`. If the producer overwrote some of them,
+ * `*read_count` is moved forward to the oldest element still held. Returns the number of elements copied.
+ */
+static int32_t pv_circular_buffer_copy_from(
+        pv_circular_buffer_t *object,
+        uint64_t *read_count_in_out,
+        void *buffer,
+        int32_t buffer_length) {
+    const uint64_t capacity = (uint64_t) object->capacity;
+    uint64_t read_count = *read_count_in_out;
+
+    while (true) {
+        const uint64_t write_end = __atomic_load_n(&object->write_end, __ATOMIC_ACQUIRE);
+        if ((write_end - read_count) > capacity) {
+            read_count = write_end - capacity;
+        }
+
+        const uint64_t count = write_end - read_count;
+        const int32_t to_copy = (count < (uint64_t) buffer_length) ? (int32_t) count : buffer_length;
+
+        pv_circular_buffer_copy_out(object, read_count, buffer, to_copy);
+
+        // If the producer started overwriting the elements we copied, the copy may be torn. Skip past them and retry.
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        const uint64_t write_begin = __atomic_load_n(&object->write_begin, __ATOMIC_RELAXED);
+        if ((write_begin - read_count) <= capacity) {
+            *read_count_in_out = read_count;
+            return to_copy;
+        }
+
+        read_count = write_begin - capacity;
+    }
+}
+
 int32_t pv_circular_buffer_read(
         pv_circular_buffer_t *object,
         void *buffer,
@@ -82,30 +273,39 @@ int32_t pv_circular_buffer_read(
         return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
     }
 
-    void *dst_ptr = buffer;
-    const void *src_ptr = (char *) object->buffer + (object->read_index * object->element_size);
-
-    const int32_t available = object->capacity - object->read_index;
-    const int32_t max_copy = (object->count < buffer_length) ? object->count : buffer_length;
-    const int32_t to_copy = (max_copy < available) ? max_copy : available;
-
-    memcpy(dst_ptr, src_ptr, to_copy * object->element_size);
-
-    object->read_index = (object->read_index + to_copy) % object->capacity;
-
-    const int32_t remaining = max_copy - to_copy;
-    if (remaining > 0) {
-        dst_ptr = (char *) buffer + (to_copy * object->element_size);
-        src_ptr = object->buffer;
+    uint64_t read_count = object->read_count;
+    const int32_t to_copy = pv_circular_buffer_copy_from(object, &read_count, buffer, buffer_length);
+    if (read_count != object->read_count) {
+        pv_circular_buffer_skip_to(object, read_count);
+    }
+    __atomic_store_n(&object->read_count, read_count + (uint64_t) to_copy, __ATOMIC_RELEASE);
 
-        memcpy(dst_ptr, src_ptr, remaining * object->element_size);
+    return to_copy;
+}
 
-        object->read_index = remaining;
+int32_t pv_circular_buffer_read_at(
+        pv_circular_buffer_t *object,
+        uint64_t *position,
+        void *buffer,
+        int32_t buffer_length) {
+    if (!object) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!position) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!buffer) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((buffer_length <= 0) || (buffer_length > object->capacity)) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
     }
 
-    object->count -= max_copy;
+    uint64_t read_count = __atomic_load_n(position, __ATOMIC_RELAXED);
+    const int32_t to_copy = pv_circular_buffer_copy_from(object, &read_count, buffer, buffer_length);
+    __atomic_store_n(position, read_count + (uint64_t) to_copy, __ATOMIC_RELEASE);
 
-    return max_copy;
+    return to_copy;
 }
 
 pv_circular_buffer_status_t pv_circular_buffer_write(
@@ -124,41 +324,164 @@ pv_circular_buffer_status_t pv_circular_buffer_write(
 
     pv_circular_buffer_status_t status = PV_CIRCULAR_BUFFER_STATUS_SUCCESS;
 
-    void *dst_ptr = (char *) object->buffer + (object->write_index * object->element_size);
-    const void *src_ptr = buffer;
+    const uint64_t capacity = (uint64_t) object->capacity;
+    const uint64_t write_count = object->write_end;
+    const uint64_t write_end = write_count + (uint64_t) buffer_length;
 
-    const int32_t available = object->capacity - object->write_index;
-    const int32_t to_copy = (buffer_length < available) ? buffer_length : available;
+    __atomic_store_n(&object->write_begin, write_end, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
 
-    memcpy(dst_ptr, src_ptr, to_copy * object->element_size);
+    pv_circular_buffer_copy_in(object, write_count, buffer, buffer_length);
 
-    object->write_index = (object->write_index + to_copy) % object->capacity;
-    object->count += to_copy;
+    __atomic_store_n(&object->write_end, write_end, __ATOMIC_RELEASE);
 
-    const int32_t remaining = buffer_length - to_copy;
-    if (remaining > 0) {
-        dst_ptr = object->buffer;
-        src_ptr = (char *) buffer + (to_copy * object->element_size);
+    // The consumer index is only reloaded when the cached value suggests an overflow.
+    if ((write_end - object->read_count_cache) > capacity) {
+        object->read_count_cache = __atomic_load_n(&object->read_count, __ATOMIC_ACQUIRE);
+        if ((write_end - object->read_count_cache) > capacity) {
+            status = PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW;
+        }
+    }
+
+    return status;
+}
+
+int32_t pv_circular_buffer_peek(
+        pv_circular_buffer_t *object,
+        const void **buffer,
+        int32_t buffer_length) {
+    if (!object) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!buffer) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((buffer_length <= 0) || (buffer_length > object->capacity)) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
 
-        memcpy(dst_ptr, src_ptr, remaining * object->element_size);
+    const uint64_t capacity = (uint64_t) object->capacity;
+    uint64_t read_count = object->read_count;
 
-        object->write_index = remaining;
-        object->count += remaining;
+    const uint64_t write_end = __atomic_load_n(&object->write_end, __ATOMIC_ACQUIRE);
+    if ((write_end - read_count) > capacity) {
+        read_count = write_end - capacity;
+        pv_circular_buffer_skip_to(object, read_count);
     }
 
-    if(object->count > object->capacity) {
-        status = PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW;
-        object->count = object->capacity;
-        object->read_index = (object->write_index + 1) % object->capacity;
+    const int32_t index = (int32_t) (read_count % (uint64_t) object->slot_count);
+    const uint64_t count = write_end - read_count;
+    int32_t length = (count < (uint64_t) buffer_length) ? (int32_t) count : buffer_length;
+    if (!object->is_mirrored && (length > (object->slot_count - index))) {
+        length = object->slot_count - index;
     }
 
-    return status;
+    *buffer = (const char *) object->buffer + (index * object->element_size);
+
+    return length;
+}
+
+pv_circular_buffer_status_t pv_circular_buffer_commit(pv_circular_buffer_t *object, int32_t length) {
+    if (!object) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((length < 0) || (length > object->capacity)) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+
+    const uint64_t capacity = (uint64_t) object->capacity;
+    const uint64_t read_count = object->read_count;
+
+    // The caller has finished reading the elements in place. Make sure the producer did not overwrite them meanwhile.
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    const uint64_t write_begin = __atomic_load_n(&object->write_begin, __ATOMIC_RELAXED);
+    if ((write_begin - read_count) > capacity) {
+        pv_circular_buffer_skip_to(object, write_begin - capacity);
+        return PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW;
+    }
+
+    __atomic_store_n(&object->read_count, read_count + (uint64_t) length, __ATOMIC_RELEASE);
+
+    return PV_CIRCULAR_BUFFER_STATUS_SUCCESS;
+}
+
+int32_t pv_circular_buffer_read_history(
+        pv_circular_buffer_t *object,
+        void *buffer,
+        int32_t buffer_length) {
+    if (!object) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!buffer) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((buffer_length <= 0) || (buffer_length > object->history_count)) {
+        return PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT;
+    }
+
+    const uint64_t slot_count = (uint64_t) object->slot_count;
+    const uint64_t read_count = object->read_count;
+    uint64_t begin = (read_count < (uint64_t) buffer_length) ? 0 : (read_count - (uint64_t) buffer_length);
+
+    while (begin < read_count) {
+        const int32_t to_copy = (int32_t) (read_count - begin);
+        char *destination = (char *) buffer + ((buffer_length - to_copy) * object->element_size);
+        pv_circular_buffer_copy_out(object, begin, destination, to_copy);
+
+        // Only a producer that lapped the consumer reaches the history. Drop whatever it overwrote and retry.
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        const uint64_t write_begin = __atomic_load_n(&object->write_begin, __ATOMIC_RELAXED);
+        if ((write_begin - begin) <= slot_count) {
+            return to_copy;
+        }
+
+        begin = write_begin - slot_count;
+    }
+
+    return 0;
+}
+
+int32_t pv_circular_buffer_get_count(pv_circular_buffer_t *object) {
+    const uint64_t read_count = __atomic_load_n(&object->read_count, __ATOMIC_ACQUIRE);
+    const uint64_t write_end = __atomic_load_n(&object->write_end, __ATOMIC_ACQUIRE);
+    const uint64_t count = write_end - read_count;
+    return (count < (uint64_t) object->capacity) ? (int32_t) count : object->capacity;
+}
+
+int32_t pv_circular_buffer_get_count_at(pv_circular_buffer_t *object, const uint64_t *position) {
+    const uint64_t read_count = __atomic_load_n(position, __ATOMIC_ACQUIRE);
+    const uint64_t write_end = __atomic_load_n(&object->write_end, __ATOMIC_ACQUIRE);
+    const uint64_t count = write_end - read_count;
+    return (count < (uint64_t) object->capacity) ? (int32_t) count : object->capacity;
+}
+
+uint64_t pv_circular_buffer_get_write_position(pv_circular_buffer_t *object) {
+    return __atomic_load_n(&object->write_end, __ATOMIC_ACQUIRE);
+}
+
+uint64_t pv_circular_buffer_get_read_position(pv_circular_buffer_t *object) {
+    return __atomic_load_n(&object->read_count, __ATOMIC_ACQUIRE);
+}
+
+uint64_t pv_circular_buffer_get_dropped_count(pv_circular_buffer_t *object) {
+    return __atomic_load_n(&object->dropped_count, __ATOMIC_RELAXED);
+}
+
+bool pv_circular_buffer_discard_until(pv_circular_buffer_t *object, uint64_t position) {
+    if (object->read_count >= position) {
+        return false;
+    }
+    __atomic_store_n(&object->read_count, position, __ATOMIC_RELEASE);
+    return true;
+}
+
+void pv_circular_buffer_drop(pv_circular_buffer_t *object, int32_t length) {
+    pv_circular_buffer_skip_to(object, object->read_count + (uint64_t) length);
 }
 
 void pv_circular_buffer_reset(pv_circular_buffer_t *object) {
-    object->count = 0;
-    object->read_index = 0;
-    object->write_index = 0;
+    const uint64_t write_end = __atomic_load_n(&object->write_end, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&object->read_count, write_end, __ATOMIC_RELEASE);
 }
 
 const char *pv_circular_buffer_status_to_string(pv_circular_buffer_status_t status) {
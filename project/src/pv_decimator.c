@@ -0,0 +1,255 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pv_decimator.h"
+
+/**
+ * A halfband filter has `4 * NUM_PAIRS - 1` taps. All taps at an even distance from the center are 0, except the
+ * center itself, which is 1/2, so only `NUM_PAIRS` distinct coefficients remain, each shared by the two taps at the
+ * same odd distance from the center.
+ */
+#define PV_DECIMATOR_NUM_PAIRS (24)
+#define PV_DECIMATOR_NUM_TAPS ((4 * PV_DECIMATOR_NUM_PAIRS) - 1)
+#define PV_DECIMATOR_CENTER ((PV_DECIMATOR_NUM_TAPS - 1) / 2)
+
+static const double PI = 3.14159265358979323846;
+static const double KAISER_BETA = 9.;
+
+/**
+ * `buffers` holds the input of each channel contiguously, starting with the last samples that are still needed. The
+ * next output is centered on sample `PV_DECIMATOR_CENTER` of the buffer, and later ones every 2 samples after it.
+ * `output` holds the interleaved output of the last call, which is the input of the next stage.
+ */
+typedef struct {
+    int32_t max_input_frames;
+    int32_t capacity;
+    float *buffers;
+    int32_t fill;
+    float *output;
+    int32_t num_output_frames;
+} pv_decimator_stage_t;
+
+struct pv_decimator {
+    int32_t num_channels;
+    int32_t num_stages;
+    int32_t max_input_frames;
+    float coefficients[PV_DECIMATOR_NUM_PAIRS];
+    const float *input;
+    int32_t num_input_frames;
+    pv_decimator_stage_t *stages;
+};
+
+static double pv_decimator_bessel_i0(double x) {
+    double sum = 1.;
+    double term = 1.;
+    for (int32_t k = 1; k < 64; k++) {
+        const double y = x / (2. * (double) k);
+        term *= y * y;
+        sum += term;
+        if (term < (1e-12 * sum)) {
+            break;
+        }
+    }
+    return sum;
+}
+
+/**
+ * Kaiser-windowed sinc with its cutoff at half the Nyquist frequency. The coefficients are scaled so that, with the
+ * center tap of 1/2, the gain at DC is exactly 1.
+ */
+static void pv_decimator_design_filter(float *coefficients) {
+    const double half_length = (double) (PV_DECIMATOR_CENTER + 1);
+    const double window_scale = 1. / pv_decimator_bessel_i0(KAISER_BETA);
+
+    double h[PV_DECIMATOR_NUM_PAIRS];
+    double sum = 0.;
+    for (int32_t i = 0; i < PV_DECIMATOR_NUM_PAIRS; i++) {
+        const double x = (double) ((2 * i) + 1);
+        const double w = x / half_length;
+        const double window = pv_decimator_bessel_i0(KAISER_BETA * sqrt(1. - (w * w))) * window_scale;
+        h[i] = 0.5 * (sin(0.5 * PI * x) / (0.5 * PI * x)) * window;
+        sum += 2. * h[i];
+    }
+    for (int32_t i = 0; i < PV_DECIMATOR_NUM_PAIRS; i++) {
+        coefficients[i] = (float) (h[i] * 0.5 / sum);
+    }
+}
+
+pv_decimator_status_t pv_decimator_init(
+        int32_t num_channels,
+        int32_t num_stages,
+        int32_t max_input_frames,
+        pv_decimator_t **object) {
+    if (num_channels <= 0) {
+        return PV_DECIMATOR_STATUS_INVALID_ARGUMENT;
+    }
+    if ((num_stages <= 0) || (num_stages > 30)) {
+        return PV_DECIMATOR_STATUS_INVALID_ARGUMENT;
+    }
+    if ((max_input_frames <= 0) || (max_input_frames > (INT32_MAX / 2))) {
+        return PV_DECIMATOR_STATUS_INVALID_ARGUMENT;
+    }
+    if (!object) {
+        return PV_DECIMATOR_STATUS_INVALID_ARGUMENT;
+    }
+
+    *object = NULL;
+
+    pv_decimator_t *o = calloc(1, sizeof(pv_decimator_t));
+    if (!o) {
+        return PV_DECIMATOR_STATUS_OUT_OF_MEMORY;
+    }
+
+    o->num_channels = num_channels;
+    o->num_stages = num_stages;
+    o->max_input_frames = max_input_frames;
+    pv_decimator_design_filter(o->coefficients);
+
+    o->stages = calloc((size_t) num_stages, sizeof(pv_decimator_stage_t));
+    if (!(o->stages)) {
+        pv_decimator_delete(o);
+        return PV_DECIMATOR_STATUS_OUT_OF_MEMORY;
+    }
+
+    int32_t max_stage_input_frames = max_input_frames;
+    for (int32_t s = 0; s < num_stages; s++) {
+        pv_decimator_stage_t *stage = &o->stages[s];
+        stage->max_input_frames = max_stage_input_frames;
+        stage->capacity = PV_DECIMATOR_NUM_TAPS - 1 + max_stage_input_frames;
+
+        stage->buffers = malloc((size_t) num_channels * (size_t) stage->capacity * sizeof(float));
+        if (!(stage->buffers)) {
+            pv_decimator_delete(o);
+            return PV_DECIMATOR_STATUS_OUT_OF_MEMORY;
+        }
+
+        max_stage_input_frames = (max_stage_input_frames + 1) / 2;
+        stage->output = malloc((size_t) num_channels * (size_t) max_stage_input_frames * sizeof(float));
+        if (!(stage->output)) {
+            pv_decimator_delete(o);
+            return PV_DECIMATOR_STATUS_OUT_OF_MEMORY;
+        }
+    }
+    pv_decimator_reset(o);
+
+    *object = o;
+
+    return PV_DECIMATOR_STATUS_SUCCESS;
+}
+
+void pv_decimator_delete(pv_decimator_t *object) {
+    if (object) {
+        if (object->stages) {
+            for (int32_t s = 0; s < object->num_stages; s++) {
+                free(object->stages[s].buffers);
+                free(object->stages[s].output);
+            }
+        }
+        free(object->stages);
+        free(object);
+    }
+}
+
+void pv_decimator_reset(pv_decimator_t *object) {
+    for (int32_t s = 0; s < object->num_stages; s++) {
+        pv_decimator_stage_t *stage = &object->stages[s];
+        // Silence before the first sample, so that the first output is centered on it.
+        stage->fill = PV_DECIMATOR_CENTER;
+        for (int32_t c = 0; c < object->num_channels; c++) {
+            memset(stage->buffers + ((size_t) c * (size_t) stage->capacity), 0, (size_t) stage->fill * sizeof(float));
+        }
+        stage->num_output_frames = 0;
+    }
+    object->input = NULL;
+    object->num_input_frames = 0;
+}
+
+int32_t pv_decimator_get_max_output_frames(pv_decimator_t *object, int32_t stage) {
+    int32_t max_frames = object->max_input_frames;
+    for (int32_t s = 0; s < stage; s++) {
+        max_frames = (max_frames + 1) / 2;
+    }
+    return max_frames;
+}
+
+/**
+ * Filters and halves the input of one stage. After the loop fewer than `PV_DECIMATOR_NUM_TAPS` samples are left, so
+ * a stage given `n` frames produces at most `(n + 1) / 2`.
+ */
+static void pv_decimator_process_stage(
+        const pv_decimator_t *object,
+        pv_decimator_stage_t *stage,
+        const float *input,
+        int32_t num_input_frames) {
+    const int32_t num_channels = object->num_channels;
+    const float *coefficients = object->coefficients;
+
+    for (int32_t c = 0; c < num_channels; c++) {
+        float *buffer = stage->buffers + ((size_t) c * (size_t) stage->capacity) + stage->fill;
+        for (int32_t i = 0; i < num_input_frames; i++) {
+            buffer[i] = input[(i * num_channels) + c];
+        }
+    }
+    stage->fill += num_input_frames;
+
+    const int32_t num_output_frames = (stage->fill >= PV_DECIMATOR_NUM_TAPS) ?
+            (((stage->fill - PV_DECIMATOR_NUM_TAPS) / 2) + 1) :
+            0;
+    for (int32_t c = 0; c < num_channels; c++) {
+        const float *buffer = stage->buffers + ((size_t) c * (size_t) stage->capacity);
+        for (int32_t n = 0; n < num_output_frames; n++) {
+            const float *center = buffer + (2 * n) + PV_DECIMATOR_CENTER;
+            float sum = 0.f;
+            for (int32_t i = 0; i < PV_DECIMATOR_NUM_PAIRS; i++) {
+                const int32_t offset = (2 * i) + 1;
+                sum += coefficients[i] * (center[-offset] + center[offset]);
+            }
+            stage->output[(n * num_channels) + c] = (0.5f * center[0]) + sum;
+        }
+    }
+    stage->num_output_frames = num_output_frames;
+
+    // Drops the input that no later output needs.
+    const int32_t num_consumed = 2 * num_output_frames;
+    if (num_consumed > 0) {
+        for (int32_t c = 0; c < num_channels; c++) {
+            float *buffer = stage->buffers + ((size_t) c * (size_t) stage->capacity);
+            memmove(buffer, buffer + num_consumed, (size_t) (stage->fill - num_consumed) * sizeof(float));
+        }
+        stage->fill -= num_consumed;
+    }
+}
+
+void pv_decimator_process(pv_decimator_t *object, const float *input, int32_t num_input_frames) {
+    object->input = input;
+    object->num_input_frames = num_input_frames;
+
+    for (int32_t s = 0; s < object->num_stages; s++) {
+        pv_decimator_stage_t *stage = &object->stages[s];
+        pv_decimator_process_stage(object, stage, input, num_input_frames);
+        input = stage->output;
+        num_input_frames = stage->num_output_frames;
+    }
+}
+
+const float *pv_decimator_get_output(pv_decimator_t *object, int32_t stage, int32_t *num_frames) {
+    if (stage == 0) {
+        *num_frames = object->num_input_frames;
+        return object->input;
+    }
+
+    *num_frames = object->stages[stage - 1].num_output_frames;
+    return object->stages[stage - 1].output;
+}
@@ -0,0 +1,407 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(__SSE2__)
+
+#include <emmintrin.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+#define PV_LEVEL_METER_AVX2
+
+#include <immintrin.h>
+
+#endif
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#define PV_LEVEL_METER_NEON
+
+#include <arm_neon.h>
+
+#endif
+
+#include "pv_level_meter.h"
+
+/**
+ * Raw 16-bit statistics. Kept as integers until the end so that the result does not depend on the kernel used.
+ */
+typedef struct {
+    int32_t max;
+    int32_t min;
+    uint64_t sum_squares;
+    int32_t num_clipped;
+} pv_level_meter_s16_state_t;
+
+typedef int32_t (*pv_level_meter_s16_kernel_t)(const int16_t *, int32_t, pv_level_meter_s16_state_t *);
+
+static void pv_level_meter_s16_scalar(const int16_t *pcm, int32_t num_samples, pv_level_meter_s16_state_t *state) {
+    for (int32_t i = 0; i < num_samples; i++) {
+        const int32_t x = pcm[i];
+        if (x > state->max) {
+            state->max = x;
+        }
+        if (x < state->min) {
+            state->min = x;
+        }
+        state->sum_squares += (uint64_t) (x * x);
+        if ((x == INT16_MAX) || (x == INT16_MIN)) {
+            state->num_clipped++;
+        }
+    }
+}
+
+/**
+ * Each kernel processes as many whole vectors as it can and returns the number of samples it consumed. The remainder
+ * is handled by the scalar loop.
+ */
+#if !defined(__SSE2__) && !defined(PV_LEVEL_METER_NEON)
+
+static int32_t pv_level_meter_s16_none(const int16_t *pcm, int32_t num_samples, pv_level_meter_s16_state_t *state) {
+    (void) pcm;
+    (void) num_samples;
+    (void) state;
+    return 0;
+}
+
+#endif
+
+#if defined(__SSE2__)
+
+static int32_t pv_level_meter_s16_sse2(const int16_t *pcm, int32_t num_samples, pv_level_meter_s16_state_t *state) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i clip_high = _mm_set1_epi16(INT16_MAX);
+    const __m128i clip_low = _mm_set1_epi16(INT16_MIN);
+
+    __m128i max = _mm_set1_epi16(INT16_MIN);
+    __m128i min = _mm_set1_epi16(INT16_MAX);
+    __m128i sum_low = zero;
+    __m128i sum_high = zero;
+    int32_t num_clipped = 0;
+
+    int32_t i = 0;
+    for (; (i + 8) <= num_samples; i += 8) {
+        const __m128i x = _mm_loadu_si128((const __m128i *) (pcm + i));
+        max = _mm_max_epi16(max, x);
+        min = _mm_min_epi16(min, x);
+
+        // Each pair sum is at most 2^31, which only fits when read as unsigned, so widen with zeros.
+        const __m128i squares = _mm_madd_epi16(x, x);
+        sum_low = _mm_add_epi64(sum_low, _mm_unpacklo_epi32(squares, zero));
+        sum_high = _mm_add_epi64(sum_high, _mm_unpackhi_epi32(squares, zero));
+
+        const __m128i is_clipped = _mm_or_si128(_mm_cmpeq_epi16(x, clip_high), _mm_cmpeq_epi16(x, clip_low));
+        num_clipped += __builtin_popcount((uint32_t) _mm_movemask_epi8(is_clipped)) / 2;
+    }
+
+    int16_t max_lanes[8];
+    int16_t min_lanes[8];
+    uint64_t sum_lanes[4];
+    _mm_storeu_si128((__m128i *) max_lanes, max);
+    _mm_storeu_si128((__m128i *) min_lanes, min);
+    _mm_storeu_si128((__m128i *) sum_lanes, sum_low);
+    _mm_storeu_si128((__m128i *) (sum_lanes + 2), sum_high);
+
+    for (int32_t j = 0; j < 8; j++) {
+        if (max_lanes[j] > state->max) {
+            state->max = max_lanes[j];
+        }
+        if (min_lanes[j] < state->min) {
+            state->min = min_lanes[j];
+        }
+    }
+    state->sum_squares += sum_lanes[0] + sum_lanes[1] + sum_lanes[2] + sum_lanes[3];
+    state->num_clipped += num_clipped;
+
+    return i;
+}
+
+#endif
+
+#if defined(PV_LEVEL_METER_AVX2)
+
+__attribute__((target("avx2")))
+static int32_t pv_level_meter_s16_avx2(const int16_t *pcm, int32_t num_samples, pv_level_meter_s16_state_t *state) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i clip_high = _mm256_set1_epi16(INT16_MAX);
+    const __m256i clip_low = _mm256_set1_epi16(INT16_MIN);
+
+    __m256i max = _mm256_set1_epi16(INT16_MIN);
+    __m256i min = _mm256_set1_epi16(INT16_MAX);
+    __m256i sum_low = zero;
+    __m256i sum_high = zero;
+    int32_t num_clipped = 0;
+
+    int32_t i = 0;
+    for (; (i + 16) <= num_samples; i += 16) {
+        const __m256i x = _mm256_loadu_si256((const __m256i *) (pcm + i));
+        max = _mm256_max_epi16(max, x);
+        min = _mm256_min_epi16(min, x);
+
+        const __m256i squares = _mm256_madd_epi16(x, x);
+        sum_low = _mm256_add_epi64(sum_low, _mm256_unpacklo_epi32(squares, zero));
+        sum_high = _mm256_add_epi64(sum_high, _mm256_unpackhi_epi32(squares, zero));
+
+        const __m256i is_clipped = _mm256_or_si256(
+                _mm256_cmpeq_epi16(x, clip_high),
+                _mm256_cmpeq_epi16(x, clip_low));
+        num_clipped += __builtin_popcount((uint32_t) _mm256_movemask_epi8(is_clipped)) / 2;
+    }
+
+    int16_t max_lanes[16];
+    int16_t min_lanes[16];
+    uint64_t sum_lanes[8];
+    _mm256_storeu_si256((__m256i *) max_lanes, max);
+    _mm256_storeu_si256((__m256i *) min_lanes, min);
+    _mm256_storeu_si256((__m256i *) sum_lanes, sum_low);
+    _mm256_storeu_si256((__m256i *) (sum_lanes + 4), sum_high);
+
+    for (int32_t j = 0; j < 16; j++) {
+        if (max_lanes[j] > state->max) {
+            state->max = max_lanes[j];
+        }
+        if (min_lanes[j] < state->min) {
+            state->min = min_lanes[j];
+        }
+    }
+    for (int32_t j = 0; j < 8; j++) {
+        state->sum_squares += sum_lanes[j];
+    }
+    state->num_clipped += num_clipped;
+
+    return i;
+}
+
+#endif
+
+#if defined(PV_LEVEL_METER_NEON)
+
+static int32_t pv_level_meter_s16_neon(const int16_t *pcm, int32_t num_samples, pv_level_meter_s16_state_t *state) {
+    const int16x8_t clip_high = vdupq_n_s16(INT16_MAX);
+    const int16x8_t clip_low = vdupq_n_s16(INT16_MIN);
+
+    int16x8_t max = vdupq_n_s16(INT16_MIN);
+    int16x8_t min = vdupq_n_s16(INT16_MAX);
+    uint64x2_t sum = vdupq_n_u64(0);
+    uint32x4_t num_clipped = vdupq_n_u32(0);
+
+    int32_t i = 0;
+    for (; (i + 8) <= num_samples; i += 8) {
+        const int16x8_t x = vld1q_s16(pcm + i);
+        max = vmaxq_s16(max, x);
+        min = vminq_s16(min, x);
+
+        const int32x4_t squares_low = vmull_s16(vget_low_s16(x), vget_low_s16(x));
+        const int32x4_t squares_high = vmull_s16(vget_high_s16(x), vget_high_s16(x));
+        sum = vpadalq_u32(sum, vreinterpretq_u32_s32(squares_low));
+        sum = vpadalq_u32(sum, vreinterpretq_u32_s32(squares_high));
+
+        const uint16x8_t is_clipped = vorrq_u16(vceqq_s16(x, clip_high), vceqq_s16(x, clip_low));
+        num_clipped = vpadalq_u16(num_clipped, vshrq_n_u16(is_clipped, 15));
+    }
+
+    int16_t max_lanes[8];
+    int16_t min_lanes[8];
+    uint64_t sum_lanes[2];
+    uint32_t num_clipped_lanes[4];
+    vst1q_s16(max_lanes, max);
+    vst1q_s16(min_lanes, min);
+    vst1q_u64(sum_lanes, sum);
+    vst1q_u32(num_clipped_lanes, num_clipped);
+
+    for (int32_t j = 0; j < 8; j++) {
+        if (max_lanes[j] > state->max) {
+            state->max = max_lanes[j];
+        }
+        if (min_lanes[j] < state->min) {
+            state->min = min_lanes[j];
+        }
+    }
+    state->sum_squares += sum_lanes[0] + sum_lanes[1];
+    for (int32_t j = 0; j < 4; j++) {
+        state->num_clipped += (int32_t) num_clipped_lanes[j];
+    }
+
+    return i;
+}
+
+#endif
+
+static pv_level_meter_s16_kernel_t pv_level_meter_select_s16_kernel(void) {
+
+#if defined(PV_LEVEL_METER_AVX2)
+
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return pv_level_meter_s16_avx2;
+    }
+
+#endif
+
+#if defined(__SSE2__)
+
+    return pv_level_meter_s16_sse2;
+
+#elif defined(PV_LEVEL_METER_NEON)
+
+    return pv_level_meter_s16_neon;
+
+#else
+
+    return pv_level_meter_s16_none;
+
+#endif
+
+}
+
+static pv_level_meter_s16_kernel_t s16_kernel = NULL;
+
+void pv_level_meter_measure_s16(const int16_t *pcm, int32_t num_samples, pv_level_meter_result_t *result) {
+    // Every thread selects the same kernel, so a race on the first call is harmless.
+    pv_level_meter_s16_kernel_t kernel = __atomic_load_n(&s16_kernel, __ATOMIC_RELAXED);
+    if (!kernel) {
+        kernel = pv_level_meter_select_s16_kernel();
+        __atomic_store_n(&s16_kernel, kernel, __ATOMIC_RELAXED);
+    }
+
+    pv_level_meter_s16_state_t state = {0, 0, 0, 0};
+    const int32_t num_processed = kernel(pcm, num_samples, &state);
+    pv_level_meter_s16_scalar(pcm + num_processed, num_samples - num_processed, &state);
+
+    const int32_t peak = (state.max > -state.min) ? state.max : -state.min;
+    const float scale = 1.f / 32768.f;
+    if (((float) peak * scale) > result->peak) {
+        result->peak = (float) peak * scale;
+    }
+    result->sum_squares += (double) state.sum_squares * (double) scale * (double) scale;
+    result->num_samples += num_samples;
+    result->num_clipped += state.num_clipped;
+}
+
+void pv_level_meter_measure_s32(
+        const int32_t *pcm,
+        int32_t num_samples,
+        int32_t num_bits,
+        pv_level_meter_result_t *result) {
+    const int64_t max_value = (((int64_t) 1) << (num_bits - 1)) - 1;
+    const int64_t min_value = -max_value - 1;
+    const double scale = 1. / (double) (max_value + 1);
+
+    int64_t peak = 0;
+    double sum_squares = 0.;
+    int32_t num_clipped = 0;
+    for (int32_t i = 0; i < num_samples; i++) {
+        const int64_t x = pcm[i];
+        const int64_t magnitude = (x < 0) ? -x : x;
+        if (magnitude > peak) {
+            peak = magnitude;
+        }
+        sum_squares += (double) x * (double) x;
+        if ((x >= max_value) || (x <= min_value)) {
+            num_clipped++;
+        }
+    }
+
+    if ((float) ((double) peak * scale) > result->peak) {
+        result->peak = (float) ((double) peak * scale);
+    }
+    result->sum_squares += sum_squares * scale * scale;
+    result->num_samples += num_samples;
+    result->num_clipped += num_clipped;
+}
+
+void pv_level_meter_measure_f32(const float *pcm, int32_t num_samples, pv_level_meter_result_t *result) {
+    float peak = 0.f;
+    double sum_squares = 0.;
+    int32_t num_clipped = 0;
+
+    int32_t i = 0;
+
+#if defined(__SSE2__)
+
+    const __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 one = _mm_set1_ps(1.f);
+    __m128 max = _mm_setzero_ps();
+    __m128d sum = _mm_setzero_pd();
+    for (; (i + 4) <= num_samples; i += 4) {
+        const __m128 x = _mm_loadu_ps(pcm + i);
+        const __m128 magnitude = _mm_and_ps(x, sign_mask);
+        max = _mm_max_ps(max, magnitude);
+
+        const __m128 squares = _mm_mul_ps(x, x);
+        sum = _mm_add_pd(sum, _mm_cvtps_pd(squares));
+        sum = _mm_add_pd(sum, _mm_cvtps_pd(_mm_movehl_ps(squares, squares)));
+
+        num_clipped += __builtin_popcount((uint32_t) _mm_movemask_ps(_mm_cmpge_ps(magnitude, one)));
+    }
+
+    float max_lanes[4];
+    double sum_lanes[2];
+    _mm_storeu_ps(max_lanes, max);
+    _mm_storeu_pd(sum_lanes, sum);
+    for (int32_t j = 0; j < 4; j++) {
+        if (max_lanes[j] > peak) {
+            peak = max_lanes[j];
+        }
+    }
+    sum_squares += sum_lanes[0] + sum_lanes[1];
+
+#elif defined(PV_LEVEL_METER_NEON)
+
+    const float32x4_t one = vdupq_n_f32(1.f);
+    float32x4_t max = vdupq_n_f32(0.f);
+    float32x4_t sum = vdupq_n_f32(0.f);
+    uint32x4_t clipped = vdupq_n_u32(0);
+    for (; (i + 4) <= num_samples; i += 4) {
+        const float32x4_t x = vld1q_f32(pcm + i);
+        const float32x4_t magnitude = vabsq_f32(x);
+        max = vmaxq_f32(max, magnitude);
+        sum = vmlaq_f32(sum, x, x);
+        clipped = vsubq_u32(clipped, vcgeq_f32(magnitude, one));
+    }
+
+    float max_lanes[4];
+    float sum_lanes[4];
+    uint32_t clipped_lanes[4];
+    vst1q_f32(max_lanes, max);
+    vst1q_f32(sum_lanes, sum);
+    vst1q_u32(clipped_lanes, clipped);
+    for (int32_t j = 0; j < 4; j++) {
+        if (max_lanes[j] > peak) {
+            peak = max_lanes[j];
+        }
+        sum_squares += sum_lanes[j];
+        num_clipped += (int32_t) clipped_lanes[j];
+    }
+
+#endif
+
+    for (; i < num_samples; i++) {
+        const float magnitude = (pcm[i] < 0.f) ? -pcm[i] : pcm[i];
+        if (magnitude > peak) {
+            peak = magnitude;
+        }
+        sum_squares += (double) pcm[i] * (double) pcm[i];
+        if (magnitude >= 1.f) {
+            num_clipped++;
+        }
+    }
+
+    if (peak > result->peak) {
+        result->peak = peak;
+    }
+    result->sum_squares += sum_squares;
+    result->num_samples += num_samples;
+    result->num_clipped += num_clipped;
+}
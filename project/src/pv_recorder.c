@@ -9,6 +9,12 @@
     specific language governing permissions and limitations under the License.
 */
 
+#if defined(__PV_RECORDER_PLATFORM_LINUX__) || defined(__PV_RECORDER_PLATFORM_RASPBERRYPI__)
+
+#define _GNU_SOURCE
+
+#endif
+
 #pragma GCC diagnostic push
 
 #pragma GCC diagnostic ignored "-Wunused-result"
@@ -19,343 +25,4048 @@
 
 #pragma GCC diagnostic pop
 
+#if defined(__PV_RECORDER_PLATFORM_LINUX__) || defined(__PV_RECORDER_PLATFORM_RASPBERRYPI__)
+
+#define PV_RECORDER_EVENT_FD
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#endif
+
+#if !defined(__PV_RECORDER_PLATFORM_WINDOWS__)
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#endif
+
+#include <math.h>
+#include <string.h>
+
 #include "pv_circular_buffer.h"
+#include "pv_decimator.h"
+#include "pv_level_meter.h"
 #include "pv_recorder.h"
+#include "pv_resampler.h"
+#include "pv_sample_converter.h"
+#include "pv_trace_log.h"
 
 #define PV_RECORDER_DEFAULT_DEVICE_INDEX (-1)
 #define PV_RECORDER_SAMPLE_RATE (16000)
 #define PV_RECORDER_VERSION "1.2.0"
 
-static const int32_t READ_RETRY_COUNT = 500;
-static const int32_t READ_SLEEP_MILLI_SECONDS = 2;
-static const int32_t MAX_SILENCE_BUFFER_SIZE = 2 * PV_RECORDER_SAMPLE_RATE;
+static const int32_t MAX_SILENCE_SECONDS = 2;
 static const int32_t ABSOLUTE_SILENCE_THRESHOLD = 1;
+static const float SILENCE_PEAK_THRESHOLD = (float) ABSOLUTE_SILENCE_THRESHOLD / 32768.f;
+static const int32_t CONVERSION_BUFFER_SIZE = 1024;
+static const int32_t RESAMPLER_CHUNK_FRAMES = 256;
+static const int32_t OUTPUT_CHUNK_FRAMES = 256;
+static const pv_resampler_quality_t OUTPUT_RESAMPLER_QUALITY = PV_RESAMPLER_QUALITY_MEDIUM;
+static const double VAD_GATE_MIN_ENERGY_DB = -70.;
+static const double VAD_GATE_FLOOR_RISE_SECONDS = 2.;
+static const double VAD_GATE_FLOOR_FALL_SECONDS = 0.1;
 
-struct pv_recorder {
+#define PV_RECORDER_DEVICE_ID_SIZE (320)
+#define PV_RECORDER_TRACE_LOG_CHUNK_SIZE (256)
+#define PV_RECORDER_NUM_BACKENDS (PV_RECORDER_BACKEND_JACK + 1)
+
+static const ma_backend PV_RECORDER_MA_BACKENDS[PV_RECORDER_NUM_BACKENDS] = {
+        ma_backend_wasapi,
+        ma_backend_dsound,
+        ma_backend_winmm,
+        ma_backend_coreaudio,
+        ma_backend_pulseaudio,
+        ma_backend_alsa,
+        ma_backend_jack};
+
+/**
+ * Audio context shared by all recorders and device enumeration in the process. Initializing a context probes every
+ * backend, which can take hundreds of milliseconds, so it is created for the first recorder and kept until the last
+ * one is deleted. The capture device list is cached and only enumerated again by
+ * `pv_recorder_refresh_available_devices()`, by the rescan thread, or when it is needed and no cache exists.
+ * `device_list_version` changes whenever an enumeration finds a different list. `backends` is the list passed to
+ * `ma_context_init()`; empty means miniaudio's default order. Everything here is guarded by
+ * `shared_context_lock`, which is never taken by the audio callback, except for `is_rescan_requested`, which is set
+ * from device notifications and is atomic, and the rescan threads and `rescan_event`, which are guarded by
+ * `device_change_callback_lock`. `rescan_event` wakes the rescan thread. It is initialized with the first callback and
+ * never uninitialized, so that device notifications can signal it at any time. Enumeration runs without the lock, on
+ * a reference to the context, and only takes it to publish the new list.
+ */
+typedef struct {
     ma_context context;
+    int32_t ref_count;
+    ma_backend backends[PV_RECORDER_NUM_BACKENDS];
+    int32_t num_backends;
+    ma_device_info *devices;
+    char (*device_ids)[PV_RECORDER_DEVICE_ID_SIZE];
+    int32_t num_devices;
+    bool is_device_cache_valid;
+    ma_backend device_cache_backend;
+    uint64_t device_list_version;
+    pv_recorder_device_change_callback_t device_change_callback;
+    void *device_change_user_data;
+    int32_t rescan_interval_ms;
+    ma_thread rescan_thread;
+    bool has_rescan_thread;
+    ma_thread rescan_timer_thread;
+    bool has_rescan_timer_thread;
+    ma_event rescan_event;
+    bool is_rescan_event_initialized;
+    bool is_rescan_stopping;
+    bool is_rescan_requested;
+    bool is_rescan_timer_expired;
+} pv_recorder_shared_context_t;
+
+/**
+ * Mutex with static storage, so that it needs no initialization call. Threads waiting for it sleep, since it is held
+ * while a context is created, which can take hundreds of milliseconds.
+ */
+#if defined(__PV_RECORDER_PLATFORM_WINDOWS__)
+
+typedef SRWLOCK pv_recorder_static_mutex_t;
+#define PV_RECORDER_STATIC_MUTEX_INITIALIZER SRWLOCK_INIT
+
+#else
+
+typedef pthread_mutex_t pv_recorder_static_mutex_t;
+#define PV_RECORDER_STATIC_MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+
+#endif
+
+static pv_recorder_static_mutex_t shared_context_lock = PV_RECORDER_STATIC_MUTEX_INITIALIZER;
+
+/**
+ * Serializes `pv_recorder_set_device_change_callback()`. It is separate from `shared_context_lock` because stopping
+ * the rescan thread waits for it, and the thread takes `shared_context_lock`.
+ */
+static pv_recorder_static_mutex_t device_change_callback_lock = PV_RECORDER_STATIC_MUTEX_INITIALIZER;
+static pv_recorder_shared_context_t shared_context;
+
+static void pv_recorder_static_mutex_lock(pv_recorder_static_mutex_t *mutex) {
+
+#if defined(__PV_RECORDER_PLATFORM_WINDOWS__)
+
+    AcquireSRWLockExclusive(mutex);
+
+#else
+
+    pthread_mutex_lock(mutex);
+
+#endif
+
+}
+
+static void pv_recorder_static_mutex_unlock(pv_recorder_static_mutex_t *mutex) {
+
+#if defined(__PV_RECORDER_PLATFORM_WINDOWS__)
+
+    ReleaseSRWLockExclusive(mutex);
+
+#else
+
+    pthread_mutex_unlock(mutex);
+
+#endif
+
+}
+
+/**
+ * State of the VAD gate. Frames are counted from `origin`, the buffer position at which recording started. The audio
+ * callback decides on each frame as soon as it is complete and records the decision in `decisions`, indexed by frame
+ * number modulo `buffered_frames_count`. `release_end` and `decided_end` are published after the decisions. A rejected
+ * frame is final once it is before `release_end` or more than `pre_roll_frames` before `decided_end`. The reader is
+ * woken when a frame is released, or when `drain_samples` of decided audio have accumulated so that it can discard
+ * rejected frames before they overflow the buffer.
+ *
+ * Only the audio callback uses `origin` and the fields after `decided_end`, and `pv_recorder_start()` resets them
+ * while it is not running. The reader counts frames from its own discard position, which is the same. `release_end`
+ * and `decided_end` are never reset: those of an earlier recording are at or before the new origin, so to the reader
+ * they mean that nothing was released or decided yet.
+ */
+typedef struct {
+    pv_recorder_vad_gate_options_t options;
+    uint8_t *decisions;
+    double floor_rise;
+    double floor_fall;
+    uint64_t origin;
+    uint64_t release_end;
+    uint64_t decided_end;
+    int32_t drain_samples;
+    uint64_t num_frames;
+    double frame_sum_squares;
+    int32_t frame_fill;
+    double noise_floor_db;
+    bool is_open;
+    int32_t hangover_remaining;
+    uint64_t num_gated_frames;
+} pv_recorder_vad_gate_t;
+
+/**
+ * A reader with its own cursor into the recorder's buffer. `position` is written by the subscriber's thread and read
+ * by the audio callback to decide whether to wake it. `stop` and `start` publish the write position in
+ * `discard_position`, and the subscriber moves its cursor there itself, as the main reader does.
+ */
+struct pv_recorder_subscriber {
+    pv_recorder_t *recorder;
+    int32_t frame_length;
+    uint64_t position;
+    uint64_t discard_position;
+    uint64_t applied_discard_position;
+    uint64_t dropped_samples;
+    ma_event event;
+    bool is_waiting;
+};
+
+/**
+ * An output stream. It takes the audio of stage `stage` of the output chain, resamples it if that stage does not run
+ * at `sample_rate`, and buffers it in its own `buffer`, which the output's reader consumes. `stop` publishes the write
+ * position in `discard_position`, and the reader discards up to it, as with the recorder's buffer.
+ */
+struct pv_recorder_output {
+    pv_recorder_t *recorder;
+    int32_t sample_rate;
+    int32_t frame_length;
+    int32_t stage;
+    pv_resampler_t *resampler;
+    float *resampled;
+    int16_t *pcm;
+    pv_circular_buffer_t *buffer;
+    uint64_t discard_position;
+    uint64_t applied_discard_position;
+    ma_event event;
+    bool is_waiting;
+};
+
+/**
+ * Conversion shared by the output streams. The audio callback reads what it just wrote to the recorder's buffer from
+ * its own cursor at `position`, resamples it to `base_rate`, the highest output rate, and halves it through the stages
+ * of `decimator`, `chunk_frames` at a time. `resampler` and `decimator` are NULL when not needed. Only rebuilt while
+ * the device is stopped.
+ */
+typedef struct {
+    uint64_t position;
+    int32_t chunk_frames;
+    int32_t base_rate;
+    int16_t *pcm;
+    float *input;
+    pv_resampler_t *resampler;
+    float *resampled;
+    pv_decimator_t *decimator;
+} pv_recorder_output_chain_t;
+
+/**
+ * Wait state of a worker of the work queue, on its own cache line so that workers do not false-share.
+ */
+typedef struct {
+    __attribute__((aligned(64))) ma_event event;
+    bool is_waiting;
+} pv_recorder_worker_t;
+
+#define PV_RECORDER_WORK_QUEUE_SEQUENCE_BITS (48)
+#define PV_RECORDER_WORK_QUEUE_SEQUENCE_MASK ((1ULL << PV_RECORDER_WORK_QUEUE_SEQUENCE_BITS) - 1)
+
+/**
+ * Work queue over the frames of the buffer. `state` holds a generation in its upper bits and the next sequence number
+ * in the lower `PV_RECORDER_WORK_QUEUE_SEQUENCE_BITS`. Frame `n` of a generation starts at buffer position
+ * `origins[generation % 2] + n * frame_length`. Workers claim frames by advancing `state` with a compare-and-swap, then
+ * copy the frame out of the buffer without any lock. `stop` and `start` begin a new generation at the write position,
+ * which drops the unclaimed frames and restarts the sequence, and makes every claim of an earlier generation fail. The
+ * new origin goes to the slot the current generation does not use, so a worker that read `state` always finds its
+ * generation's origin. `workers` is only resized while the device is stopped.
+ */
+typedef struct {
+    __attribute__((aligned(64))) uint64_t state;
+    uint64_t origins[2];
+    int32_t num_workers;
+    pv_recorder_worker_t *workers;
+} pv_recorder_work_queue_t;
+
+/**
+ * Counters updated by the audio callback. There is a single writer, so updates are plain relaxed loads and stores
+ * rather than read-modify-write operations. They live on their own cache line to keep readers of the stats from
+ * disturbing the callback.
+ */
+typedef struct {
+    __attribute__((aligned(64))) uint64_t callback_count;
+    uint64_t overflow_count;
+    uint64_t dropped_samples;
+    int32_t buffer_high_water_mark;
+    int64_t callback_duration_min_ns;
+    int64_t callback_duration_max_ns;
+    int64_t callback_duration_total_ns;
+    uint64_t period_size_histogram[PV_RECORDER_STATS_PERIOD_HISTOGRAM_SIZE];
+} pv_recorder_callback_stats_t;
+
+struct pv_recorder {
+    ma_context *context;
+    ma_device_id device_id;
     ma_device_config device_config;
     ma_device device;
     pv_circular_buffer_t *buffer;
     int32_t frame_length;
+    int32_t sample_rate;
+    int32_t num_channels;
+    pv_recorder_sample_format_t sample_format;
+    int32_t bytes_per_frame;
+    int32_t history_length;
+    int32_t *conversion_buffer;
+    bool is_native_rate_capture;
+    pv_resampler_t *resampler;
+    float *resampled;
     int32_t current_silent_samples;
+    float level_peak;
+    float level_rms;
+    uint64_t num_clipped_samples;
+    bool is_muted;
+    bool is_muted_reported;
+    uint64_t warned_dropped_count;
+    pv_trace_log_t *trace_log;
     bool is_debug_logging_enabled;
-    ma_mutex mutex;
+    ma_event frame_event;
+    bool is_frame_event_initialized;
+    bool is_reader_waiting;
+    int32_t wake_threshold;
+    int32_t buffered_frames_count;
+    pv_recorder_frame_callback_t frame_callback;
+    void *frame_callback_user_data;
+    ma_thread consumer_thread;
+    bool has_consumer_thread;
+    pv_recorder_thread_scheduling_t thread_scheduling;
+    int32_t thread_priority;
+    uint64_t thread_cpu_mask;
+    bool is_capture_thread_config_pending;
+    pv_recorder_thread_config_status_t thread_config_status;
+    const int16_t *peeked_frame;
+    int16_t *peek_copy;
+    uint64_t discard_position;
+    uint64_t applied_discard_position;
+    int event_fd;
+    bool is_event_fd_signaled;
+    uint64_t captured_samples;
+    uint32_t timing_sequence;
+    int64_t callback_time_ns;
+    uint64_t callback_sample_position;
+    uint64_t reported_dropped_count;
+    uint64_t realigned_samples;
+    pv_recorder_callback_stats_t callback_stats;
+    uint64_t read_latency_histogram[PV_RECORDER_STATS_LATENCY_HISTOGRAM_SIZE];
+    bool is_vad_gate_enabled;
+    pv_recorder_vad_gate_t vad_gate;
+    pv_recorder_subscriber_t *subscribers[PV_RECORDER_MAX_SUBSCRIBERS];
+    int32_t num_subscribers;
+    pv_recorder_output_t *outputs[PV_RECORDER_MAX_OUTPUTS];
+    int32_t num_outputs;
+    pv_recorder_output_chain_t output_chain;
+    pv_recorder_work_queue_t work_queue;
 };
 
-static void pv_recorder_ma_callback(ma_device *device, void *output, const void *input, ma_uint32 frame_count) {
-    (void) output;
+/**
+ * Whether the VAD gate has released a frame at or after the read position. Always true when the gate is disabled.
+ */
+static bool pv_recorder_is_released(pv_recorder_t *object) {
+    if (!object->is_vad_gate_enabled) {
+        return true;
+    }
+    const uint64_t release_end = __atomic_load_n(&object->vad_gate.release_end, __ATOMIC_ACQUIRE);
+    return release_end > pv_circular_buffer_get_read_position(object->buffer);
+}
 
-    pv_recorder_t *object = (pv_recorder_t *) device->pUserData;
+/**
+ * Whether the reader waiting for `num_samples` should wake up. With the VAD gate enabled, this also requires a
+ * released frame, or enough decided audio for the reader to discard rejected frames. Called by both the reader and the
+ * audio callback.
+ */
+static bool pv_recorder_is_ready(pv_recorder_t *object, int32_t num_samples) {
+    if (pv_circular_buffer_get_count(object->buffer) < num_samples) {
+        return false;
+    }
+    if (pv_recorder_is_released(object)) {
+        return true;
+    }
+    const uint64_t read_position = pv_circular_buffer_get_read_position(object->buffer);
+    const uint64_t decided_end = __atomic_load_n(&object->vad_gate.decided_end, __ATOMIC_ACQUIRE);
+    return (decided_end > read_position) &&
+           ((decided_end - read_position) >= (uint64_t) object->vad_gate.drain_samples);
+}
 
-    ma_mutex_lock(&object->mutex);
-    pv_circular_buffer_status_t status = pv_circular_buffer_write(object->buffer, input, (int32_t) frame_count);
-    if ((status == PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW) && (object->is_debug_logging_enabled)) {
-        fprintf(stdout, "[WARN] Overflow - reader is not reading fast enough.\n");
+static int32_t pv_recorder_log2_bucket(uint64_t value, int32_t num_buckets) {
+    int32_t bucket = 0;
+    while ((value > 1) && (bucket < (num_buckets - 1))) {
+        value >>= 1;
+        bucket++;
     }
+    return bucket;
+}
 
-    ma_mutex_unlock(&object->mutex);
+static void pv_recorder_increment(uint64_t *counter) {
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
 }
 
-static pv_recorder_status_t ma_result_to_pv_recorder_status(ma_result result) {
-    switch (result) {
-        case MA_SUCCESS:
-            return PV_RECORDER_STATUS_SUCCESS;
-        case MA_NO_BACKEND:
-        case MA_FAILED_TO_INIT_BACKEND:
-            return PV_RECORDER_STATUS_BACKEND_ERROR;
-        case MA_OUT_OF_MEMORY:
-            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
-        case MA_DEVICE_ALREADY_INITIALIZED:
-            return PV_RECORDER_STATUS_DEVICE_ALREADY_INITIALIZED;
+static void pv_recorder_update_callback_stats(
+        pv_recorder_t *object,
+        int32_t period_size,
+        bool is_overflow,
+        int32_t buffer_count,
+        int64_t duration_ns) {
+    pv_recorder_callback_stats_t *stats = &object->callback_stats;
+
+    const uint64_t callback_count = __atomic_load_n(&stats->callback_count, __ATOMIC_RELAXED);
+    if ((callback_count == 0) || (duration_ns < __atomic_load_n(&stats->callback_duration_min_ns, __ATOMIC_RELAXED))) {
+        __atomic_store_n(&stats->callback_duration_min_ns, duration_ns, __ATOMIC_RELAXED);
+    }
+    if (duration_ns > __atomic_load_n(&stats->callback_duration_max_ns, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&stats->callback_duration_max_ns, duration_ns, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(
+            &stats->callback_duration_total_ns,
+            __atomic_load_n(&stats->callback_duration_total_ns, __ATOMIC_RELAXED) + duration_ns,
+            __ATOMIC_RELAXED);
+
+    if (buffer_count > __atomic_load_n(&stats->buffer_high_water_mark, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&stats->buffer_high_water_mark, buffer_count, __ATOMIC_RELAXED);
+    }
+    if (is_overflow) {
+        pv_recorder_increment(&stats->overflow_count);
+    }
+
+    const int32_t bucket = pv_recorder_log2_bucket((uint64_t) period_size, PV_RECORDER_STATS_PERIOD_HISTOGRAM_SIZE);
+    pv_recorder_increment(&stats->period_size_histogram[bucket]);
+
+    // Published last so that a reader that sees the new count also sees a consistent duration total.
+    __atomic_store_n(&stats->callback_count, callback_count + 1, __ATOMIC_RELEASE);
+}
+
+static int64_t pv_recorder_get_time_ns(void) {
+
+#if defined(__PV_RECORDER_PLATFORM_WINDOWS__)
+
+    LARGE_INTEGER counter;
+    LARGE_INTEGER frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (int64_t) ((counter.QuadPart / frequency.QuadPart) * 1000000000LL) +
+           (int64_t) (((counter.QuadPart % frequency.QuadPart) * 1000000000LL) / frequency.QuadPart);
+
+#else
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((int64_t) now.tv_sec * 1000000000LL) + (int64_t) now.tv_nsec;
+
+#endif
+
+}
+
+/**
+ * The audio callback publishes when it ran and how many samples had been captured by then. The pair is guarded by a
+ * sequence counter, which is odd while an update is in progress, so that the reader never sees a mix of two updates.
+ */
+static void pv_recorder_publish_timing(pv_recorder_t *object, int64_t time_ns, uint64_t sample_position) {
+    const uint32_t sequence = object->timing_sequence;
+    __atomic_store_n(&object->timing_sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&object->callback_time_ns, time_ns, __ATOMIC_RELAXED);
+    __atomic_store_n(&object->callback_sample_position, sample_position, __ATOMIC_RELAXED);
+    __atomic_store_n(&object->timing_sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+/**
+ * Estimates when the sample at `sample_position` was captured by extrapolating from the latest callback.
+ */
+static int64_t pv_recorder_get_sample_time_ns(pv_recorder_t *object, uint64_t sample_position) {
+    int64_t time_ns;
+    uint64_t callback_sample_position;
+    uint32_t sequence;
+
+    do {
+        sequence = __atomic_load_n(&object->timing_sequence, __ATOMIC_ACQUIRE);
+        time_ns = __atomic_load_n(&object->callback_time_ns, __ATOMIC_RELAXED);
+        callback_sample_position = __atomic_load_n(&object->callback_sample_position, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((sequence & 1) || (sequence != __atomic_load_n(&object->timing_sequence, __ATOMIC_RELAXED)));
+
+    const int64_t delta_samples = (int64_t) (callback_sample_position - sample_position);
+    return time_ns - ((delta_samples * 1000000000LL) / object->sample_rate);
+}
+
+/**
+ * Records the time from the arrival of the sample just before `end_position` to now. Must only be called from the
+ * reading thread.
+ */
+static void pv_recorder_record_read_latency(pv_recorder_t *object, uint64_t end_position) {
+    const int64_t time_ns = pv_recorder_get_time_ns();
+    if (object->trace_log) {
+        pv_trace_log_write(object->trace_log, PV_RECORDER_TRACE_EVENT_READ, time_ns, (int64_t) end_position);
+    }
+
+    int64_t latency_ns = time_ns - pv_recorder_get_sample_time_ns(object, end_position);
+    if (latency_ns < 0) {
+        latency_ns = 0;
+    }
+
+    const int32_t bucket = pv_recorder_log2_bucket(
+            (uint64_t) (latency_ns / 1000),
+            PV_RECORDER_STATS_LATENCY_HISTOGRAM_SIZE);
+    pv_recorder_increment(&object->read_latency_histogram[bucket]);
+}
+
+#if defined(PV_RECORDER_EVENT_FD)
+
+static void pv_recorder_signal_event_fd(pv_recorder_t *object) {
+    if (!__atomic_exchange_n(&object->is_event_fd_signaled, true, __ATOMIC_SEQ_CST)) {
+        const uint64_t value = 1;
+        (void) write(object->event_fd, &value, sizeof(value));
+    }
+}
+
+static bool pv_recorder_is_read_ready(pv_recorder_t *object) {
+    return ((pv_circular_buffer_get_count(object->buffer) >= object->frame_length) &&
+            pv_recorder_is_released(object)) ||
+           !ma_device_is_started(&object->device);
+}
+
+#endif
+
+/**
+ * Keeps the event file descriptor readable exactly while a read would not block, i.e. while a full frame is buffered
+ * or the device is stopped. Called by the consumer after it takes data out of the buffer and after start/stop. The
+ * descriptor is drained before the flag is cleared so that a signal from the audio callback is never lost in between.
+ */
+static void pv_recorder_update_event_fd(pv_recorder_t *object) {
+#if defined(PV_RECORDER_EVENT_FD)
+
+    if (pv_recorder_is_read_ready(object)) {
+        pv_recorder_signal_event_fd(object);
+        return;
+    }
+    if (!__atomic_load_n(&object->is_event_fd_signaled, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    uint64_t value = 0;
+    (void) read(object->event_fd, &value, sizeof(value));
+    __atomic_store_n(&object->is_event_fd_signaled, false, __ATOMIC_SEQ_CST);
+
+    if (pv_recorder_is_read_ready(object)) {
+        pv_recorder_signal_event_fd(object);
+    }
+
+#else
+
+    (void) object;
+
+#endif
+}
+
+/**
+ * Publishes the level of the latest period and tracks how long the input has been silent. Called from the audio
+ * callback only.
+ */
+static void pv_recorder_update_level(pv_recorder_t *object, const pv_level_meter_result_t *level, int32_t frame_count) {
+    const float rms = (level->num_samples > 0) ? (float) sqrt(level->sum_squares / level->num_samples) : 0.f;
+    __atomic_store(&object->level_peak, &level->peak, __ATOMIC_RELAXED);
+    __atomic_store(&object->level_rms, &rms, __ATOMIC_RELAXED);
+
+    if (level->num_clipped > 0) {
+        const uint64_t num_clipped_samples = __atomic_load_n(&object->num_clipped_samples, __ATOMIC_RELAXED);
+        __atomic_store_n(
+                &object->num_clipped_samples,
+                num_clipped_samples + (uint64_t) level->num_clipped,
+                __ATOMIC_RELAXED);
+    }
+
+    if (level->peak <= SILENCE_PEAK_THRESHOLD) {
+        if (object->current_silent_samples < (MAX_SILENCE_SECONDS * object->sample_rate)) {
+            object->current_silent_samples += frame_count;
+        }
+    } else {
+        object->current_silent_samples = 0;
+    }
+    __atomic_store_n(
+            &object->is_muted,
+            object->current_silent_samples >= (MAX_SILENCE_SECONDS * object->sample_rate),
+            __ATOMIC_RELAXED);
+}
+
+/**
+ * Converts audio of an output stream to 16-bit and writes it to the output's buffer. Writes are split so that none is
+ * longer than the buffer.
+ */
+static void pv_recorder_write_output(pv_recorder_output_t *output, const float *pcm, int32_t num_frames) {
+    const pv_recorder_t *object = output->recorder;
+    const int32_t capacity = output->frame_length * object->buffered_frames_count;
+
+    pv_sample_converter_f32_to_s16(pcm, num_frames * object->num_channels, output->pcm);
+    for (int32_t i = 0; i < num_frames; i += capacity) {
+        const int32_t length = ((num_frames - i) < capacity) ? (num_frames - i) : capacity;
+        pv_circular_buffer_write(output->buffer, output->pcm + (i * object->num_channels), length);
+    }
+}
+
+/**
+ * Runs the audio written to the recorder's buffer since the last call through the output chain and into the buffer of
+ * every output stream. Called after every write to the buffer, so that its cursor is never lapped.
+ */
+static void pv_recorder_write_outputs(pv_recorder_t *object) {
+    pv_recorder_output_chain_t *chain = &object->output_chain;
+
+    while (true) {
+        const int32_t length = pv_circular_buffer_read_at(
+                object->buffer,
+                &chain->position,
+                chain->pcm,
+                chain->chunk_frames);
+        if (length <= 0) {
+            break;
+        }
+        pv_sample_converter_s16_to_f32(chain->pcm, length * object->num_channels, chain->input);
+
+        const float *base = chain->input;
+        int32_t num_base_frames = length;
+        if (chain->resampler) {
+            num_base_frames = pv_resampler_process(chain->resampler, chain->input, length, chain->resampled);
+            base = chain->resampled;
+        }
+        if (chain->decimator) {
+            pv_decimator_process(chain->decimator, base, num_base_frames);
+        }
+
+        for (int32_t i = 0; i < object->num_outputs; i++) {
+            pv_recorder_output_t *output = object->outputs[i];
+
+            const float *pcm = base;
+            int32_t num_frames = num_base_frames;
+            if (output->stage > 0) {
+                pcm = pv_decimator_get_output(chain->decimator, output->stage, &num_frames);
+            }
+            if (output->resampler) {
+                num_frames = pv_resampler_process(output->resampler, pcm, num_frames, output->resampled);
+                pcm = output->resampled;
+            }
+            if (num_frames > 0) {
+                pv_recorder_write_output(output, pcm, num_frames);
+            }
+        }
+    }
+}
+
+/**
+ * Writes audio to the buffer in pieces no longer than its capacity, which it would otherwise reject. Audio beyond the
+ * capacity overwrites audio that has not been read yet, which is counted in the stats and reported as an overflow.
+ * Output streams are fed after each piece, before the next one can overwrite it.
+ */
+static pv_circular_buffer_status_t pv_recorder_write_buffer(
+        pv_recorder_t *object,
+        const void *data,
+        int32_t frame_count) {
+    pv_circular_buffer_status_t status = PV_CIRCULAR_BUFFER_STATUS_SUCCESS;
+
+    const int32_t capacity = object->frame_length * object->buffered_frames_count;
+    const uint8_t *piece = (const uint8_t *) data;
+    while (frame_count > 0) {
+        const int32_t length = (frame_count < capacity) ? frame_count : capacity;
+        const int32_t count = pv_circular_buffer_get_count(object->buffer);
+        if (pv_circular_buffer_write(object->buffer, piece, length) != PV_CIRCULAR_BUFFER_STATUS_SUCCESS) {
+            status = PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW;
+            const int32_t num_overwritten = count + length - capacity;
+            if (num_overwritten > 0) {
+                uint64_t *dropped_samples = &object->callback_stats.dropped_samples;
+                __atomic_store_n(
+                        dropped_samples,
+                        __atomic_load_n(dropped_samples, __ATOMIC_RELAXED) + (uint64_t) num_overwritten,
+                        __ATOMIC_RELAXED);
+            }
+        }
+        if (object->num_outputs > 0) {
+            pv_recorder_write_outputs(object);
+        }
+        piece += (size_t) length * (size_t) object->bytes_per_frame;
+        frame_count -= length;
+    }
+
+    return status;
+}
+
+/**
+ * miniaudio has no 24-bit-in-32 format, so such audio is captured as packed 24-bit and widened here in chunks.
+ */
+static pv_circular_buffer_status_t pv_recorder_write_s24(
+        pv_recorder_t *object,
+        const uint8_t *input,
+        int32_t frame_count,
+        pv_level_meter_result_t *level) {
+    pv_circular_buffer_status_t status = PV_CIRCULAR_BUFFER_STATUS_SUCCESS;
+
+    const int32_t max_chunk_frames = CONVERSION_BUFFER_SIZE / object->num_channels;
+    while (frame_count > 0) {
+        const int32_t chunk_frames = (frame_count < max_chunk_frames) ? frame_count : max_chunk_frames;
+        const int32_t chunk_samples = chunk_frames * object->num_channels;
+        for (int32_t i = 0; i < chunk_samples; i++) {
+            const uint32_t sample =
+                    ((uint32_t) input[0] << 8) | ((uint32_t) input[1] << 16) | ((uint32_t) input[2] << 24);
+            object->conversion_buffer[i] = ((int32_t) sample) >> 8;
+            input += 3;
+        }
+        pv_level_meter_measure_s32(object->conversion_buffer, chunk_samples, 24, level);
+
+        if (pv_recorder_write_buffer(object, object->conversion_buffer, chunk_frames) !=
+            PV_CIRCULAR_BUFFER_STATUS_SUCCESS) {
+            status = PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW;
+        }
+        frame_count -= chunk_frames;
+    }
+
+    return status;
+}
+
+/**
+ * Decides whether the frame that was just completed is passed to the reader. The gate opens when the frame energy is
+ * `open_threshold_db` above the noise floor, stays open while it is `close_threshold_db` above it and then for
+ * `hangover_frames` more. On opening, up to `pre_roll_frames` preceding frames are released as well. The noise floor
+ * follows the energy down quickly and up slowly, and only while the gate is closed.
+ */
+static void pv_recorder_vad_gate_decide(pv_recorder_t *object, double mean_square) {
+    pv_recorder_vad_gate_t *gate = &object->vad_gate;
+    const pv_recorder_vad_gate_options_t *options = &gate->options;
+
+    const double energy_db = 10. * log10(mean_square + 1e-12);
+    if (gate->num_frames == 0) {
+        gate->noise_floor_db = energy_db;
+    }
+
+    const uint64_t frame_index = gate->num_frames;
+    const bool is_above_open = (energy_db > (gate->noise_floor_db + options->open_threshold_db)) &&
+                               (energy_db > VAD_GATE_MIN_ENERGY_DB);
+    const bool is_above_close = energy_db > (gate->noise_floor_db + options->close_threshold_db);
+    bool is_opening = false;
+
+    if (!gate->is_open) {
+        if (is_above_open) {
+            gate->is_open = true;
+            gate->hangover_remaining = options->hangover_frames;
+            is_opening = true;
+        }
+    } else if (is_above_close) {
+        gate->hangover_remaining = options->hangover_frames;
+    } else if (gate->hangover_remaining > 0) {
+        gate->hangover_remaining--;
+    } else {
+        gate->is_open = false;
+    }
+
+    if (!gate->is_open) {
+        const double rate = (energy_db < gate->noise_floor_db) ? gate->floor_fall : gate->floor_rise;
+        gate->noise_floor_db += rate * (energy_db - gate->noise_floor_db);
+    }
+
+    const int32_t num_slots = object->buffered_frames_count;
+    __atomic_store_n(&gate->decisions[frame_index % (uint64_t) num_slots], gate->is_open, __ATOMIC_RELAXED);
+
+    if (gate->is_open) {
+        if (is_opening) {
+            const uint64_t release_end = gate->release_end;
+            const uint64_t released_frames = (release_end > gate->origin) ?
+                    ((release_end - gate->origin) / (uint64_t) object->frame_length) :
+                    0;
+            uint64_t first = (frame_index > (uint64_t) options->pre_roll_frames) ?
+                    (frame_index - (uint64_t) options->pre_roll_frames) :
+                    0;
+            if (first < released_frames) {
+                first = released_frames;
+            }
+            for (uint64_t i = first; i < frame_index; i++) {
+                __atomic_store_n(&gate->decisions[i % (uint64_t) num_slots], 1, __ATOMIC_RELAXED);
+            }
+        }
+        __atomic_store_n(
+                &gate->release_end,
+                gate->origin + ((frame_index + 1) * (uint64_t) object->frame_length),
+                __ATOMIC_RELEASE);
+    }
+
+    gate->num_frames = frame_index + 1;
+    __atomic_store_n(
+            &gate->decided_end,
+            gate->origin + (gate->num_frames * (uint64_t) object->frame_length),
+            __ATOMIC_RELEASE);
+}
+
+/**
+ * Writes a run of audio from the device to the buffer and measures its level.
+ */
+static pv_circular_buffer_status_t pv_recorder_write_input(
+        pv_recorder_t *object,
+        const void *input,
+        int32_t frame_count,
+        pv_level_meter_result_t *level) {
+    const int32_t num_samples = frame_count * object->num_channels;
+
+    pv_circular_buffer_status_t status;
+    switch (object->sample_format) {
+        case PV_RECORDER_SAMPLE_FORMAT_S24_32:
+            if (object->is_native_rate_capture) {
+                status = pv_recorder_write_buffer(object, input, frame_count);
+                pv_level_meter_measure_s32((const int32_t *) input, num_samples, 24, level);
+            } else {
+                status = pv_recorder_write_s24(object, (const uint8_t *) input, frame_count, level);
+            }
+            break;
+        case PV_RECORDER_SAMPLE_FORMAT_S32:
+            status = pv_recorder_write_buffer(object, input, frame_count);
+            pv_level_meter_measure_s32((const int32_t *) input, num_samples, 32, level);
+            break;
+        case PV_RECORDER_SAMPLE_FORMAT_F32:
+            status = pv_recorder_write_buffer(object, input, frame_count);
+            pv_level_meter_measure_f32((const float *) input, num_samples, level);
+            break;
         default:
-            return PV_RECORDER_STATUS_RUNTIME_ERROR;
+            status = pv_recorder_write_buffer(object, input, frame_count);
+            pv_level_meter_measure_s16((const int16_t *) input, num_samples, level);
+            break;
     }
+
+    return status;
 }
 
-PV_API pv_recorder_status_t pv_recorder_init(
-        int32_t frame_length,
-        int32_t device_index,
-        int32_t buffered_frames_count,
-        pv_recorder_t **object) {
-    if (device_index < PV_RECORDER_DEFAULT_DEVICE_INDEX) {
+/**
+ * Writes a period, or part of one, to the buffer and measures its level. With the VAD gate enabled, the audio is split
+ * at frame boundaries so that the gate can decide on each frame as soon as it is complete.
+ */
+static pv_circular_buffer_status_t pv_recorder_write_period(
+        pv_recorder_t *object,
+        const void *input,
+        int32_t frame_count,
+        int32_t input_bytes_per_frame,
+        pv_level_meter_result_t *level) {
+    if (!object->is_vad_gate_enabled) {
+        return pv_recorder_write_input(object, input, frame_count, level);
+    }
+
+    pv_circular_buffer_status_t status = PV_CIRCULAR_BUFFER_STATUS_SUCCESS;
+    pv_recorder_vad_gate_t *gate = &object->vad_gate;
+
+    const uint8_t *segment = (const uint8_t *) input;
+    int32_t remaining = frame_count;
+    while (remaining > 0) {
+        int32_t length = object->frame_length - gate->frame_fill;
+        if (length > remaining) {
+            length = remaining;
+        }
+
+        const double sum_squares = level->sum_squares;
+        if (pv_recorder_write_input(object, segment, length, level) != PV_CIRCULAR_BUFFER_STATUS_SUCCESS) {
+            status = PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW;
+        }
+        gate->frame_sum_squares += level->sum_squares - sum_squares;
+        gate->frame_fill += length;
+
+        if (gate->frame_fill == object->frame_length) {
+            pv_recorder_vad_gate_decide(
+                    object,
+                    gate->frame_sum_squares / (double) (object->frame_length * object->num_channels));
+            gate->frame_sum_squares = 0.;
+            gate->frame_fill = 0;
+        }
+
+        segment += length * input_bytes_per_frame;
+        remaining -= length;
+    }
+
+    return status;
+}
+
+/**
+ * Resamples audio captured at the device's native rate, converts it to the buffer's sample format and writes it. Runs
+ * in chunks so that the scratch buffers stay small. Returns the number of frames written at `sample_rate`.
+ */
+static int32_t pv_recorder_write_native_rate(
+        pv_recorder_t *object,
+        const float *input,
+        int32_t frame_count,
+        pv_level_meter_result_t *level,
+        pv_circular_buffer_status_t *status) {
+    int32_t num_output_frames = 0;
+    while (frame_count > 0) {
+        const int32_t chunk_frames = (frame_count < RESAMPLER_CHUNK_FRAMES) ? frame_count : RESAMPLER_CHUNK_FRAMES;
+
+        const float *chunk = input;
+        int32_t chunk_output_frames = chunk_frames;
+        if (object->resampler) {
+            chunk_output_frames = pv_resampler_process(object->resampler, input, chunk_frames, object->resampled);
+            chunk = object->resampled;
+        }
+
+        const int32_t num_samples = chunk_output_frames * object->num_channels;
+        const void *data = chunk;
+        switch (object->sample_format) {
+            case PV_RECORDER_SAMPLE_FORMAT_S16:
+                pv_sample_converter_f32_to_s16(chunk, num_samples, (int16_t *) object->conversion_buffer);
+                data = object->conversion_buffer;
+                break;
+            case PV_RECORDER_SAMPLE_FORMAT_S24_32:
+                pv_sample_converter_f32_to_s32(chunk, num_samples, 24, object->conversion_buffer);
+                data = object->conversion_buffer;
+                break;
+            case PV_RECORDER_SAMPLE_FORMAT_S32:
+                pv_sample_converter_f32_to_s32(chunk, num_samples, 32, object->conversion_buffer);
+                data = object->conversion_buffer;
+                break;
+            default:
+                break;
+        }
+
+        // The resampler produces nothing until its filter has filled, and the buffer rejects empty writes.
+        if ((chunk_output_frames > 0) &&
+            (pv_recorder_write_period(object, data, chunk_output_frames, object->bytes_per_frame, level) !=
+             PV_CIRCULAR_BUFFER_STATUS_SUCCESS)) {
+            *status = PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW;
+        }
+
+        input += chunk_frames * object->num_channels;
+        frame_count -= chunk_frames;
+        num_output_frames += chunk_output_frames;
+    }
+
+    return num_output_frames;
+}
+
+/**
+ * Loads the state of the work queue and the origin of its generation.
+ */
+static uint64_t pv_recorder_load_work_queue_state(pv_recorder_t *object, uint64_t *origin) {
+    pv_recorder_work_queue_t *queue = &object->work_queue;
+    const uint64_t state = __atomic_load_n(&queue->state, __ATOMIC_ACQUIRE);
+    const uint64_t generation = state >> PV_RECORDER_WORK_QUEUE_SEQUENCE_BITS;
+    *origin = __atomic_load_n(&queue->origins[generation % 2], __ATOMIC_ACQUIRE);
+    return state;
+}
+
+/**
+ * Begins a new generation of the work queue at `origin`. Called from the controlling thread by `stop` and `start`.
+ */
+static void pv_recorder_reset_work_queue(pv_recorder_t *object, uint64_t origin) {
+    pv_recorder_work_queue_t *queue = &object->work_queue;
+    const uint64_t state = __atomic_load_n(&queue->state, __ATOMIC_RELAXED);
+    const uint64_t generation = (state >> PV_RECORDER_WORK_QUEUE_SEQUENCE_BITS) + 1;
+    __atomic_store_n(&queue->origins[generation % 2], origin, __ATOMIC_RELEASE);
+    __atomic_store_n(&queue->state, generation << PV_RECORDER_WORK_QUEUE_SEQUENCE_BITS, __ATOMIC_RELEASE);
+}
+
+/**
+ * Number of whole frames in the buffer that no worker has claimed yet.
+ */
+static uint64_t pv_recorder_get_num_unclaimed_frames(pv_recorder_t *object) {
+    uint64_t origin = 0;
+    const uint64_t state = pv_recorder_load_work_queue_state(object, &origin);
+    const uint64_t write_position = pv_circular_buffer_get_write_position(object->buffer);
+    const uint64_t num_frames = (write_position - origin) / (uint64_t) object->frame_length;
+    const uint64_t next_sequence_number = state & PV_RECORDER_WORK_QUEUE_SEQUENCE_MASK;
+    return (num_frames > next_sequence_number) ? (num_frames - next_sequence_number) : 0;
+}
+
+/**
+ * Wakes as many waiting workers as there are unclaimed frames. Called from the audio callback after the fence that
+ * pairs with the one in `pv_recorder_dequeue()`.
+ */
+static void pv_recorder_wake_workers(pv_recorder_t *object) {
+    pv_recorder_work_queue_t *queue = &object->work_queue;
+    if (queue->num_workers == 0) {
+        return;
+    }
+
+    uint64_t num_frames = pv_recorder_get_num_unclaimed_frames(object);
+    for (int32_t i = 0; (i < queue->num_workers) && (num_frames > 0); i++) {
+        pv_recorder_worker_t *worker = &queue->workers[i];
+        if (__atomic_load_n(&worker->is_waiting, __ATOMIC_RELAXED) &&
+            __atomic_exchange_n(&worker->is_waiting, false, __ATOMIC_RELAXED)) {
+            ma_event_signal(&worker->event);
+            num_frames--;
+        }
+    }
+}
+
+/**
+ * Applies the requested scheduling and CPU affinity to the calling thread. The results are stored atomically since
+ * they are written by the audio or consumer thread and read by `pv_recorder_get_thread_config_status()`.
+ */
+static void pv_recorder_configure_thread(
+        const pv_recorder_t *object,
+        pv_recorder_thread_config_result_t *scheduling_result,
+        pv_recorder_thread_config_result_t *affinity_result) {
+    pv_recorder_thread_config_result_t scheduling = PV_RECORDER_THREAD_CONFIG_NOT_REQUESTED;
+    pv_recorder_thread_config_result_t affinity = PV_RECORDER_THREAD_CONFIG_NOT_REQUESTED;
+
+#if defined(__PV_RECORDER_PLATFORM_WINDOWS__)
+
+    if (object->thread_scheduling != PV_RECORDER_THREAD_SCHEDULING_DEFAULT) {
+        scheduling = SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) ?
+                PV_RECORDER_THREAD_CONFIG_APPLIED :
+                PV_RECORDER_THREAD_CONFIG_FAILED;
+    }
+    if (object->thread_cpu_mask != 0) {
+        affinity = SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR) object->thread_cpu_mask) ?
+                PV_RECORDER_THREAD_CONFIG_APPLIED :
+                PV_RECORDER_THREAD_CONFIG_FAILED;
+    }
+
+#else
+
+    if (object->thread_scheduling != PV_RECORDER_THREAD_SCHEDULING_DEFAULT) {
+        const int policy = (object->thread_scheduling == PV_RECORDER_THREAD_SCHEDULING_FIFO) ? SCHED_FIFO : SCHED_RR;
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = (object->thread_priority > 0) ?
+                object->thread_priority :
+                sched_get_priority_min(policy);
+
+#if defined(__PV_RECORDER_PLATFORM_DARWIN__)
+
+        // The lowest real-time priority on macOS is below the default one, so the thread keeps its own instead.
+        if (object->thread_priority == 0) {
+            int current_policy = 0;
+            struct sched_param current_param;
+            if (pthread_getschedparam(pthread_self(), &current_policy, &current_param) == 0) {
+                param.sched_priority = current_param.sched_priority;
+            }
+        }
+
+#endif
+
+        scheduling = (pthread_setschedparam(pthread_self(), policy, &param) == 0) ?
+                PV_RECORDER_THREAD_CONFIG_APPLIED :
+                PV_RECORDER_THREAD_CONFIG_FAILED;
+    }
+    if (object->thread_cpu_mask != 0) {
+
+#if defined(__PV_RECORDER_PLATFORM_LINUX__) || defined(__PV_RECORDER_PLATFORM_RASPBERRYPI__)
+
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (int32_t i = 0; i < 64; i++) {
+            if (object->thread_cpu_mask & (1ULL << i)) {
+                CPU_SET(i, &cpu_set);
+            }
+        }
+        affinity = (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0) ?
+                PV_RECORDER_THREAD_CONFIG_APPLIED :
+                PV_RECORDER_THREAD_CONFIG_FAILED;
+
+#else
+
+        // macOS has no API to pin a thread to a CPU.
+        affinity = PV_RECORDER_THREAD_CONFIG_UNSUPPORTED;
+
+#endif
+
+    }
+
+#endif
+
+    __atomic_store_n(scheduling_result, scheduling, __ATOMIC_RELAXED);
+    __atomic_store_n(affinity_result, affinity, __ATOMIC_RELAXED);
+}
+
+/**
+ * Whether the audio callback runs on a thread that miniaudio creates. Other backends, such as Core Audio, call it from
+ * a thread that the system has already configured for audio, which must not be changed.
+ */
+static bool pv_recorder_is_capture_thread_configurable(const pv_recorder_t *object) {
+    switch (object->context->backend) {
+        case ma_backend_wasapi:
+        case ma_backend_dsound:
+        case ma_backend_winmm:
+        case ma_backend_alsa:
+        case ma_backend_pulseaudio:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void pv_recorder_ma_callback(ma_device *device, void *output, const void *input, ma_uint32 frame_count) {
+    (void) output;
+
+    pv_recorder_t *object = (pv_recorder_t *) device->pUserData;
+
+    // The thread may be a different one after every start, so it is configured from the first callback. This makes
+    // system calls once per start.
+    if (object->is_capture_thread_config_pending) {
+        object->is_capture_thread_config_pending = false;
+        pv_recorder_configure_thread(
+                object,
+                &object->thread_config_status.capture_scheduling,
+                &object->thread_config_status.capture_affinity);
+    }
+
+    const int64_t time_ns = pv_recorder_get_time_ns();
+    if (object->trace_log) {
+        pv_trace_log_write(object->trace_log, PV_RECORDER_TRACE_EVENT_CALLBACK_BEGIN, time_ns, (int64_t) frame_count);
+    }
+
+    pv_level_meter_result_t level = {0};
+    pv_circular_buffer_status_t status = PV_CIRCULAR_BUFFER_STATUS_SUCCESS;
+
+    int32_t num_frames = (int32_t) frame_count;
+    if (object->is_native_rate_capture) {
+        num_frames = pv_recorder_write_native_rate(object, (const float *) input, num_frames, &level, &status);
+    } else {
+        const int32_t input_bytes_per_frame = (int32_t) ma_get_bytes_per_frame(
+                object->device.capture.format,
+                object->device.capture.channels);
+        status = pv_recorder_write_period(object, input, num_frames, input_bytes_per_frame, &level);
+    }
+    pv_recorder_update_level(object, &level, num_frames);
+    if ((status == PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW) && object->trace_log) {
+        pv_trace_log_write(object->trace_log, PV_RECORDER_TRACE_EVENT_OVERFLOW, time_ns, (int64_t) frame_count);
+    }
+
+    object->captured_samples += (uint64_t) num_frames;
+    pv_recorder_publish_timing(object, time_ns, object->captured_samples);
+
+    const int32_t buffer_count = pv_circular_buffer_get_count(object->buffer);
+
+#if defined(PV_RECORDER_EVENT_FD)
+
+    if ((buffer_count >= object->frame_length) && pv_recorder_is_released(object)) {
+        pv_recorder_signal_event_fd(object);
+    }
+
+#endif
+
+    // Pairs with the fence in `pv_recorder_wait_for_event()` so that either the reader sees the new samples or we see
+    // that the reader is waiting.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&object->is_reader_waiting, __ATOMIC_RELAXED) &&
+        pv_recorder_is_ready(object, __atomic_load_n(&object->wake_threshold, __ATOMIC_RELAXED)) &&
+        __atomic_exchange_n(&object->is_reader_waiting, false, __ATOMIC_RELAXED)) {
+        ma_event_signal(&object->frame_event);
+    }
+
+    // Subscribers are only added and removed while the device is stopped, so the list is stable here.
+    for (int32_t i = 0; i < object->num_subscribers; i++) {
+        pv_recorder_subscriber_t *subscriber = object->subscribers[i];
+        if (__atomic_load_n(&subscriber->is_waiting, __ATOMIC_RELAXED) &&
+            (pv_circular_buffer_get_count_at(object->buffer, &subscriber->position) >= subscriber->frame_length) &&
+            __atomic_exchange_n(&subscriber->is_waiting, false, __ATOMIC_RELAXED)) {
+            ma_event_signal(&subscriber->event);
+        }
+    }
+    for (int32_t i = 0; i < object->num_outputs; i++) {
+        pv_recorder_output_t *output = object->outputs[i];
+        if (__atomic_load_n(&output->is_waiting, __ATOMIC_RELAXED) &&
+            (pv_circular_buffer_get_count(output->buffer) >= output->frame_length) &&
+            __atomic_exchange_n(&output->is_waiting, false, __ATOMIC_RELAXED)) {
+            ma_event_signal(&output->event);
+        }
+    }
+
+    pv_recorder_wake_workers(object);
+
+    const int64_t end_time_ns = pv_recorder_get_time_ns();
+    pv_recorder_update_callback_stats(
+            object,
+            (int32_t) frame_count,
+            status == PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW,
+            buffer_count,
+            end_time_ns - time_ns);
+    if (object->trace_log) {
+        pv_trace_log_write(object->trace_log, PV_RECORDER_TRACE_EVENT_CALLBACK_END, end_time_ns, (int64_t) frame_count);
+    }
+}
+
+static void pv_recorder_wake_subscribers(pv_recorder_t *object) {
+    for (int32_t i = 0; i < object->num_subscribers; i++) {
+        __atomic_store_n(&object->subscribers[i]->is_waiting, false, __ATOMIC_RELAXED);
+        ma_event_signal(&object->subscribers[i]->event);
+    }
+    for (int32_t i = 0; i < object->num_outputs; i++) {
+        __atomic_store_n(&object->outputs[i]->is_waiting, false, __ATOMIC_RELAXED);
+        ma_event_signal(&object->outputs[i]->event);
+    }
+    for (int32_t i = 0; i < object->work_queue.num_workers; i++) {
+        __atomic_store_n(&object->work_queue.workers[i].is_waiting, false, __ATOMIC_RELAXED);
+        ma_event_signal(&object->work_queue.workers[i].event);
+    }
+}
+
+static void pv_recorder_ma_notification_callback(const ma_device_notification *notification) {
+    pv_recorder_t *object = (pv_recorder_t *) notification->pDevice->pUserData;
+
+    // The backend stops the device when it is unplugged and reroutes it when the default device changes. Either way
+    // the device list may have changed.
+    if ((notification->type == ma_device_notification_type_stopped) ||
+        (notification->type == ma_device_notification_type_rerouted)) {
+        __atomic_store_n(&shared_context.is_rescan_requested, true, __ATOMIC_RELAXED);
+        if (__atomic_load_n(&shared_context.is_rescan_event_initialized, __ATOMIC_ACQUIRE)) {
+            ma_event_signal(&shared_context.rescan_event);
+        }
+    }
+
+    // Wake up a blocked reader if the backend stops the device, e.g. when it is unplugged.
+    if (notification->type == ma_device_notification_type_stopped) {
+        __atomic_store_n(&object->is_reader_waiting, false, __ATOMIC_RELAXED);
+        ma_event_signal(&object->frame_event);
+        pv_recorder_wake_subscribers(object);
+
+#if defined(PV_RECORDER_EVENT_FD)
+
+        pv_recorder_signal_event_fd(object);
+
+#endif
+    }
+}
+
+static ma_result pv_recorder_wait_for_event(pv_recorder_t *object, int32_t num_samples) {
+    __atomic_store_n(&object->wake_threshold, num_samples, __ATOMIC_RELAXED);
+    __atomic_store_n(&object->is_reader_waiting, true, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    if (pv_recorder_is_ready(object, num_samples) || !ma_device_is_started(&object->device)) {
+        __atomic_store_n(&object->is_reader_waiting, false, __ATOMIC_RELAXED);
+        return MA_SUCCESS;
+    }
+
+    return ma_event_wait(&object->frame_event);
+}
+
+/**
+ * Discards the audio that `pv_recorder_stop()` or `pv_recorder_start()` left in the buffer. They run on the controlling
+ * thread, which must not move the read position while a reader may be copying from it, so they only record in
+ * `discard_position` where the next recording starts and the reader moves there itself. Once applied, the position is
+ * also the origin from which the reader counts frames. This also drops a frame that was peeked before the stop. Must
+ * only be called from the reading thread.
+ */
+static void pv_recorder_apply_discard(pv_recorder_t *object) {
+    const uint64_t position = __atomic_load_n(&object->discard_position, __ATOMIC_ACQUIRE);
+    if (position != object->applied_discard_position) {
+        pv_circular_buffer_discard_until(object->buffer, position);
+        object->applied_discard_position = position;
+        object->peeked_frame = NULL;
+    }
+}
+
+/**
+ * Moves the read position past audio the callback overwrote, and then on to the next frame boundary, so that a read
+ * after an overflow still starts at a whole frame. The samples skipped to reach the boundary are counted as dropped,
+ * both by the buffer and in `realigned_samples` for the stats. Returns true if the read position was already at a
+ * boundary; otherwise fewer samples may be buffered than before, and the caller waits again. Must only be called from
+ * the reading thread, with at least a frame buffered.
+ */
+static bool pv_recorder_align_to_frame(pv_recorder_t *object) {
+    // A one-frame buffer only holds a whole frame when it is full, and after an overflow it is full from wherever the
+    // callback stopped writing, so it could wait for a boundary forever.
+    if (object->buffered_frames_count == 1) {
+        return true;
+    }
+
+    // Peeking skips the overwritten audio and counts it as dropped.
+    const void *unused = NULL;
+    (void) pv_circular_buffer_peek(object->buffer, &unused, 1);
+
+    const uint64_t frame_length = (uint64_t) object->frame_length;
+    const uint64_t read_position = pv_circular_buffer_get_read_position(object->buffer);
+    const uint64_t offset = (read_position - object->applied_discard_position) % frame_length;
+    if (offset == 0) {
+        return true;
+    }
+
+    pv_circular_buffer_drop(object->buffer, (int32_t) (frame_length - offset));
+    __atomic_store_n(
+            &object->realigned_samples,
+            object->realigned_samples + (frame_length - offset),
+            __ATOMIC_RELAXED);
+    return false;
+}
+
+/**
+ * Whether a frame is peeked and not yet released. Reads that copy frames out would return that frame again, and the
+ * release after them would skip one the caller never saw. A frame peeked before a stop does not count.
+ */
+static bool pv_recorder_is_peeked(pv_recorder_t *object) {
+    pv_recorder_apply_discard(object);
+    return object->peeked_frame != NULL;
+}
+
+static pv_recorder_status_t pv_recorder_wait_for_samples(pv_recorder_t *object, int32_t num_samples) {
+    while (true) {
+        pv_recorder_apply_discard(object);
+        if (pv_recorder_is_ready(object, num_samples)) {
+            break;
+        }
+        if (!ma_device_is_started(&object->device)) {
+            return PV_RECORDER_STATUS_INVALID_STATE;
+        }
+
+        ma_result result = pv_recorder_wait_for_event(object, num_samples);
+        if (result != MA_SUCCESS) {
+            return PV_RECORDER_STATUS_IO_ERROR;
+        }
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+/**
+ * Waits until `num_samples` are buffered from a frame boundary.
+ */
+static pv_recorder_status_t pv_recorder_wait_for_aligned_samples(pv_recorder_t *object, int32_t num_samples) {
+    do {
+        pv_recorder_status_t status = pv_recorder_wait_for_samples(object, num_samples);
+        if (status != PV_RECORDER_STATUS_SUCCESS) {
+            return status;
+        }
+    } while (!pv_recorder_align_to_frame(object));
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+/**
+ * Waits until a frame can be read from the read position. Every read path goes through here, so they all realign to
+ * the same frame boundaries after an overflow. With the VAD gate enabled, this also discards the frames the gate
+ * rejected in front of the next released frame. Frames are counted from the applied discard position rather than the
+ * gate's `origin`, which belongs to the audio callback.
+ */
+static pv_recorder_status_t pv_recorder_wait_for_frame(pv_recorder_t *object) {
+    if (!object->is_vad_gate_enabled) {
+        return pv_recorder_wait_for_aligned_samples(object, object->frame_length);
+    }
+
+    pv_recorder_vad_gate_t *gate = &object->vad_gate;
+    const uint64_t frame_length = (uint64_t) object->frame_length;
+
+    while (true) {
+        pv_recorder_status_t status = pv_recorder_wait_for_samples(object, object->frame_length);
+        if (status != PV_RECORDER_STATUS_SUCCESS) {
+            return status;
+        }
+
+        if (!pv_recorder_align_to_frame(object)) {
+            continue;
+        }
+
+        const uint64_t origin = object->applied_discard_position;
+        const uint64_t read_position = pv_circular_buffer_get_read_position(object->buffer);
+
+        const uint64_t release_end = __atomic_load_n(&gate->release_end, __ATOMIC_ACQUIRE);
+        const uint64_t decided_end = __atomic_load_n(&gate->decided_end, __ATOMIC_ACQUIRE);
+        const uint64_t frame_index = (read_position - origin) / frame_length;
+        const uint64_t slot = frame_index % (uint64_t) object->buffered_frames_count;
+        const uint64_t pre_roll_end = read_position + ((uint64_t) gate->options.pre_roll_frames * frame_length);
+
+        if (read_position < release_end) {
+            if (__atomic_load_n(&gate->decisions[slot], __ATOMIC_RELAXED)) {
+                return PV_RECORDER_STATUS_SUCCESS;
+            }
+        } else if (decided_end <= pre_roll_end) {
+            // The frame may still be released as pre-roll of a frame that is not decided yet.
+            continue;
+        }
+
+        pv_circular_buffer_commit(object->buffer, object->frame_length);
+        pv_recorder_increment(&gate->num_gated_frames);
+    }
+}
+
+/**
+ * Prints debug warnings on behalf of the audio callback, which must not block on I/O. Called from the reading thread.
+ */
+static void pv_recorder_report_warnings(pv_recorder_t *object) {
+    if (!object->is_debug_logging_enabled) {
+        return;
+    }
+
+    const uint64_t dropped_count = pv_circular_buffer_get_dropped_count(object->buffer);
+    if (dropped_count != object->warned_dropped_count) {
+        fprintf(stdout, "[WARN] Overflow - reader is not reading fast enough.\n");
+        object->warned_dropped_count = dropped_count;
+    }
+
+    const bool is_muted = __atomic_load_n(&object->is_muted, __ATOMIC_RELAXED);
+    if (is_muted && !object->is_muted_reported) {
+        fprintf(stdout, "[WARN] Input device might be muted or volume level is set to 0.\n");
+    }
+    object->is_muted_reported = is_muted;
+}
+
+static ma_thread_result MA_THREADCALL pv_recorder_consumer_thread(void *data) {
+    pv_recorder_t *object = (pv_recorder_t *) data;
+
+    pv_recorder_configure_thread(
+            object,
+            &object->thread_config_status.consumer_scheduling,
+            &object->thread_config_status.consumer_affinity);
+
+    // Returns without blocking while whole frames are buffered, so every frame buffered since a wakeup is delivered
+    // before waiting again.
+    while (pv_recorder_wait_for_frame(object) == PV_RECORDER_STATUS_SUCCESS) {
+        const void *peeked = NULL;
+        const int16_t *frame = object->peek_copy;
+        uint64_t end_position = 0;
+        if (pv_circular_buffer_peek(object->buffer, &peeked, object->frame_length) == object->frame_length) {
+            frame = (const int16_t *) peeked;
+            end_position = pv_circular_buffer_get_read_position(object->buffer) + (uint64_t) object->frame_length;
+        } else {
+            pv_circular_buffer_read(object->buffer, object->peek_copy, object->frame_length);
+            end_position = pv_circular_buffer_get_read_position(object->buffer);
+        }
+
+        pv_recorder_record_read_latency(object, end_position);
+        pv_recorder_report_warnings(object);
+        object->frame_callback(frame, object->frame_callback_user_data);
+
+        if (frame != object->peek_copy) {
+            pv_circular_buffer_commit(object->buffer, object->frame_length);
+        }
+
+        pv_recorder_update_event_fd(object);
+    }
+
+    return (ma_thread_result) 0;
+}
+
+static void pv_recorder_join_consumer_thread(pv_recorder_t *object) {
+    if (!object->has_consumer_thread) {
+        return;
+    }
+
+    __atomic_store_n(&object->is_reader_waiting, false, __ATOMIC_RELAXED);
+    ma_event_signal(&object->frame_event);
+
+    ma_thread_wait(&object->consumer_thread);
+    object->has_consumer_thread = false;
+}
+
+static pv_recorder_status_t ma_result_to_pv_recorder_status(ma_result result) {
+    switch (result) {
+        case MA_SUCCESS:
+            return PV_RECORDER_STATUS_SUCCESS;
+        case MA_NO_BACKEND:
+        case MA_FAILED_TO_INIT_BACKEND:
+            return PV_RECORDER_STATUS_BACKEND_ERROR;
+        case MA_OUT_OF_MEMORY:
+            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+        case MA_DEVICE_ALREADY_INITIALIZED:
+            return PV_RECORDER_STATUS_DEVICE_ALREADY_INITIALIZED;
+        default:
+            return PV_RECORDER_STATUS_RUNTIME_ERROR;
+    }
+}
+
+static ma_format pv_recorder_sample_format_to_ma_format(pv_recorder_sample_format_t sample_format) {
+    switch (sample_format) {
+        case PV_RECORDER_SAMPLE_FORMAT_S16:
+            return ma_format_s16;
+        case PV_RECORDER_SAMPLE_FORMAT_S24_32:
+            return ma_format_s24;
+        case PV_RECORDER_SAMPLE_FORMAT_S32:
+            return ma_format_s32;
+        case PV_RECORDER_SAMPLE_FORMAT_F32:
+            return ma_format_f32;
+        default:
+            return ma_format_unknown;
+    }
+}
+
+static bool pv_recorder_ma_format_to_sample_format(ma_format format, pv_recorder_sample_format_t *sample_format) {
+    switch (format) {
+        case ma_format_s16:
+            *sample_format = PV_RECORDER_SAMPLE_FORMAT_S16;
+            return true;
+        case ma_format_s24:
+            *sample_format = PV_RECORDER_SAMPLE_FORMAT_S24_32;
+            return true;
+        case ma_format_s32:
+            *sample_format = PV_RECORDER_SAMPLE_FORMAT_S32;
+            return true;
+        case ma_format_f32:
+            *sample_format = PV_RECORDER_SAMPLE_FORMAT_F32;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static int32_t pv_recorder_sample_format_size(pv_recorder_sample_format_t sample_format) {
+    return (sample_format == PV_RECORDER_SAMPLE_FORMAT_S16) ? (int32_t) sizeof(int16_t) : (int32_t) sizeof(int32_t);
+}
+
+static pv_recorder_status_t pv_resampler_status_to_pv_recorder_status(pv_resampler_status_t status) {
+    switch (status) {
+        case PV_RESAMPLER_STATUS_SUCCESS:
+            return PV_RECORDER_STATUS_SUCCESS;
+        case PV_RESAMPLER_STATUS_OUT_OF_MEMORY:
+            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+        default:
+            return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+}
+
+static void pv_recorder_free_output_chain(pv_recorder_t *object) {
+    pv_recorder_output_chain_t *chain = &object->output_chain;
+    free(chain->pcm);
+    free(chain->input);
+    pv_resampler_delete(chain->resampler);
+    free(chain->resampled);
+    pv_decimator_delete(chain->decimator);
+    memset(chain, 0, sizeof(pv_recorder_output_chain_t));
+
+    for (int32_t i = 0; i < object->num_outputs; i++) {
+        pv_recorder_output_t *output = object->outputs[i];
+        pv_resampler_delete(output->resampler);
+        free(output->resampled);
+        free(output->pcm);
+        output->resampler = NULL;
+        output->resampled = NULL;
+        output->pcm = NULL;
+    }
+}
+
+static void pv_recorder_free_output(pv_recorder_output_t *output) {
+    pv_resampler_delete(output->resampler);
+    free(output->resampled);
+    free(output->pcm);
+    pv_circular_buffer_delete(output->buffer);
+    ma_event_uninit(&(output->event));
+    free(output);
+}
+
+/**
+ * Builds the output chain for the current set of outputs. Each output reads the deepest stage that still runs at or
+ * above its rate. Halving stops at an odd rate, so that every stage runs at a whole number of samples per second.
+ */
+static pv_recorder_status_t pv_recorder_configure_outputs(pv_recorder_t *object) {
+    pv_recorder_free_output_chain(object);
+    if (object->num_outputs == 0) {
+        return PV_RECORDER_STATUS_SUCCESS;
+    }
+
+    pv_recorder_output_chain_t *chain = &object->output_chain;
+    const size_t num_channels = (size_t) object->num_channels;
+
+    chain->base_rate = 0;
+    for (int32_t i = 0; i < object->num_outputs; i++) {
+        if (object->outputs[i]->sample_rate > chain->base_rate) {
+            chain->base_rate = object->outputs[i]->sample_rate;
+        }
+    }
+
+    int32_t num_stages = 0;
+    for (int32_t i = 0; i < object->num_outputs; i++) {
+        pv_recorder_output_t *output = object->outputs[i];
+        int32_t stage = 0;
+        while (((chain->base_rate % (2 << stage)) == 0) && ((chain->base_rate / (2 << stage)) >= output->sample_rate)) {
+            stage++;
+        }
+        output->stage = stage;
+        if (stage > num_stages) {
+            num_stages = stage;
+        }
+    }
+
+    // Reads from the recorder's buffer are limited to its capacity.
+    const int32_t buffer_capacity = object->frame_length * object->buffered_frames_count;
+    chain->chunk_frames = (buffer_capacity < OUTPUT_CHUNK_FRAMES) ? buffer_capacity : OUTPUT_CHUNK_FRAMES;
+
+    chain->pcm = malloc((size_t) chain->chunk_frames * num_channels * sizeof(int16_t));
+    chain->input = malloc((size_t) chain->chunk_frames * num_channels * sizeof(float));
+    if (!(chain->pcm) || !(chain->input)) {
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+
+    int32_t max_base_frames = chain->chunk_frames;
+    if (chain->base_rate != object->sample_rate) {
+        const pv_resampler_status_t status = pv_resampler_init(
+                object->sample_rate,
+                chain->base_rate,
+                object->num_channels,
+                chain->chunk_frames,
+                OUTPUT_RESAMPLER_QUALITY,
+                &(chain->resampler));
+        if (status != PV_RESAMPLER_STATUS_SUCCESS) {
+            return pv_resampler_status_to_pv_recorder_status(status);
+        }
+        max_base_frames = pv_resampler_get_max_output_frames(chain->resampler);
+        chain->resampled = malloc((size_t) max_base_frames * num_channels * sizeof(float));
+        if (!(chain->resampled)) {
+            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+        }
+    }
+
+    if (num_stages > 0) {
+        const pv_decimator_status_t status = pv_decimator_init(
+                object->num_channels,
+                num_stages,
+                max_base_frames,
+                &(chain->decimator));
+        if (status != PV_DECIMATOR_STATUS_SUCCESS) {
+            return (status == PV_DECIMATOR_STATUS_OUT_OF_MEMORY) ?
+                    PV_RECORDER_STATUS_OUT_OF_MEMORY :
+                    PV_RECORDER_STATUS_INVALID_ARGUMENT;
+        }
+    }
+
+    for (int32_t i = 0; i < object->num_outputs; i++) {
+        pv_recorder_output_t *output = object->outputs[i];
+        const int32_t stage_rate = chain->base_rate >> output->stage;
+        int32_t max_frames = (output->stage > 0) ?
+                pv_decimator_get_max_output_frames(chain->decimator, output->stage) :
+                max_base_frames;
+
+        if (stage_rate != output->sample_rate) {
+            const pv_resampler_status_t status = pv_resampler_init(
+                    stage_rate,
+                    output->sample_rate,
+                    object->num_channels,
+                    max_frames,
+                    OUTPUT_RESAMPLER_QUALITY,
+                    &(output->resampler));
+            if (status != PV_RESAMPLER_STATUS_SUCCESS) {
+                return pv_resampler_status_to_pv_recorder_status(status);
+            }
+            max_frames = pv_resampler_get_max_output_frames(output->resampler);
+            output->resampled = malloc((size_t) max_frames * num_channels * sizeof(float));
+            if (!(output->resampled)) {
+                return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+            }
+        }
+
+        output->pcm = malloc((size_t) max_frames * num_channels * sizeof(int16_t));
+        if (!(output->pcm)) {
+            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+        }
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+/**
+ * Starts the output chain at `position` of the recorder's buffer with empty filters.
+ */
+static void pv_recorder_reset_outputs(pv_recorder_t *object, uint64_t position) {
+    pv_recorder_output_chain_t *chain = &object->output_chain;
+    chain->position = position;
+    if (chain->resampler) {
+        pv_resampler_reset(chain->resampler);
+    }
+    if (chain->decimator) {
+        pv_decimator_reset(chain->decimator);
+    }
+    for (int32_t i = 0; i < object->num_outputs; i++) {
+        if (object->outputs[i]->resampler) {
+            pv_resampler_reset(object->outputs[i]->resampler);
+        }
+    }
+}
+
+static void pv_recorder_free_workers(pv_recorder_t *object) {
+    pv_recorder_work_queue_t *queue = &object->work_queue;
+    for (int32_t i = 0; i < queue->num_workers; i++) {
+        ma_event_uninit(&(queue->workers[i].event));
+    }
+    ma_aligned_free(queue->workers, NULL);
+    queue->workers = NULL;
+    queue->num_workers = 0;
+}
+
+static ma_result pv_recorder_shared_context_acquire_locked(void) {
+    if (shared_context.ref_count == 0) {
+        ma_result result = ma_context_init(
+                (shared_context.num_backends > 0) ? shared_context.backends : NULL,
+                (ma_uint32) shared_context.num_backends,
+                NULL,
+                &(shared_context.context));
+        if (result != MA_SUCCESS) {
+            return result;
+        }
+    }
+    shared_context.ref_count++;
+    return MA_SUCCESS;
+}
+
+static void pv_recorder_shared_context_release_locked(void) {
+    shared_context.ref_count--;
+    if (shared_context.ref_count == 0) {
+        ma_context_uninit(&(shared_context.context));
+    }
+}
+
+static ma_result pv_recorder_shared_context_acquire(ma_context **context) {
+    pv_recorder_static_mutex_lock(&shared_context_lock);
+    ma_result result = pv_recorder_shared_context_acquire_locked();
+    pv_recorder_static_mutex_unlock(&shared_context_lock);
+
+    *context = (result == MA_SUCCESS) ? &(shared_context.context) : NULL;
+
+    return result;
+}
+
+static void pv_recorder_shared_context_release(void) {
+    pv_recorder_static_mutex_lock(&shared_context_lock);
+    pv_recorder_shared_context_release_locked();
+    pv_recorder_static_mutex_unlock(&shared_context_lock);
+}
+
+/**
+ * Formats a device ID as `<backend>:<id>`. The ID part is the backend's own identifier, which survives restarts and
+ * does not depend on the order of enumeration. Backends without a textual identifier use the device name.
+ */
+static void pv_recorder_device_id_to_string(
+        ma_backend backend,
+        const ma_device_info *info,
+        char string[PV_RECORDER_DEVICE_ID_SIZE]) {
+    const ma_device_id *id = &(info->id);
+
+    switch (backend) {
+        case ma_backend_wasapi: {
+            int32_t length = snprintf(string, PV_RECORDER_DEVICE_ID_SIZE, "wasapi:");
+            for (int32_t i = 0; (i < 64) && id->wasapi[i] && (length < (PV_RECORDER_DEVICE_ID_SIZE - 1)); i++) {
+                // WASAPI endpoint IDs are ASCII.
+                string[length++] = (char) id->wasapi[i];
+            }
+            string[length] = '\0';
+            break;
+        }
+        case ma_backend_dsound: {
+            int32_t length = snprintf(string, PV_RECORDER_DEVICE_ID_SIZE, "dsound:");
+            for (int32_t i = 0; i < 16; i++) {
+                length += snprintf(
+                        string + length,
+                        (size_t) (PV_RECORDER_DEVICE_ID_SIZE - length),
+                        "%02x",
+                        id->dsound[i]);
+            }
+            break;
+        }
+        case ma_backend_winmm:
+            snprintf(string, PV_RECORDER_DEVICE_ID_SIZE, "winmm:%u", (unsigned int) id->winmm);
+            break;
+        case ma_backend_coreaudio:
+            snprintf(string, PV_RECORDER_DEVICE_ID_SIZE, "coreaudio:%.255s", id->coreaudio);
+            break;
+        case ma_backend_pulseaudio:
+            snprintf(string, PV_RECORDER_DEVICE_ID_SIZE, "pulseaudio:%.255s", id->pulse);
+            break;
+        case ma_backend_alsa:
+            snprintf(string, PV_RECORDER_DEVICE_ID_SIZE, "alsa:%.255s", id->alsa);
+            break;
+        case ma_backend_jack:
+            snprintf(string, PV_RECORDER_DEVICE_ID_SIZE, "jack:%d", id->jack);
+            break;
+        default:
+            snprintf(string, PV_RECORDER_DEVICE_ID_SIZE, "name:%.255s", info->name);
+            break;
+    }
+}
+
+/**
+ * Parses a device ID produced by `pv_recorder_device_id_to_string()` without enumerating devices. Returns false if
+ * the ID belongs to another backend or can only be resolved through the device list.
+ */
+static bool pv_recorder_device_id_from_string(ma_backend backend, const char *string, ma_device_id *id) {
+    memset(id, 0, sizeof(*id));
+
+    const char *separator = strchr(string, ':');
+    if (!separator) {
+        return false;
+    }
+    const size_t prefix_length = (size_t) (separator - string);
+    const char *value = separator + 1;
+
+#define PV_RECORDER_IS_PREFIX(prefix) \
+    ((prefix_length == strlen(prefix)) && (strncmp(string, prefix, prefix_length) == 0))
+
+    switch (backend) {
+        case ma_backend_wasapi: {
+            if (!PV_RECORDER_IS_PREFIX("wasapi") || (strlen(value) >= 64)) {
+                return false;
+            }
+            for (int32_t i = 0; value[i]; i++) {
+                id->wasapi[i] = (ma_wchar_win32) value[i];
+            }
+            return true;
+        }
+        case ma_backend_dsound: {
+            if (!PV_RECORDER_IS_PREFIX("dsound") || (strlen(value) != 32)) {
+                return false;
+            }
+            for (int32_t i = 0; i < 16; i++) {
+                unsigned int byte = 0;
+                if (sscanf(value + (2 * i), "%2x", &byte) != 1) {
+                    return false;
+                }
+                id->dsound[i] = (ma_uint8) byte;
+            }
+            return true;
+        }
+        case ma_backend_winmm:
+            return PV_RECORDER_IS_PREFIX("winmm") && (sscanf(value, "%u", &(id->winmm)) == 1);
+        case ma_backend_coreaudio:
+            if (!PV_RECORDER_IS_PREFIX("coreaudio") || (strlen(value) >= sizeof(id->coreaudio))) {
+                return false;
+            }
+            strcpy(id->coreaudio, value);
+            return true;
+        case ma_backend_pulseaudio:
+            if (!PV_RECORDER_IS_PREFIX("pulseaudio") || (strlen(value) >= sizeof(id->pulse))) {
+                return false;
+            }
+            strcpy(id->pulse, value);
+            return true;
+        case ma_backend_alsa:
+            if (!PV_RECORDER_IS_PREFIX("alsa") || (strlen(value) >= sizeof(id->alsa))) {
+                return false;
+            }
+            strcpy(id->alsa, value);
+            return true;
+        case ma_backend_jack:
+            return PV_RECORDER_IS_PREFIX("jack") && (sscanf(value, "%d", &(id->jack)) == 1);
+        default:
+            return false;
+    }
+
+#undef PV_RECORDER_IS_PREFIX
+
+}
+
+/**
+ * Capture devices found by one enumeration, with their IDs formatted by `pv_recorder_device_id_to_string()`.
+ */
+typedef struct {
+    ma_device_info *devices;
+    char (*device_ids)[PV_RECORDER_DEVICE_ID_SIZE];
+    int32_t num_devices;
+    int32_t capacity;
+    bool is_out_of_memory;
+} pv_recorder_device_list_t;
+
+static ma_bool32 pv_recorder_enumerate_devices_callback(
+        ma_context *context,
+        ma_device_type device_type,
+        const ma_device_info *info,
+        void *user_data) {
+    if (device_type != ma_device_type_capture) {
+        return MA_TRUE;
+    }
+
+    pv_recorder_device_list_t *list = (pv_recorder_device_list_t *) user_data;
+    if (list->num_devices == list->capacity) {
+        const int32_t capacity = (list->capacity > 0) ? (2 * list->capacity) : 8;
+        ma_device_info *devices = realloc(list->devices, (size_t) capacity * sizeof(ma_device_info));
+        if (devices) {
+            list->devices = devices;
+        }
+        char (*device_ids)[PV_RECORDER_DEVICE_ID_SIZE] = realloc(
+                list->device_ids,
+                (size_t) capacity * sizeof(list->device_ids[0]));
+        if (device_ids) {
+            list->device_ids = device_ids;
+        }
+        if (!devices || !device_ids) {
+            list->is_out_of_memory = true;
+            return MA_FALSE;
+        }
+        list->capacity = capacity;
+    }
+
+    list->devices[list->num_devices] = *info;
+    pv_recorder_device_id_to_string(context->backend, info, list->device_ids[list->num_devices]);
+    list->num_devices++;
+
+    return MA_TRUE;
+}
+
+/**
+ * Enumerates capture devices into the cache. Creates a context for the duration of the call if no recorder holds one.
+ * Enumeration can block on the audio server, so `shared_context_lock` is only taken to reference the context and to
+ * publish the list. Must be called without `shared_context_lock` held.
+ */
+static pv_recorder_status_t pv_recorder_update_device_cache(void) {
+    pv_recorder_static_mutex_lock(&shared_context_lock);
+    ma_result result = pv_recorder_shared_context_acquire_locked();
+    pv_recorder_static_mutex_unlock(&shared_context_lock);
+    if (result != MA_SUCCESS) {
+        return ma_result_to_pv_recorder_status(result);
+    }
+
+    // The reference keeps the context alive, and `pv_recorder_set_backends()` cannot replace it while it is held.
+    // Enumeration with a callback, unlike `ma_context_get_devices()`, does not return a list owned by the context, so
+    // concurrent enumerations do not overwrite each other's results.
+    pv_recorder_device_list_t list;
+    memset(&list, 0, sizeof(list));
+    result = ma_context_enumerate_devices(&(shared_context.context), pv_recorder_enumerate_devices_callback, &list);
+
+    pv_recorder_status_t status = PV_RECORDER_STATUS_SUCCESS;
+    if (list.is_out_of_memory) {
+        status = PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    } else if (result != MA_SUCCESS) {
+        status = (result == MA_OUT_OF_MEMORY) ? PV_RECORDER_STATUS_OUT_OF_MEMORY : PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    pv_recorder_static_mutex_lock(&shared_context_lock);
+
+    if (status == PV_RECORDER_STATUS_SUCCESS) {
+        // Only the IDs and names are compared, since the rest of the device info is not guaranteed to be stable.
+        bool is_changed = list.num_devices != shared_context.num_devices;
+        for (int32_t i = 0; !is_changed && (i < list.num_devices); i++) {
+            is_changed = (strcmp(list.device_ids[i], shared_context.device_ids[i]) != 0) ||
+                         (strcmp(list.devices[i].name, shared_context.devices[i].name) != 0);
+        }
+        if (is_changed) {
+            shared_context.device_list_version++;
+        }
+
+        free(shared_context.devices);
+        free(shared_context.device_ids);
+        shared_context.devices = list.devices;
+        shared_context.device_ids = list.device_ids;
+        shared_context.num_devices = list.num_devices;
+        shared_context.is_device_cache_valid = true;
+        shared_context.device_cache_backend = shared_context.context.backend;
+    }
+    pv_recorder_shared_context_release_locked();
+
+    pv_recorder_static_mutex_unlock(&shared_context_lock);
+
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        free(list.devices);
+        free(list.device_ids);
+    }
+
+    return status;
+}
+
+/**
+ * Takes `shared_context_lock` with a valid device cache, enumerating first if there is none. The lock is only held on
+ * success.
+ */
+static pv_recorder_status_t pv_recorder_lock_device_cache(void) {
+    pv_recorder_static_mutex_lock(&shared_context_lock);
+    while (!shared_context.is_device_cache_valid) {
+        pv_recorder_static_mutex_unlock(&shared_context_lock);
+        pv_recorder_status_t status = pv_recorder_update_device_cache();
+        if (status != PV_RECORDER_STATUS_SUCCESS) {
+            return status;
+        }
+        pv_recorder_static_mutex_lock(&shared_context_lock);
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_options_t pv_recorder_options_init(void) {
+    pv_recorder_options_t options;
+    memset(&options, 0, sizeof(options));
+    options.sample_rate = PV_RECORDER_SAMPLE_RATE;
+    options.num_channels = 1;
+    options.sample_format = PV_RECORDER_SAMPLE_FORMAT_S16;
+    return options;
+}
+
+PV_API pv_recorder_status_t pv_recorder_init(
+        int32_t frame_length,
+        int32_t device_index,
+        int32_t buffered_frames_count,
+        pv_recorder_t **object) {
+    const pv_recorder_options_t options = pv_recorder_options_init();
+    return pv_recorder_init_ex(frame_length, device_index, buffered_frames_count, &options, object);
+}
+
+PV_API pv_recorder_status_t pv_recorder_init_ex(
+        int32_t frame_length,
+        int32_t device_index,
+        int32_t buffered_frames_count,
+        const pv_recorder_options_t *options,
+        pv_recorder_t **object) {
+    if (device_index < PV_RECORDER_DEFAULT_DEVICE_INDEX) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (frame_length <= 0) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (buffered_frames_count < 1) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!options) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (options->sample_rate < 0) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((options->num_channels < 0) || (options->num_channels > MA_MAX_CHANNELS)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (pv_recorder_sample_format_to_ma_format(options->sample_format) == ma_format_unknown) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (options->history_ms < 0) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (options->device_id && (device_index != PV_RECORDER_DEFAULT_DEVICE_INDEX)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((options->performance_profile != PV_RECORDER_PERFORMANCE_PROFILE_LOW_LATENCY) &&
+        (options->performance_profile != PV_RECORDER_PERFORMANCE_PROFILE_CONSERVATIVE)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((options->period_length < 0) || (options->num_periods < 0)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((options->thread_scheduling < PV_RECORDER_THREAD_SCHEDULING_DEFAULT) ||
+        (options->thread_scheduling > PV_RECORDER_THREAD_SCHEDULING_RR)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((options->thread_priority < 0) || (options->thread_priority > 99)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (options->trace_log_length < 0) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((options->resampler < PV_RECORDER_RESAMPLER_DEFAULT) ||
+        (options->resampler > PV_RECORDER_RESAMPLER_POLYPHASE_HIGH)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    // At the device's native rate a frame is generally not a whole number of device samples, e.g. 1411.2 for 512
+    // samples at 16kHz captured at 44.1kHz, so no period can complete whole frames.
+    if (options->is_period_aligned_to_frame && (options->resampler != PV_RECORDER_RESAMPLER_DEFAULT) &&
+        (options->sample_rate != 0)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    *object = NULL;
+
+    pv_recorder_t *o = calloc(1, sizeof(pv_recorder_t));
+    if (!o) {
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+
+    o->event_fd = -1;
+    o->thread_scheduling = options->thread_scheduling;
+    o->thread_priority = options->thread_priority;
+    o->thread_cpu_mask = options->thread_cpu_mask;
+
+    ma_result result = pv_recorder_shared_context_acquire(&(o->context));
+    if (result != MA_SUCCESS) {
+        pv_recorder_delete(o);
+        return ma_result_to_pv_recorder_status(result);
+    }
+
+    o->device_config = ma_device_config_init(ma_device_type_capture);
+    o->device_config.capture.format = pv_recorder_sample_format_to_ma_format(options->sample_format);
+    o->device_config.capture.channels = (ma_uint32) options->num_channels;
+    o->device_config.sampleRate = (ma_uint32) options->sample_rate;
+    if (options->performance_profile == PV_RECORDER_PERFORMANCE_PROFILE_CONSERVATIVE) {
+        o->device_config.performanceProfile = ma_performance_profile_conservative;
+    } else {
+        o->device_config.performanceProfile = ma_performance_profile_low_latency;
+    }
+    o->device_config.periods = (ma_uint32) options->num_periods;
+
+    // miniaudio calls back with exactly `periodSizeInFrames` at the requested rate, so a multiple of `frame_length`
+    // completes whole frames in every callback.
+    int32_t period_length = options->period_length;
+    if (options->is_period_aligned_to_frame) {
+        const int32_t num_frames_per_period = (period_length + (frame_length / 2)) / frame_length;
+        period_length = ((num_frames_per_period > 0) ? num_frames_per_period : 1) * frame_length;
+    }
+    o->device_config.periodSizeInFrames = (ma_uint32) period_length;
+
+    // With a polyphase resampler the device runs at its native rate, which is only known once it is open, so the
+    // period is requested as a duration. Audio is captured as `float`, which the resampler works in.
+    o->is_native_rate_capture = (options->resampler != PV_RECORDER_RESAMPLER_DEFAULT) && (options->sample_rate != 0);
+    if (o->is_native_rate_capture) {
+        o->device_config.sampleRate = 0;
+        o->device_config.capture.format = ma_format_f32;
+        if (period_length > 0) {
+            const int32_t period_ms = (int32_t) ((((int64_t) period_length * 1000) + (options->sample_rate / 2)) /
+                                                 options->sample_rate);
+            o->device_config.periodSizeInMilliseconds = (ma_uint32) ((period_ms > 0) ? period_ms : 1);
+            o->device_config.periodSizeInFrames = 0;
+        }
+    }
+    o->device_config.dataCallback = pv_recorder_ma_callback;
+    o->device_config.notificationCallback = pv_recorder_ma_notification_callback;
+    o->device_config.pUserData = o;
+
+    if (options->device_id) {
+        pv_recorder_status_t status = PV_RECORDER_STATUS_SUCCESS;
+        if (!pv_recorder_device_id_from_string(o->context->backend, options->device_id, &(o->device_id))) {
+            status = pv_recorder_lock_device_cache();
+            if (status == PV_RECORDER_STATUS_SUCCESS) {
+                int32_t index = shared_context.num_devices;
+                for (int32_t i = 0; i < shared_context.num_devices; i++) {
+                    if (strcmp(shared_context.device_ids[i], options->device_id) == 0) {
+                        index = i;
+                        break;
+                    }
+                }
+                if (index == shared_context.num_devices) {
+                    status = PV_RECORDER_STATUS_INVALID_ARGUMENT;
+                } else {
+                    o->device_id = shared_context.devices[index].id;
+                }
+                pv_recorder_static_mutex_unlock(&shared_context_lock);
+            }
+        }
+
+        if (status != PV_RECORDER_STATUS_SUCCESS) {
+            pv_recorder_delete(o);
+            return status;
+        }
+        o->device_config.capture.pDeviceID = &(o->device_id);
+    } else if (device_index != PV_RECORDER_DEFAULT_DEVICE_INDEX) {
+        pv_recorder_status_t status = pv_recorder_lock_device_cache();
+        if (status == PV_RECORDER_STATUS_SUCCESS) {
+            if (device_index >= shared_context.num_devices) {
+                status = PV_RECORDER_STATUS_INVALID_ARGUMENT;
+            } else {
+                o->device_id = shared_context.devices[device_index].id;
+            }
+            pv_recorder_static_mutex_unlock(&shared_context_lock);
+        }
+
+        if (status != PV_RECORDER_STATUS_SUCCESS) {
+            pv_recorder_delete(o);
+            return status;
+        }
+        o->device_config.capture.pDeviceID = &(o->device_id);
+    }
+
+    result = ma_event_init(&(o->frame_event));
+    if (result != MA_SUCCESS) {
+        pv_recorder_delete(o);
+        return ma_result_to_pv_recorder_status(result);
+    }
+    o->is_frame_event_initialized = true;
+
+#if defined(PV_RECORDER_EVENT_FD)
+
+    o->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (o->event_fd < 0) {
+        pv_recorder_delete(o);
+        return PV_RECORDER_STATUS_RUNTIME_ERROR;
+    }
+    pv_recorder_signal_event_fd(o);
+
+#endif
+
+    result = ma_device_init(o->context, &(o->device_config), &(o->device));
+    if (result != MA_SUCCESS) {
+        pv_recorder_delete(o);
+        return ma_result_to_pv_recorder_status(result);
+    }
+
+    // A value of 0 in the options resolves to the device's native configuration.
+    o->sample_rate = o->is_native_rate_capture ? options->sample_rate : (int32_t) o->device.sampleRate;
+    o->num_channels = (int32_t) o->device.capture.channels;
+    o->sample_format = options->sample_format;
+    o->bytes_per_frame = pv_recorder_sample_format_size(o->sample_format) * o->num_channels;
+
+    if (o->is_native_rate_capture) {
+        int32_t max_output_frames = RESAMPLER_CHUNK_FRAMES;
+        if ((int32_t) o->device.sampleRate != o->sample_rate) {
+            const pv_resampler_status_t resampler_status = pv_resampler_init(
+                    (int32_t) o->device.sampleRate,
+                    o->sample_rate,
+                    o->num_channels,
+                    RESAMPLER_CHUNK_FRAMES,
+                    (pv_resampler_quality_t) (options->resampler - PV_RECORDER_RESAMPLER_POLYPHASE_LOW),
+                    &(o->resampler));
+            if (resampler_status != PV_RESAMPLER_STATUS_SUCCESS) {
+                pv_recorder_delete(o);
+                return (resampler_status == PV_RESAMPLER_STATUS_OUT_OF_MEMORY) ?
+                        PV_RECORDER_STATUS_OUT_OF_MEMORY :
+                        PV_RECORDER_STATUS_INVALID_ARGUMENT;
+            }
+            max_output_frames = pv_resampler_get_max_output_frames(o->resampler);
+            o->resampled = malloc((size_t) max_output_frames * (size_t) o->num_channels * sizeof(float));
+            if (!(o->resampled)) {
+                pv_recorder_delete(o);
+                return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+            }
+        }
+        if (o->sample_format != PV_RECORDER_SAMPLE_FORMAT_F32) {
+            o->conversion_buffer = malloc((size_t) max_output_frames * (size_t) o->num_channels * sizeof(int32_t));
+            if (!(o->conversion_buffer)) {
+                pv_recorder_delete(o);
+                return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+            }
+        }
+    }
+
+    const int32_t buffer_capacity = frame_length * buffered_frames_count;
+    const int64_t history_length = (((int64_t) options->history_ms * o->sample_rate) + 999) / 1000;
+    if (history_length > (INT32_MAX - buffer_capacity)) {
+        pv_recorder_delete(o);
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    o->history_length = (int32_t) history_length;
+
+    pv_circular_buffer_status_t status = pv_circular_buffer_init_with_history(
+            buffer_capacity,
+            o->history_length,
+            o->bytes_per_frame,
+            &(o->buffer));
+
+    if (status != PV_CIRCULAR_BUFFER_STATUS_SUCCESS) {
+        pv_recorder_delete(o);
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+
+    if (options->trace_log_length > 0) {
+        if (pv_trace_log_init(options->trace_log_length, &(o->trace_log)) != PV_TRACE_LOG_STATUS_SUCCESS) {
+            pv_recorder_delete(o);
+            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+        }
+    }
+
+    o->peek_copy = malloc((size_t) frame_length * (size_t) o->bytes_per_frame);
+    if (!(o->peek_copy)) {
+        pv_recorder_delete(o);
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+
+    if ((o->sample_format == PV_RECORDER_SAMPLE_FORMAT_S24_32) && !(o->is_native_rate_capture)) {
+        o->conversion_buffer = malloc(CONVERSION_BUFFER_SIZE * sizeof(int32_t));
+        if (!(o->conversion_buffer)) {
+            pv_recorder_delete(o);
+            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+        }
+    }
+
+    o->frame_length = frame_length;
+    o->buffered_frames_count = buffered_frames_count;
+
+    *object = o;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API void pv_recorder_delete(pv_recorder_t *object) {
+    if (object) {
+        if (object->has_consumer_thread) {
+            ma_device_stop(&(object->device));
+            pv_recorder_join_consumer_thread(object);
+        }
+        ma_device_uninit(&(object->device));
+        if (object->context) {
+            pv_recorder_shared_context_release();
+        }
+        for (int32_t i = 0; i < object->num_subscribers; i++) {
+            ma_event_uninit(&(object->subscribers[i]->event));
+            free(object->subscribers[i]);
+        }
+        pv_recorder_free_output_chain(object);
+        for (int32_t i = 0; i < object->num_outputs; i++) {
+            pv_recorder_free_output(object->outputs[i]);
+        }
+        pv_recorder_free_workers(object);
+        if (object->is_frame_event_initialized) {
+            ma_event_uninit(&(object->frame_event));
+        }
+#if defined(PV_RECORDER_EVENT_FD)
+
+        if (object->event_fd >= 0) {
+            close(object->event_fd);
+        }
+
+#endif
+        pv_circular_buffer_delete(object->buffer);
+        free(object->peek_copy);
+        free(object->conversion_buffer);
+        pv_resampler_delete(object->resampler);
+        free(object->resampled);
+        free(object->vad_gate.decisions);
+        pv_trace_log_delete(object->trace_log);
+        free(object);
+    }
+}
+
+PV_API pv_recorder_status_t pv_recorder_start(pv_recorder_t *object) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (ma_device_is_started(&(object->device))) {
+        return PV_RECORDER_STATUS_SUCCESS;
+    }
+
+    // Frames are counted from here, so the reader discards any partial frame left from an earlier recording.
+    const uint64_t write_position = pv_circular_buffer_get_write_position(object->buffer);
+    __atomic_store_n(&object->discard_position, write_position, __ATOMIC_RELEASE);
+
+    if (object->is_vad_gate_enabled) {
+        // Only the callback's side of the gate is reset, which is published by starting the device. The reader may
+        // still be using `release_end`, `decided_end` and `decisions`.
+        pv_recorder_vad_gate_t *gate = &object->vad_gate;
+        gate->origin = write_position;
+        gate->num_frames = 0;
+        gate->frame_sum_squares = 0.;
+        gate->frame_fill = 0;
+        gate->noise_floor_db = 0.;
+        gate->is_open = false;
+        gate->hangover_remaining = 0;
+    }
+
+    for (int32_t i = 0; i < object->num_subscribers; i++) {
+        __atomic_store_n(&object->subscribers[i]->discard_position, write_position, __ATOMIC_RELEASE);
+    }
+    pv_recorder_reset_outputs(object, write_position);
+    pv_recorder_reset_work_queue(object, write_position);
+
+    if (object->resampler) {
+        // The history from an earlier recording would otherwise be blended into the first output frames.
+        pv_resampler_reset(object->resampler);
+    }
+
+    const bool is_thread_config_requested = (object->thread_scheduling != PV_RECORDER_THREAD_SCHEDULING_DEFAULT) ||
+                                            (object->thread_cpu_mask != 0);
+    const bool is_capture_thread_configurable = pv_recorder_is_capture_thread_configurable(object);
+    if (is_thread_config_requested) {
+        pv_recorder_thread_config_status_t *config_status = &object->thread_config_status;
+        const pv_recorder_thread_config_result_t pending = PV_RECORDER_THREAD_CONFIG_PENDING;
+        const pv_recorder_thread_config_result_t capture = is_capture_thread_configurable ?
+                pending :
+                PV_RECORDER_THREAD_CONFIG_UNSUPPORTED;
+        if (object->thread_scheduling != PV_RECORDER_THREAD_SCHEDULING_DEFAULT) {
+            __atomic_store_n(&config_status->capture_scheduling, capture, __ATOMIC_RELAXED);
+        }
+        if (object->thread_cpu_mask != 0) {
+            __atomic_store_n(&config_status->capture_affinity, capture, __ATOMIC_RELAXED);
+        }
+        if (object->frame_callback) {
+            __atomic_store_n(&config_status->consumer_scheduling, pending, __ATOMIC_RELAXED);
+            __atomic_store_n(&config_status->consumer_affinity, pending, __ATOMIC_RELAXED);
+        }
+    }
+    // Published to the audio thread by starting the device.
+    object->is_capture_thread_config_pending = is_thread_config_requested && is_capture_thread_configurable;
+
+    ma_result result = ma_device_start(&(object->device));
+    if (result != MA_SUCCESS) {
+        ma_device_uninit(&(object->device));
+
+        result = ma_device_init(object->context, &(object->device_config), &(object->device));
+        if (result != MA_SUCCESS) {
+            return ma_result_to_pv_recorder_status(result);
+        }
+
+        result = ma_device_start(&(object->device));
+        if (result != MA_SUCCESS) {
+            return ma_result_to_pv_recorder_status(result);
+        }
+    }
+
+    if (object->frame_callback) {
+        // The device may have been stopped by the backend, which ends the consumer thread without joining it.
+        pv_recorder_join_consumer_thread(object);
+
+        result = ma_thread_create(
+                &(object->consumer_thread),
+                ma_thread_priority_default,
+                0,
+                pv_recorder_consumer_thread,
+                object,
+                NULL);
+        if (result != MA_SUCCESS) {
+            ma_device_stop(&(object->device));
+            return ma_result_to_pv_recorder_status(result);
+        }
+        object->has_consumer_thread = true;
+    }
+
+    pv_recorder_update_event_fd(object);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_stop(pv_recorder_t *object) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (ma_device_is_started(&(object->device))) {
+        ma_result result = ma_device_stop(&(object->device));
+        if (result != MA_SUCCESS) {
+            return ma_result_to_pv_recorder_status(result);
+        }
+    }
+
+    __atomic_store_n(&object->is_reader_waiting, false, __ATOMIC_RELAXED);
+    ma_event_signal(&object->frame_event);
+    pv_recorder_wake_subscribers(object);
+
+    pv_recorder_join_consumer_thread(object);
+
+    // The device is stopped, so the write position is final. The reader discards up to it on its next call.
+    const uint64_t write_position = pv_circular_buffer_get_write_position(object->buffer);
+    __atomic_store_n(&object->discard_position, write_position, __ATOMIC_RELEASE);
+    for (int32_t i = 0; i < object->num_subscribers; i++) {
+        __atomic_store_n(&object->subscribers[i]->discard_position, write_position, __ATOMIC_RELEASE);
+    }
+    pv_recorder_reset_work_queue(object, write_position);
+    for (int32_t i = 0; i < object->num_outputs; i++) {
+        pv_recorder_output_t *output = object->outputs[i];
+        __atomic_store_n(
+                &output->discard_position,
+                pv_circular_buffer_get_write_position(output->buffer),
+                __ATOMIC_RELEASE);
+    }
+    pv_recorder_update_event_fd(object);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_read(pv_recorder_t *object, int16_t *frame) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!frame) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->frame_callback) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (object->sample_format != PV_RECORDER_SAMPLE_FORMAT_S16) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (!ma_device_is_started(&object->device)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (pv_recorder_is_peeked(object)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    pv_recorder_status_t status = pv_recorder_wait_for_frame(object);
+    if (status == PV_RECORDER_STATUS_INVALID_STATE) {
+        // Stopping while a read is blocked has always succeeded, so existing callers get a frame of silence.
+        memset(frame, 0, (size_t) object->frame_length * sizeof(int16_t));
+        return PV_RECORDER_STATUS_SUCCESS;
+    } else if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
+
+    pv_circular_buffer_read(object->buffer, frame, object->frame_length);
+    pv_recorder_update_event_fd(object);
+    pv_recorder_record_read_latency(object, pv_circular_buffer_get_read_position(object->buffer));
+    pv_recorder_report_warnings(object);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_read_pcm(pv_recorder_t *object, void *pcm) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!pcm) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->frame_callback) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (!ma_device_is_started(&object->device)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (pv_recorder_is_peeked(object)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    pv_recorder_status_t status = pv_recorder_wait_for_frame(object);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
+
+    pv_circular_buffer_read(object->buffer, pcm, object->frame_length);
+    pv_recorder_update_event_fd(object);
+    pv_recorder_record_read_latency(object, pv_circular_buffer_get_read_position(object->buffer));
+
+    pv_recorder_report_warnings(object);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+/**
+ * Gets the next frame for a read that transforms it while copying it out. The frame is used in place, unless it
+ * straddles the end of a ring that is not mirrored in memory. Must be followed by `pv_recorder_end_transform_read()`.
+ */
+static const void *pv_recorder_begin_transform_read(pv_recorder_t *object, bool *is_peeked) {
+    const void *frame = NULL;
+    *is_peeked = (pv_circular_buffer_peek(object->buffer, &frame, object->frame_length) == object->frame_length);
+    if (!*is_peeked) {
+        pv_circular_buffer_read(object->buffer, object->peek_copy, object->frame_length);
+        frame = object->peek_copy;
+    }
+    return frame;
+}
+
+static void pv_recorder_end_transform_read(pv_recorder_t *object, bool is_peeked) {
+    if (is_peeked) {
+        pv_circular_buffer_commit(object->buffer, object->frame_length);
+    }
+    pv_recorder_update_event_fd(object);
+    pv_recorder_record_read_latency(object, pv_circular_buffer_get_read_position(object->buffer));
+
+    pv_recorder_report_warnings(object);
+}
+
+PV_API pv_recorder_status_t pv_recorder_read_float(pv_recorder_t *object, float *pcm) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!pcm) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->sample_format == PV_RECORDER_SAMPLE_FORMAT_F32) {
+        return pv_recorder_read_pcm(object, pcm);
+    }
+    if (object->frame_callback) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (!ma_device_is_started(&object->device)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (pv_recorder_is_peeked(object)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    pv_recorder_status_t status = pv_recorder_wait_for_frame(object);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
+
+    bool is_peeked = false;
+    const void *frame = pv_recorder_begin_transform_read(object, &is_peeked);
+
+    const int32_t num_samples = object->frame_length * object->num_channels;
+    switch (object->sample_format) {
+        case PV_RECORDER_SAMPLE_FORMAT_S24_32:
+            pv_sample_converter_s32_to_f32(frame, num_samples, 24, pcm);
+            break;
+        case PV_RECORDER_SAMPLE_FORMAT_S32:
+            pv_sample_converter_s32_to_f32(frame, num_samples, 32, pcm);
+            break;
+        default:
+            pv_sample_converter_s16_to_f32(frame, num_samples, pcm);
+            break;
+    }
+
+    pv_recorder_end_transform_read(object, is_peeked);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_read_planar(
+        pv_recorder_t *object,
+        const int32_t *channels,
+        int32_t num_selected_channels,
+        void **pcm) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!pcm) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((num_selected_channels <= 0) || (num_selected_channels > object->num_channels)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    void *outputs[MA_MAX_CHANNELS];
+    memset(outputs, 0, sizeof(outputs));
+    for (int32_t i = 0; i < num_selected_channels; i++) {
+        const int32_t channel = channels ? channels[i] : i;
+        if ((channel < 0) || (channel >= object->num_channels) || outputs[channel] || !pcm[i]) {
+            return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+        }
+        outputs[channel] = pcm[i];
+    }
+
+    if (object->frame_callback) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (!ma_device_is_started(&object->device)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (pv_recorder_is_peeked(object)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    pv_recorder_status_t status = pv_recorder_wait_for_frame(object);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
+
+    bool is_peeked = false;
+    const void *frame = pv_recorder_begin_transform_read(object, &is_peeked);
+    pv_sample_converter_deinterleave(
+            frame,
+            object->frame_length,
+            object->num_channels,
+            pv_recorder_sample_format_size(object->sample_format),
+            outputs);
+    pv_recorder_end_transform_read(object, is_peeked);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_read_with_info(
+        pv_recorder_t *object,
+        int16_t *frame,
+        pv_recorder_frame_info_t *info) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!frame) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!info) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->frame_callback) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (object->sample_format != PV_RECORDER_SAMPLE_FORMAT_S16) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (!ma_device_is_started(&object->device)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (pv_recorder_is_peeked(object)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    pv_recorder_status_t status = pv_recorder_wait_for_frame(object);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
+
+    pv_circular_buffer_read(object->buffer, frame, object->frame_length);
+    pv_recorder_update_event_fd(object);
+
+    const uint64_t sample_index =
+            pv_circular_buffer_get_read_position(object->buffer) - (uint64_t) object->frame_length;
+    const uint64_t dropped_count = pv_circular_buffer_get_dropped_count(object->buffer);
+
+    info->timestamp_ns = pv_recorder_get_sample_time_ns(object, sample_index);
+    info->sample_index = sample_index;
+    info->dropped_samples = dropped_count - object->reported_dropped_count;
+    object->reported_dropped_count = dropped_count;
+
+    pv_recorder_record_read_latency(object, pv_circular_buffer_get_read_position(object->buffer));
+
+    pv_recorder_report_warnings(object);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_read_frames(
+        pv_recorder_t *object,
+        int16_t *pcm,
+        int32_t num_frames,
+        bool wait_for_all_frames,
+        int32_t *num_frames_read) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!pcm) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((num_frames <= 0) || (num_frames > object->buffered_frames_count)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    // A full buffer is only reached when the audio callback overwrites unread audio, so waiting for one would always
+    // return audio after an overflow.
+    if (wait_for_all_frames && (object->buffered_frames_count > 1) && (num_frames == object->buffered_frames_count)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!num_frames_read) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->frame_callback) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (object->sample_format != PV_RECORDER_SAMPLE_FORMAT_S16) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (!ma_device_is_started(&object->device)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (pv_recorder_is_peeked(object)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    *num_frames_read = 0;
+
+    if (object->is_vad_gate_enabled) {
+        // Released frames need not be contiguous in the buffer, so they are taken one at a time.
+        while (*num_frames_read < num_frames) {
+            if ((*num_frames_read > 0) && !wait_for_all_frames &&
+                !((pv_circular_buffer_get_count(object->buffer) >= object->frame_length) &&
+                  pv_recorder_is_released(object))) {
+                break;
+            }
+
+            pv_recorder_status_t status = pv_recorder_wait_for_frame(object);
+            if (status != PV_RECORDER_STATUS_SUCCESS) {
+                return (*num_frames_read > 0) ? PV_RECORDER_STATUS_SUCCESS : status;
+            }
+
+            pv_circular_buffer_read(
+                    object->buffer,
+                    pcm + ((*num_frames_read) * object->frame_length),
+                    object->frame_length);
+            (*num_frames_read)++;
+        }
+
+        pv_recorder_update_event_fd(object);
+        pv_recorder_record_read_latency(object, pv_circular_buffer_get_read_position(object->buffer));
+        pv_recorder_report_warnings(object);
+
+        return PV_RECORDER_STATUS_SUCCESS;
+    }
+
+    const int32_t num_samples = wait_for_all_frames ? (num_frames * object->frame_length) : object->frame_length;
+    pv_recorder_status_t status = pv_recorder_wait_for_aligned_samples(object, num_samples);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
+
+    int32_t available_frames = pv_circular_buffer_get_count(object->buffer) / object->frame_length;
+    if (available_frames > num_frames) {
+        available_frames = num_frames;
+    }
+
+    const int32_t length = pv_circular_buffer_read(object->buffer, pcm, available_frames * object->frame_length);
+    *num_frames_read = length / object->frame_length;
+    pv_recorder_update_event_fd(object);
+    pv_recorder_record_read_latency(object, pv_circular_buffer_get_read_position(object->buffer));
+
+    pv_recorder_report_warnings(object);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_peek(pv_recorder_t *object, const int16_t **frame) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!frame) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->frame_callback) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (object->sample_format != PV_RECORDER_SAMPLE_FORMAT_S16) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (!ma_device_is_started(&object->device)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    pv_recorder_apply_discard(object);
+    if (object->peeked_frame) {
+        *frame = object->peeked_frame;
+        return PV_RECORDER_STATUS_SUCCESS;
+    }
+
+    pv_recorder_status_t status = pv_recorder_wait_for_frame(object);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
+
+    const void *peeked = NULL;
+    const int32_t length = pv_circular_buffer_peek(object->buffer, &peeked, object->frame_length);
+    uint64_t end_position = 0;
+    if (length == object->frame_length) {
+        object->peeked_frame = (const int16_t *) peeked;
+        end_position = pv_circular_buffer_get_read_position(object->buffer) + (uint64_t) object->frame_length;
+    } else {
+        // The frame straddles the end of a ring that is not mirrored in memory.
+        pv_circular_buffer_read(object->buffer, object->peek_copy, object->frame_length);
+        object->peeked_frame = object->peek_copy;
+        end_position = pv_circular_buffer_get_read_position(object->buffer);
+    }
+
+    pv_recorder_record_read_latency(object, end_position);
+
+    pv_recorder_report_warnings(object);
+
+    *frame = object->peeked_frame;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_release(pv_recorder_t *object) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    // A frame peeked before a stop is gone.
+    pv_recorder_apply_discard(object);
+    if (!object->peeked_frame) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    const bool is_copy = (object->peeked_frame == object->peek_copy);
+    object->peeked_frame = NULL;
+    if (is_copy) {
+        pv_recorder_update_event_fd(object);
+        return PV_RECORDER_STATUS_SUCCESS;
+    }
+
+    pv_circular_buffer_status_t status = pv_circular_buffer_commit(object->buffer, object->frame_length);
+    pv_recorder_update_event_fd(object);
+    if (status != PV_CIRCULAR_BUFFER_STATUS_SUCCESS) {
+        return PV_RECORDER_STATUS_IO_ERROR;
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_read_history(pv_recorder_t *object, int16_t *pcm, int32_t num_samples) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!pcm) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((num_samples <= 0) || (num_samples > object->history_length)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->sample_format != PV_RECORDER_SAMPLE_FORMAT_S16) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    pv_recorder_apply_discard(object);
+    const int32_t length = pv_circular_buffer_read_history(object->buffer, pcm, num_samples);
+    if (length < num_samples) {
+        memset(pcm, 0, (size_t) (num_samples - length) * (size_t) object->bytes_per_frame);
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_subscribe(
+        pv_recorder_t *object,
+        int32_t frame_length,
+        pv_recorder_subscriber_t **subscriber) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((frame_length <= 0) || (frame_length > (object->frame_length * object->buffered_frames_count))) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!subscriber) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (ma_device_is_started(&object->device)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (object->num_subscribers == PV_RECORDER_MAX_SUBSCRIBERS) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    *subscriber = NULL;
+
+    pv_recorder_subscriber_t *o = calloc(1, sizeof(pv_recorder_subscriber_t));
+    if (!o) {
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+
+    ma_result result = ma_event_init(&(o->event));
+    if (result != MA_SUCCESS) {
+        free(o);
+        return ma_result_to_pv_recorder_status(result);
+    }
+
+    o->recorder = object;
+    o->frame_length = frame_length;
+    o->position = pv_circular_buffer_get_write_position(object->buffer);
+    o->discard_position = o->position;
+    o->applied_discard_position = o->position;
+
+    object->subscribers[object->num_subscribers] = o;
+    object->num_subscribers++;
+
+    *subscriber = o;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_unsubscribe(pv_recorder_subscriber_t *subscriber) {
+    if (!subscriber) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    pv_recorder_t *object = subscriber->recorder;
+    if (ma_device_is_started(&object->device)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    for (int32_t i = 0; i < object->num_subscribers; i++) {
+        if (object->subscribers[i] == subscriber) {
+            object->subscribers[i] = object->subscribers[object->num_subscribers - 1];
+            object->num_subscribers--;
+            break;
+        }
+    }
+
+    ma_event_uninit(&(subscriber->event));
+    free(subscriber);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_subscriber_read(pv_recorder_subscriber_t *subscriber, int16_t *frame) {
+    if (!subscriber) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!frame) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    pv_recorder_t *object = subscriber->recorder;
+    if (object->sample_format != PV_RECORDER_SAMPLE_FORMAT_S16) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    while (true) {
+        const uint64_t discard_position = __atomic_load_n(&subscriber->discard_position, __ATOMIC_ACQUIRE);
+        if (discard_position != subscriber->applied_discard_position) {
+            if (subscriber->position < discard_position) {
+                __atomic_store_n(&subscriber->position, discard_position, __ATOMIC_RELEASE);
+            }
+            subscriber->applied_discard_position = discard_position;
+        }
+        if (!ma_device_is_started(&object->device)) {
+            return PV_RECORDER_STATUS_INVALID_STATE;
+        }
+        if (pv_circular_buffer_get_count_at(object->buffer, &subscriber->position) >= subscriber->frame_length) {
+            break;
+        }
+
+        // Same handshake as `pv_recorder_wait_for_event()`, with the subscriber's own flag and event.
+        __atomic_store_n(&subscriber->is_waiting, true, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if ((pv_circular_buffer_get_count_at(object->buffer, &subscriber->position) >= subscriber->frame_length) ||
+            !ma_device_is_started(&object->device)) {
+            __atomic_store_n(&subscriber->is_waiting, false, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (ma_event_wait(&subscriber->event) != MA_SUCCESS) {
+            return PV_RECORDER_STATUS_IO_ERROR;
+        }
+    }
+
+    const uint64_t position = subscriber->position;
+    const int32_t length = pv_circular_buffer_read_at(
+            object->buffer,
+            &subscriber->position,
+            frame,
+            subscriber->frame_length);
+
+    const uint64_t dropped_samples = (subscriber->position - position) - (uint64_t) length;
+    if (dropped_samples > 0) {
+        __atomic_store_n(
+                &subscriber->dropped_samples,
+                subscriber->dropped_samples + dropped_samples,
+                __ATOMIC_RELAXED);
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_subscriber_get_dropped_samples(
+        pv_recorder_subscriber_t *subscriber,
+        uint64_t *dropped_samples) {
+    if (!subscriber) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!dropped_samples) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    *dropped_samples = __atomic_load_n(&subscriber->dropped_samples, __ATOMIC_RELAXED);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_add_output(
+        pv_recorder_t *object,
+        int32_t sample_rate,
+        int32_t frame_length,
+        pv_recorder_output_t **output) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((sample_rate <= 0) || (sample_rate > object->sample_rate)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((frame_length <= 0) || (frame_length > (INT32_MAX / object->buffered_frames_count))) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!output) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->sample_format != PV_RECORDER_SAMPLE_FORMAT_S16) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (ma_device_is_started(&object->device)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (object->num_outputs == PV_RECORDER_MAX_OUTPUTS) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    *output = NULL;
+
+    pv_recorder_output_t *o = calloc(1, sizeof(pv_recorder_output_t));
+    if (!o) {
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+
+    ma_result result = ma_event_init(&(o->event));
+    if (result != MA_SUCCESS) {
+        free(o);
+        return ma_result_to_pv_recorder_status(result);
+    }
+
+    o->recorder = object;
+    o->sample_rate = sample_rate;
+    o->frame_length = frame_length;
+
+    if (pv_circular_buffer_init(
+            frame_length * object->buffered_frames_count,
+            object->num_channels * (int32_t) sizeof(int16_t),
+            &(o->buffer)) != PV_CIRCULAR_BUFFER_STATUS_SUCCESS) {
+        pv_recorder_free_output(o);
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+
+    object->outputs[object->num_outputs] = o;
+    object->num_outputs++;
+
+    pv_recorder_status_t status = pv_recorder_configure_outputs(object);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        object->num_outputs--;
+        pv_recorder_free_output_chain(object);
+        pv_recorder_free_output(o);
+        // The chain for the remaining outputs was built before, so this only fails if memory ran out.
+        pv_recorder_configure_outputs(object);
+        return status;
+    }
+
+    *output = o;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_remove_output(pv_recorder_output_t *output) {
+    if (!output) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    pv_recorder_t *object = output->recorder;
+    if (ma_device_is_started(&object->device)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    pv_recorder_free_output_chain(object);
+    for (int32_t i = 0; i < object->num_outputs; i++) {
+        if (object->outputs[i] == output) {
+            object->outputs[i] = object->outputs[object->num_outputs - 1];
+            object->num_outputs--;
+            break;
+        }
+    }
+    pv_recorder_free_output(output);
+
+    return pv_recorder_configure_outputs(object);
+}
+
+PV_API pv_recorder_status_t pv_recorder_output_read(pv_recorder_output_t *output, int16_t *frame) {
+    if (!output) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!frame) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    pv_recorder_t *object = output->recorder;
+    while (true) {
+        const uint64_t discard_position = __atomic_load_n(&output->discard_position, __ATOMIC_ACQUIRE);
+        if (discard_position != output->applied_discard_position) {
+            pv_circular_buffer_discard_until(output->buffer, discard_position);
+            output->applied_discard_position = discard_position;
+        }
+        if (pv_circular_buffer_get_count(output->buffer) >= output->frame_length) {
+            break;
+        }
+        if (!ma_device_is_started(&object->device)) {
+            return PV_RECORDER_STATUS_INVALID_STATE;
+        }
+
+        // Same handshake as `pv_recorder_wait_for_event()`, with the output's own flag and event.
+        __atomic_store_n(&output->is_waiting, true, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if ((pv_circular_buffer_get_count(output->buffer) >= output->frame_length) ||
+            !ma_device_is_started(&object->device)) {
+            __atomic_store_n(&output->is_waiting, false, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (ma_event_wait(&output->event) != MA_SUCCESS) {
+            return PV_RECORDER_STATUS_IO_ERROR;
+        }
+    }
+
+    pv_circular_buffer_read(output->buffer, frame, output->frame_length);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_output_get_dropped_samples(
+        pv_recorder_output_t *output,
+        uint64_t *dropped_samples) {
+    if (!output) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!dropped_samples) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    *dropped_samples = pv_circular_buffer_get_dropped_count(output->buffer);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_set_num_workers(pv_recorder_t *object, int32_t num_workers) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((num_workers < 0) || (num_workers > PV_RECORDER_MAX_WORKERS)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (ma_device_is_started(&object->device)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    pv_recorder_free_workers(object);
+    if (num_workers == 0) {
+        return PV_RECORDER_STATUS_SUCCESS;
+    }
+
+    pv_recorder_work_queue_t *queue = &object->work_queue;
+    queue->workers = ma_aligned_malloc(sizeof(pv_recorder_worker_t) * (size_t) num_workers, 64, NULL);
+    if (!queue->workers) {
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+    memset(queue->workers, 0, sizeof(pv_recorder_worker_t) * (size_t) num_workers);
+
+    for (int32_t i = 0; i < num_workers; i++) {
+        ma_result result = ma_event_init(&(queue->workers[i].event));
+        if (result != MA_SUCCESS) {
+            pv_recorder_free_workers(object);
+            return ma_result_to_pv_recorder_status(result);
+        }
+        queue->num_workers = i + 1;
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_dequeue(
+        pv_recorder_t *object,
+        int32_t worker_id,
+        int16_t *frame,
+        uint64_t *sequence_number) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((worker_id < 0) || (worker_id >= object->work_queue.num_workers)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!frame) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!sequence_number) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->sample_format != PV_RECORDER_SAMPLE_FORMAT_S16) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    pv_recorder_work_queue_t *queue = &object->work_queue;
+    pv_recorder_worker_t *worker = &queue->workers[worker_id];
+    const uint64_t frame_length = (uint64_t) object->frame_length;
+    const uint64_t capacity = frame_length * (uint64_t) object->buffered_frames_count;
+
+    while (true) {
+        if (!ma_device_is_started(&object->device)) {
+            return PV_RECORDER_STATUS_INVALID_STATE;
+        }
+
+        uint64_t origin = 0;
+        uint64_t state = pv_recorder_load_work_queue_state(object, &origin);
+        const uint64_t generation_bits = state & ~PV_RECORDER_WORK_QUEUE_SEQUENCE_MASK;
+        const uint64_t write_position = pv_circular_buffer_get_write_position(object->buffer);
+        const uint64_t num_frames = (write_position - origin) / frame_length;
+
+        // Frames that were overwritten before anyone claimed them are skipped, which shows as a gap in the sequence.
+        uint64_t oldest = 0;
+        if ((write_position - origin) > capacity) {
+            oldest = ((write_position - origin - capacity) + frame_length - 1) / frame_length;
+        }
+
+        // The compare-and-swap fails once `stop` or `start` begins a new generation, and the claim starts over with the
+        // new origin.
+        uint64_t claimed = 0;
+        bool is_claimed = false;
+        while ((state & ~PV_RECORDER_WORK_QUEUE_SEQUENCE_MASK) == generation_bits) {
+            claimed = state & PV_RECORDER_WORK_QUEUE_SEQUENCE_MASK;
+            const uint64_t target = (claimed > oldest) ? claimed : oldest;
+            if (target >= num_frames) {
+                break;
+            }
+            if (__atomic_compare_exchange_n(
+                    &queue->state,
+                    &state,
+                    generation_bits | (target + 1),
+                    true,
+                    __ATOMIC_ACQ_REL,
+                    __ATOMIC_ACQUIRE)) {
+                claimed = target;
+                is_claimed = true;
+                break;
+            }
+        }
+
+        if (is_claimed) {
+            uint64_t position = origin + (claimed * frame_length);
+            const int32_t length = pv_circular_buffer_read_at(object->buffer, &position, frame, object->frame_length);
+            if ((length == object->frame_length) && (position == (origin + ((claimed + 1) * frame_length)))) {
+                *sequence_number = claimed;
+                return PV_RECORDER_STATUS_SUCCESS;
+            }
+
+            // The frame was overwritten while it was copied. Drop it and claim a newer one.
+            continue;
+        }
+        if ((state & ~PV_RECORDER_WORK_QUEUE_SEQUENCE_MASK) != generation_bits) {
+            continue;
+        }
+
+        // Same handshake as `pv_recorder_wait_for_event()`, with the worker's own flag and event.
+        __atomic_store_n(&worker->is_waiting, true, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if ((pv_recorder_get_num_unclaimed_frames(object) > 0) || !ma_device_is_started(&object->device)) {
+            __atomic_store_n(&worker->is_waiting, false, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (ma_event_wait(&worker->event) != MA_SUCCESS) {
+            return PV_RECORDER_STATUS_IO_ERROR;
+        }
+    }
+}
+
+PV_API pv_recorder_status_t pv_recorder_set_frame_callback(
+        pv_recorder_t *object,
+        pv_recorder_frame_callback_t frame_callback,
+        void *user_data) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (ma_device_is_started(&object->device)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+    if (frame_callback && (object->sample_format != PV_RECORDER_SAMPLE_FORMAT_S16)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    object->frame_callback = frame_callback;
+    object->frame_callback_user_data = user_data;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_get_fd(pv_recorder_t *object, int32_t *fd) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!fd) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+#if defined(PV_RECORDER_EVENT_FD)
+
+    *fd = (int32_t) object->event_fd;
+    return PV_RECORDER_STATUS_SUCCESS;
+
+#else
+
+    *fd = -1;
+    return PV_RECORDER_STATUS_INVALID_STATE;
+
+#endif
+}
+
+PV_API pv_recorder_status_t pv_recorder_get_stats(pv_recorder_t *object, pv_recorder_stats_t *stats) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!stats) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    const pv_recorder_callback_stats_t *callback_stats = &object->callback_stats;
+
+    stats->callback_count = __atomic_load_n(&callback_stats->callback_count, __ATOMIC_ACQUIRE);
+    stats->overflow_count = __atomic_load_n(&callback_stats->overflow_count, __ATOMIC_RELAXED);
+    stats->dropped_samples = __atomic_load_n(&callback_stats->dropped_samples, __ATOMIC_RELAXED) +
+                             __atomic_load_n(&object->realigned_samples, __ATOMIC_RELAXED);
+    stats->buffer_high_water_mark = __atomic_load_n(&callback_stats->buffer_high_water_mark, __ATOMIC_RELAXED);
+    stats->buffer_capacity = object->frame_length * object->buffered_frames_count;
+
+    stats->callback_duration_min_ns = __atomic_load_n(&callback_stats->callback_duration_min_ns, __ATOMIC_RELAXED);
+    stats->callback_duration_max_ns = __atomic_load_n(&callback_stats->callback_duration_max_ns, __ATOMIC_RELAXED);
+    stats->callback_duration_avg_ns = 0;
+    if (stats->callback_count > 0) {
+        const int64_t total_ns = __atomic_load_n(&callback_stats->callback_duration_total_ns, __ATOMIC_RELAXED);
+        stats->callback_duration_avg_ns = total_ns / (int64_t) stats->callback_count;
+    }
+
+    for (int32_t i = 0; i < PV_RECORDER_STATS_PERIOD_HISTOGRAM_SIZE; i++) {
+        stats->period_size_histogram[i] = __atomic_load_n(
+                &callback_stats->period_size_histogram[i],
+                __ATOMIC_RELAXED);
+    }
+    for (int32_t i = 0; i < PV_RECORDER_STATS_LATENCY_HISTOGRAM_SIZE; i++) {
+        stats->read_latency_histogram[i] = __atomic_load_n(&object->read_latency_histogram[i], __ATOMIC_RELAXED);
+    }
+
+    stats->num_gated_frames = __atomic_load_n(&object->vad_gate.num_gated_frames, __ATOMIC_RELAXED);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_vad_gate_options_t pv_recorder_vad_gate_options_init(void) {
+    pv_recorder_vad_gate_options_t options;
+    options.open_threshold_db = 9.f;
+    options.close_threshold_db = 5.f;
+    options.hangover_frames = 10;
+    options.pre_roll_frames = 3;
+    return options;
+}
+
+PV_API pv_recorder_status_t pv_recorder_set_vad_gate(
+        pv_recorder_t *object,
+        const pv_recorder_vad_gate_options_t *options) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (ma_device_is_started(&object->device)) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    if (!options) {
+        object->is_vad_gate_enabled = false;
+        return PV_RECORDER_STATUS_SUCCESS;
+    }
+
+    if ((options->close_threshold_db < 0.f) || (options->open_threshold_db < options->close_threshold_db)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (options->hangover_frames < 0) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((options->pre_roll_frames < 0) || (options->pre_roll_frames >= object->buffered_frames_count)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    pv_recorder_vad_gate_t *gate = &object->vad_gate;
+    if (!gate->decisions) {
+        gate->decisions = malloc((size_t) object->buffered_frames_count);
+        if (!gate->decisions) {
+            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+        }
+    }
+
+    const double frame_seconds = (double) object->frame_length / (double) object->sample_rate;
+    gate->options = *options;
+    gate->floor_rise = 1. - exp(-frame_seconds / VAD_GATE_FLOOR_RISE_SECONDS);
+    gate->floor_fall = 1. - exp(-frame_seconds / VAD_GATE_FLOOR_FALL_SECONDS);
+
+    // Wake the reader to discard rejected frames once half of the buffer beyond the pre-roll is decided.
+    int32_t drain_frames = (object->buffered_frames_count - options->pre_roll_frames) / 2;
+    if (drain_frames < 1) {
+        drain_frames = 1;
+    }
+    gate->drain_samples = (options->pre_roll_frames + drain_frames) * object->frame_length;
+
+    object->is_vad_gate_enabled = true;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_get_level(pv_recorder_t *object, pv_recorder_level_t *level) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!level) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    __atomic_load(&object->level_peak, &level->peak, __ATOMIC_RELAXED);
+    __atomic_load(&object->level_rms, &level->rms, __ATOMIC_RELAXED);
+    level->num_clipped_samples = __atomic_load_n(&object->num_clipped_samples, __ATOMIC_RELAXED);
+    level->is_muted = __atomic_load_n(&object->is_muted, __ATOMIC_RELAXED);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API void pv_recorder_set_debug_logging(
+        pv_recorder_t *object,
+        bool is_debug_logging_enabled) {
+    if (!object) {
+        return;
+    }
+
+    object->is_debug_logging_enabled = is_debug_logging_enabled;
+}
+
+PV_API pv_recorder_status_t pv_recorder_drain_trace_log(
+        pv_recorder_t *object,
+        pv_recorder_trace_event_t *events,
+        int32_t max_events,
+        int32_t *num_events,
+        uint64_t *num_lost_events) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!events) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (max_events < 0) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!num_events) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!num_lost_events) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!object->trace_log) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    pv_trace_log_event_t chunk[PV_RECORDER_TRACE_LOG_CHUNK_SIZE];
+
+    *num_events = 0;
+    *num_lost_events = 0;
+    while (*num_events < max_events) {
+        int32_t length = max_events - *num_events;
+        if (length > PV_RECORDER_TRACE_LOG_CHUNK_SIZE) {
+            length = PV_RECORDER_TRACE_LOG_CHUNK_SIZE;
+        }
+
+        uint64_t num_lost = 0;
+        const int32_t num_read = pv_trace_log_read(object->trace_log, chunk, length, &num_lost);
+        for (int32_t i = 0; i < num_read; i++) {
+            pv_recorder_trace_event_t *event = &events[*num_events + i];
+            event->timestamp_ns = chunk[i].timestamp_ns;
+            event->type = (pv_recorder_trace_event_type_t) chunk[i].type;
+            event->value = chunk[i].value;
+        }
+        *num_events += num_read;
+        *num_lost_events += num_lost;
+
+        if (num_read < length) {
+            break;
+        }
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+static void pv_recorder_write_trace_event(
+        FILE *file,
+        pv_recorder_trace_format_t format,
+        const pv_recorder_trace_event_t *event,
+        bool is_first) {
+    static const char *const NAMES[] = {
+            "callback_begin",
+            "callback_end",
+            "overflow",
+            "read"};
+
+    const char *name = NAMES[event->type];
+
+    if (format == PV_RECORDER_TRACE_FORMAT_CSV) {
+        fprintf(file, "%lld,%s,%lld\n", (long long) event->timestamp_ns, name, (long long) event->value);
+        return;
+    }
+
+    // Callbacks are shown as spans on the audio thread and reads as instants on the reader thread. Timestamps are in
+    // microseconds.
+    const double timestamp_us = (double) event->timestamp_ns / 1000.;
+    const char *separator = is_first ? "" : ",\n";
+    switch (event->type) {
+        case PV_RECORDER_TRACE_EVENT_CALLBACK_BEGIN:
+            fprintf(file,
+                    "%s{\"name\":\"callback\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":1,\"tid\":1,"
+                    "\"args\":{\"samples\":%lld}}",
+                    separator,
+                    timestamp_us,
+                    (long long) event->value);
+            break;
+        case PV_RECORDER_TRACE_EVENT_CALLBACK_END:
+            fprintf(file,
+                    "%s{\"name\":\"callback\",\"ph\":\"E\",\"ts\":%.3f,\"pid\":1,\"tid\":1,"
+                    "\"args\":{\"written\":%lld}}",
+                    separator,
+                    timestamp_us,
+                    (long long) event->value);
+            break;
+        default:
+            fprintf(file,
+                    "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%d,"
+                    "\"args\":{\"value\":%lld}}",
+                    separator,
+                    name,
+                    timestamp_us,
+                    (event->type == PV_RECORDER_TRACE_EVENT_READ) ? 2 : 1,
+                    (long long) event->value);
+            break;
+    }
+}
+
+static void pv_recorder_write_trace_lost_events(
+        FILE *file,
+        pv_recorder_trace_format_t format,
+        int64_t timestamp_ns,
+        uint64_t num_lost_events,
+        bool is_first) {
+    if (format == PV_RECORDER_TRACE_FORMAT_CSV) {
+        fprintf(file, "%lld,lost_events,%llu\n", (long long) timestamp_ns, (unsigned long long) num_lost_events);
+        return;
+    }
+
+    fprintf(file,
+            "%s{\"name\":\"lost_events\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":1,\"tid\":1,"
+            "\"args\":{\"count\":%llu}}",
+            is_first ? "" : ",\n",
+            (double) timestamp_ns / 1000.,
+            (unsigned long long) num_lost_events);
+}
+
+PV_API pv_recorder_status_t pv_recorder_write_trace_log(
+        pv_recorder_t *object,
+        const char *path,
+        pv_recorder_trace_format_t format) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!path) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((format != PV_RECORDER_TRACE_FORMAT_CHROME_TRACE) && (format != PV_RECORDER_TRACE_FORMAT_CSV)) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!object->trace_log) {
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
+
+    FILE *file = fopen(path, "ab+");
+    if (!file) {
+        return PV_RECORDER_STATUS_IO_ERROR;
+    }
+
+    // A Chrome trace that already holds an event ends with its closing brace, so the next one needs a separator. The
+    // last byte is checked rather than the size, since an earlier call may have written the header and no events.
+    bool is_first = true;
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) == 0) {
+        fputs((format == PV_RECORDER_TRACE_FORMAT_CSV) ? "timestamp_ns,event,value\n" : "[\n", file);
+    } else if (fseek(file, -1, SEEK_END) == 0) {
+        is_first = fgetc(file) != '}';
+    }
+    fseek(file, 0, SEEK_END);
+
+    pv_recorder_trace_event_t events[PV_RECORDER_TRACE_LOG_CHUNK_SIZE];
+    int32_t num_events = 0;
+    do {
+        uint64_t num_lost_events = 0;
+        pv_recorder_status_t status = pv_recorder_drain_trace_log(
+                object,
+                events,
+                PV_RECORDER_TRACE_LOG_CHUNK_SIZE,
+                &num_events,
+                &num_lost_events);
+        if (status != PV_RECORDER_STATUS_SUCCESS) {
+            fclose(file);
+            return status;
+        }
+
+        for (int32_t i = 0; i < num_events; i++) {
+            pv_recorder_write_trace_event(file, format, &events[i], is_first);
+            is_first = false;
+        }
+
+        // Lost events were dropped at some point before the drain, so they are recorded at the time of the drain.
+        if (num_lost_events > 0) {
+            pv_recorder_write_trace_lost_events(file, format, pv_recorder_get_time_ns(), num_lost_events, is_first);
+            is_first = false;
+        }
+    } while (num_events == PV_RECORDER_TRACE_LOG_CHUNK_SIZE);
+
+    const bool is_write_failed = ferror(file) != 0;
+    if ((fclose(file) != 0) || is_write_failed) {
+        return PV_RECORDER_STATUS_IO_ERROR;
+    }
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API bool pv_recorder_get_is_recording(pv_recorder_t *object) {
+    if (!object) {
+        return false;
+    }
+    return ma_device_is_started(&object->device);
+}
+
+PV_API const char *pv_recorder_get_selected_device(pv_recorder_t *object) {
+    if (!object) {
+        return NULL;
+    }
+    return object->device.capture.name;
+}
+
+PV_API pv_recorder_status_t pv_recorder_get_period(
+        pv_recorder_t *object,
+        int32_t *period_length,
+        int32_t *num_periods) {
+    if (!object) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!period_length) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!num_periods) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    *period_length = (int32_t) object->device.capture.internalPeriodSizeInFrames;
+    *num_periods = (int32_t) object->device.capture.internalPeriods;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_get_thread_config_status(
+        pv_recorder_t *object,
+        pv_recorder_thread_config_status_t *status) {
+    if (!object) {
         return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
-    if (frame_length <= 0) {
+    if (!status) {
         return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
-    if (buffered_frames_count < 1) {
+
+    const pv_recorder_thread_config_status_t *config_status = &object->thread_config_status;
+    status->capture_scheduling = __atomic_load_n(&config_status->capture_scheduling, __ATOMIC_RELAXED);
+    status->capture_affinity = __atomic_load_n(&config_status->capture_affinity, __ATOMIC_RELAXED);
+    status->consumer_scheduling = __atomic_load_n(&config_status->consumer_scheduling, __ATOMIC_RELAXED);
+    status->consumer_affinity = __atomic_load_n(&config_status->consumer_affinity, __ATOMIC_RELAXED);
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API pv_recorder_status_t pv_recorder_get_device_format(
+        pv_recorder_t *object,
+        pv_recorder_device_format_t *device_format,
+        bool *is_conversion_needed) {
+    if (!object) {
         return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
-    if (!object) {
+    if (!device_format) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!is_conversion_needed) {
         return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
 
-    *object = NULL;
+    const ma_device *device = &(object->device);
 
-    pv_recorder_t *o = calloc(1, sizeof(pv_recorder_t));
-    if (!o) {
-        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    device_format->sample_rate = (int32_t) device->capture.internalSampleRate;
+    device_format->num_channels = (int32_t) device->capture.internalChannels;
+    if (!pv_recorder_ma_format_to_sample_format(device->capture.internalFormat, &(device_format->sample_format))) {
+        // The device format has no equivalent, e.g. 8-bit, so it is always converted.
+        device_format->sample_format = object->sample_format;
+        *is_conversion_needed = true;
+        return PV_RECORDER_STATUS_SUCCESS;
     }
 
-    ma_result result = ma_context_init(NULL, 0, NULL, &(o->context));
-    if (result != MA_SUCCESS) {
-        pv_recorder_delete(o);
-        return ma_result_to_pv_recorder_status(result);
-    }
+    // Audio captured at the native rate is converted to the requested rate and format by PvRecorder instead.
+    *is_conversion_needed = (device->capture.internalSampleRate != device->sampleRate) ||
+                            (device->capture.internalChannels != device->capture.channels) ||
+                            (device->capture.internalFormat != device->capture.format) ||
+                            (object->resampler != NULL) ||
+                            (object->is_native_rate_capture &&
+                             (object->sample_format != PV_RECORDER_SAMPLE_FORMAT_F32));
 
-    o->device_config = ma_device_config_init(ma_device_type_capture);
-    o->device_config.capture.format = ma_format_s16;
-    o->device_config.capture.channels = 1;
-    o->device_config.sampleRate = ma_standard_sample_rate_16000;
-    o->device_config.dataCallback = pv_recorder_ma_callback;
-    o->device_config.pUserData = o;
+    return PV_RECORDER_STATUS_SUCCESS;
+}
 
-    if (device_index != PV_RECORDER_DEFAULT_DEVICE_INDEX) {
-        ma_device_info *capture_info = NULL;
-        ma_uint32 count = 0;
-        result = ma_context_get_devices(
-                &(o->context),
-                NULL,
-                NULL,
-                &capture_info,
-                &count);
-        if (result != MA_SUCCESS) {
-            pv_recorder_delete(o);
-            return ma_result_to_pv_recorder_status(result);
-        }
-        if (device_index >= count) {
-            pv_recorder_delete(o);
-            return PV_RECORDER_STATUS_INVALID_ARGUMENT;
-        }
-        o->device_config.capture.pDeviceID = &capture_info[device_index].id;
+PV_API pv_recorder_status_t pv_recorder_get_available_devices(
+        int32_t *device_list_length,
+        char ***device_list) {
+    if (!device_list_length) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
-
-    result = ma_device_init(&(o->context), &(o->device_config), &(o->device));
-    if (result != MA_SUCCESS) {
-        pv_recorder_delete(o);
-        return ma_result_to_pv_recorder_status(result);
+    if (!device_list) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
 
-    result = ma_mutex_init(&(o->mutex));
-    if (result != MA_SUCCESS) {
-        pv_recorder_delete(o);
-        return ma_result_to_pv_recorder_status(result);
+    pv_recorder_status_t status = pv_recorder_lock_device_cache();
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
     }
 
-    const int32_t buffer_capacity = frame_length * buffered_frames_count;
-    pv_circular_buffer_status_t status = pv_circular_buffer_init(
-            buffer_capacity,
-            sizeof(int16_t),
-            &(o->buffer));
-
-    if (status != PV_CIRCULAR_BUFFER_STATUS_SUCCESS) {
-        pv_recorder_delete(o);
+    const int32_t capture_count = shared_context.num_devices;
+    char **d = calloc(capture_count, sizeof(char *));
+    if (!d) {
+        pv_recorder_static_mutex_unlock(&shared_context_lock);
         return PV_RECORDER_STATUS_OUT_OF_MEMORY;
     }
 
-    o->frame_length = frame_length;
+    for (int32_t i = 0; i < capture_count; i++) {
+        d[i] = strdup(shared_context.devices[i].name);
+        if (!d[i]) {
+            for (int32_t j = i - 1; j >= 0; j--) {
+                free(d[j]);
+            }
+            free(d);
+            pv_recorder_static_mutex_unlock(&shared_context_lock);
+            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+        }
+    }
 
-    *object = o;
+    pv_recorder_static_mutex_unlock(&shared_context_lock);
+
+    *device_list_length = capture_count;
+    *device_list = d;
 
     return PV_RECORDER_STATUS_SUCCESS;
 }
 
-PV_API void pv_recorder_delete(pv_recorder_t *object) {
-    if (object) {
-        ma_device_uninit(&(object->device));
-        ma_context_uninit(&(object->context));
-        ma_mutex_uninit(&(object->mutex));
-        pv_circular_buffer_delete(object->buffer);
-        free(object);
-    }
+PV_API pv_recorder_status_t pv_recorder_refresh_available_devices(void) {
+    return pv_recorder_update_device_cache();
 }
 
-PV_API pv_recorder_status_t pv_recorder_start(pv_recorder_t *object) {
-    if (!object) {
+PV_API pv_recorder_status_t pv_recorder_set_backends(const pv_recorder_backend_t *backends, int32_t num_backends) {
+    if ((num_backends < 0) || (num_backends > PV_RECORDER_NUM_BACKENDS)) {
         return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
-
-    if (ma_device_is_started(&(object->device))) {
-        return PV_RECORDER_STATUS_SUCCESS;
+    if ((num_backends > 0) && !backends) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    for (int32_t i = 0; i < num_backends; i++) {
+        if ((backends[i] < PV_RECORDER_BACKEND_WASAPI) || (backends[i] >= PV_RECORDER_NUM_BACKENDS)) {
+            return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+        }
     }
 
-    ma_result result = ma_device_start(&(object->device));
-    if (result != MA_SUCCESS) {
-        ma_device_uninit(&(object->device));
+    pv_recorder_static_mutex_lock(&shared_context_lock);
 
-        result = ma_device_init(&(object->context), &(object->device_config), &(object->device));
-        if (result != MA_SUCCESS) {
-            return ma_result_to_pv_recorder_status(result);
-        }
+    if (shared_context.ref_count > 0) {
+        pv_recorder_static_mutex_unlock(&shared_context_lock);
+        return PV_RECORDER_STATUS_INVALID_STATE;
+    }
 
-        result = ma_device_start(&(object->device));
-        if (result != MA_SUCCESS) {
-            return ma_result_to_pv_recorder_status(result);
-        }
+    for (int32_t i = 0; i < num_backends; i++) {
+        shared_context.backends[i] = PV_RECORDER_MA_BACKENDS[backends[i]];
     }
+    shared_context.num_backends = num_backends;
+
+    // The cached devices and their IDs belong to the previous backend.
+    shared_context.is_device_cache_valid = false;
+
+    pv_recorder_static_mutex_unlock(&shared_context_lock);
 
     return PV_RECORDER_STATUS_SUCCESS;
 }
 
-PV_API pv_recorder_status_t pv_recorder_stop(pv_recorder_t *object) {
-    if (!object) {
+PV_API pv_recorder_status_t pv_recorder_get_backend(pv_recorder_backend_t *backend) {
+    if (!backend) {
         return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
 
-    ma_mutex_lock(&object->mutex);
-    pv_circular_buffer_reset(object->buffer);
-    ma_mutex_unlock(&object->mutex);
+    pv_recorder_status_t status = pv_recorder_lock_device_cache();
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
+    const ma_backend context_backend = shared_context.device_cache_backend;
+
+    pv_recorder_static_mutex_unlock(&shared_context_lock);
 
-    if (!ma_device_is_started(&(object->device))) {
-        return PV_RECORDER_STATUS_SUCCESS;
+    for (int32_t i = 0; i < PV_RECORDER_NUM_BACKENDS; i++) {
+        if (PV_RECORDER_MA_BACKENDS[i] == context_backend) {
+            *backend = (pv_recorder_backend_t) i;
+            return PV_RECORDER_STATUS_SUCCESS;
+        }
     }
 
-    ma_result result = ma_device_stop(&(object->device));
-    if (result != MA_SUCCESS) {
-        return ma_result_to_pv_recorder_status(result);
+    return PV_RECORDER_STATUS_RUNTIME_ERROR;
+}
+
+PV_API const char *pv_recorder_backend_to_string(pv_recorder_backend_t backend) {
+    static const char *const STRINGS[] = {
+            "WASAPI",
+            "DSOUND",
+            "WINMM",
+            "COREAUDIO",
+            "PULSEAUDIO",
+            "ALSA",
+            "JACK"};
+
+    int32_t size = sizeof(STRINGS) / sizeof(STRINGS[0]);
+    if ((int32_t) backend < PV_RECORDER_BACKEND_WASAPI || (int32_t) backend >= (PV_RECORDER_BACKEND_WASAPI + size)) {
+        return NULL;
     }
 
-    return PV_RECORDER_STATUS_SUCCESS;
+    return STRINGS[backend - PV_RECORDER_BACKEND_WASAPI];
 }
 
-PV_API pv_recorder_status_t pv_recorder_read(pv_recorder_t *object, int16_t *frame) {
-    if (!object) {
+PV_API pv_recorder_status_t pv_recorder_get_available_device_ids(
+        int32_t *device_list_length,
+        char ***device_id_list) {
+    if (!device_list_length) {
         return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
-    if (!frame) {
+    if (!device_id_list) {
         return PV_RECORDER_STATUS_INVALID_ARGUMENT;
     }
-    if (!ma_device_is_started(&object->device)) {
-        return PV_RECORDER_STATUS_INVALID_STATE;
-    }
 
-    int16_t *read_ptr = frame;
-    int32_t processed = 0;
-    int32_t remaining = object->frame_length;
+    pv_recorder_status_t status = pv_recorder_lock_device_cache();
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
 
-    for (int32_t i = 0; i < READ_RETRY_COUNT; i++) {
-        ma_mutex_lock(&object->mutex);
+    const int32_t capture_count = shared_context.num_devices;
+    char **d = calloc(capture_count, sizeof(char *));
+    if (!d) {
+        pv_recorder_static_mutex_unlock(&shared_context_lock);
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
 
-        if (!ma_device_is_started(&object->device)) {
-            ma_mutex_unlock(&object->mutex);
-            return PV_RECORDER_STATUS_SUCCESS;
+    for (int32_t i = 0; i < capture_count; i++) {
+        d[i] = strdup(shared_context.device_ids[i]);
+        if (!d[i]) {
+            for (int32_t j = i - 1; j >= 0; j--) {
+                free(d[j]);
+            }
+            free(d);
+            pv_recorder_static_mutex_unlock(&shared_context_lock);
+            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
         }
+    }
 
-        const int32_t length = pv_circular_buffer_read(object->buffer, read_ptr, remaining);
-        processed += length;
+    pv_recorder_static_mutex_unlock(&shared_context_lock);
 
-        if (processed == object->frame_length) {
-            ma_mutex_unlock(&object->mutex);
+    *device_list_length = capture_count;
+    *device_id_list = d;
 
-            if (object->is_debug_logging_enabled) {
-                for (int32_t j = 0; j < object->frame_length; j++) {
-                    if ((frame[j] > ABSOLUTE_SILENCE_THRESHOLD) || (frame[j] < -ABSOLUTE_SILENCE_THRESHOLD)) {
-                        object->current_silent_samples = 0;
-                        return PV_RECORDER_STATUS_SUCCESS;
-                    }
-                }
-                object->current_silent_samples += object->frame_length;
+    return PV_RECORDER_STATUS_SUCCESS;
+}
 
-                if (object->current_silent_samples >= MAX_SILENCE_BUFFER_SIZE) {
-                    fprintf(stdout, "[WARN] Input device might be muted or volume level is set to 0.\n");
-                    object->current_silent_samples = 0;
-                }
-            }
+/**
+ * Enumerates devices when woken by the rescan timer or by a device notification, and calls the device change callback
+ * when the list differs from the one it last reported. It sleeps on `rescan_event` in between, so it does not wake up
+ * while nothing happens.
+ */
+static ma_thread_result MA_THREADCALL pv_recorder_rescan_thread(void *data) {
+    (void) data;
 
-            return PV_RECORDER_STATUS_SUCCESS;
+    pv_recorder_static_mutex_lock(&shared_context_lock);
+    uint64_t reported_version = shared_context.device_list_version;
+    pv_recorder_static_mutex_unlock(&shared_context_lock);
+
+    while (true) {
+        if (ma_event_wait(&shared_context.rescan_event) != MA_SUCCESS) {
+            break;
+        }
+        if (__atomic_load_n(&shared_context.is_rescan_stopping, __ATOMIC_ACQUIRE)) {
+            break;
         }
 
-        ma_mutex_unlock(&object->mutex);
-        ma_sleep(READ_SLEEP_MILLI_SECONDS);
+        // The event may also have been left signaled by a notification that arrived before this thread started.
+        const bool is_requested = __atomic_exchange_n(&shared_context.is_rescan_requested, false, __ATOMIC_RELAXED);
+        const bool is_expired = __atomic_exchange_n(&shared_context.is_rescan_timer_expired, false, __ATOMIC_RELAXED);
+        if (!is_requested && !is_expired) {
+            continue;
+        }
+
+        (void) pv_recorder_update_device_cache();
 
-        read_ptr += length;
-        remaining = object->frame_length - processed;
+        pv_recorder_static_mutex_lock(&shared_context_lock);
+        const uint64_t version = shared_context.device_list_version;
+        pv_recorder_device_change_callback_t callback = shared_context.device_change_callback;
+        void *user_data = shared_context.device_change_user_data;
+        pv_recorder_static_mutex_unlock(&shared_context_lock);
+
+        if (version != reported_version) {
+            reported_version = version;
+            callback(user_data);
+        }
     }
 
-    return PV_RECORDER_STATUS_IO_ERROR;
+    return (ma_thread_result) 0;
 }
 
-PV_API void pv_recorder_set_debug_logging(
-        pv_recorder_t *object,
-        bool is_debug_logging_enabled) {
-    if (!object) {
-        return;
+/**
+ * Wakes the rescan thread every `rescan_interval_ms`. miniaudio's events have no timed wait, so it sleeps for the whole
+ * interval, and stopping it waits for the current sleep to end. Only runs when the interval is not 0.
+ */
+static ma_thread_result MA_THREADCALL pv_recorder_rescan_timer_thread(void *data) {
+    (void) data;
+
+    const int32_t rescan_interval_ms = shared_context.rescan_interval_ms;
+    while (!__atomic_load_n(&shared_context.is_rescan_stopping, __ATOMIC_ACQUIRE)) {
+        ma_sleep((ma_uint32) rescan_interval_ms);
+        __atomic_store_n(&shared_context.is_rescan_timer_expired, true, __ATOMIC_RELAXED);
+        ma_event_signal(&shared_context.rescan_event);
     }
 
-    object->is_debug_logging_enabled = is_debug_logging_enabled;
+    return (ma_thread_result) 0;
 }
 
-PV_API bool pv_recorder_get_is_recording(pv_recorder_t *object) {
-    if (!object) {
-        return false;
+/**
+ * Stops the rescan thread and its timer. Must be called with `device_change_callback_lock` held.
+ */
+static void pv_recorder_stop_rescan_threads(void) {
+    __atomic_store_n(&shared_context.is_rescan_stopping, true, __ATOMIC_RELEASE);
+    ma_event_signal(&shared_context.rescan_event);
+    if (shared_context.has_rescan_thread) {
+        ma_thread_wait(&(shared_context.rescan_thread));
+        shared_context.has_rescan_thread = false;
+    }
+    if (shared_context.has_rescan_timer_thread) {
+        ma_thread_wait(&(shared_context.rescan_timer_thread));
+        shared_context.has_rescan_timer_thread = false;
     }
-    return ma_device_is_started(&object->device);
 }
 
-PV_API const char *pv_recorder_get_selected_device(pv_recorder_t *object) {
-    if (!object) {
-        return NULL;
+/**
+ * Stops the rescan thread, if any, and starts a new one for `device_change_callback`. Must be called with
+ * `device_change_callback_lock` held.
+ */
+static pv_recorder_status_t pv_recorder_set_device_change_callback_locked(
+        pv_recorder_device_change_callback_t device_change_callback,
+        void *user_data,
+        int32_t rescan_interval_ms) {
+    if (shared_context.has_rescan_thread) {
+        pv_recorder_stop_rescan_threads();
+
+        pv_recorder_static_mutex_lock(&shared_context_lock);
+        shared_context.device_change_callback = NULL;
+        shared_context.device_change_user_data = NULL;
+        pv_recorder_shared_context_release_locked();
+        pv_recorder_static_mutex_unlock(&shared_context_lock);
     }
-    return object->device.capture.name;
-}
 
-PV_API pv_recorder_status_t pv_recorder_get_available_devices(
-        int32_t *device_list_length,
-        char ***device_list) {
-    if (!device_list_length) {
-        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    if (!device_change_callback) {
+        return PV_RECORDER_STATUS_SUCCESS;
     }
-    if (!device_list) {
-        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+
+    if (!shared_context.is_rescan_event_initialized) {
+        ma_result result = ma_event_init(&(shared_context.rescan_event));
+        if (result != MA_SUCCESS) {
+            return ma_result_to_pv_recorder_status(result);
+        }
+        __atomic_store_n(&shared_context.is_rescan_event_initialized, true, __ATOMIC_RELEASE);
     }
 
-    ma_context context;
-    ma_result result = ma_context_init(NULL, 0, NULL, &context);
+    // The rescan thread holds a reference so that enumerations reuse one context.
+    pv_recorder_static_mutex_lock(&shared_context_lock);
+    ma_result result = pv_recorder_shared_context_acquire_locked();
+    pv_recorder_static_mutex_unlock(&shared_context_lock);
     if (result != MA_SUCCESS) {
         return ma_result_to_pv_recorder_status(result);
     }
 
-    ma_device_info *capture_info;
-    ma_uint32 capture_count;
-    result = ma_context_get_devices(
-            &context,
-            NULL,
+    pv_recorder_status_t status = pv_recorder_lock_device_cache();
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        pv_recorder_static_mutex_lock(&shared_context_lock);
+        pv_recorder_shared_context_release_locked();
+        pv_recorder_static_mutex_unlock(&shared_context_lock);
+        return status;
+    }
+    shared_context.device_change_callback = device_change_callback;
+    shared_context.device_change_user_data = user_data;
+    shared_context.rescan_interval_ms = rescan_interval_ms;
+    shared_context.is_rescan_stopping = false;
+    shared_context.is_rescan_requested = false;
+    shared_context.is_rescan_timer_expired = false;
+    pv_recorder_static_mutex_unlock(&shared_context_lock);
+
+    result = ma_thread_create(
+            &(shared_context.rescan_thread),
+            ma_thread_priority_default,
+            0,
+            pv_recorder_rescan_thread,
             NULL,
-            &capture_info,
-            &capture_count);
+            NULL);
     if (result != MA_SUCCESS) {
-        ma_context_uninit(&context);
-        if (result == MA_OUT_OF_MEMORY) {
-            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
-        } else {
-            return PV_RECORDER_STATUS_INVALID_STATE;
-        }
+        pv_recorder_static_mutex_lock(&shared_context_lock);
+        shared_context.device_change_callback = NULL;
+        shared_context.device_change_user_data = NULL;
+        pv_recorder_shared_context_release_locked();
+        pv_recorder_static_mutex_unlock(&shared_context_lock);
+        return ma_result_to_pv_recorder_status(result);
     }
+    shared_context.has_rescan_thread = true;
 
-    char **d = calloc(capture_count, sizeof(char *));
-    if (!d) {
-        ma_context_uninit(&context);
-        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
-    }
+    if (rescan_interval_ms > 0) {
+        result = ma_thread_create(
+                &(shared_context.rescan_timer_thread),
+                ma_thread_priority_default,
+                0,
+                pv_recorder_rescan_timer_thread,
+                NULL,
+                NULL);
+        if (result != MA_SUCCESS) {
+            pv_recorder_stop_rescan_threads();
 
-    for (int32_t i = 0; i < (int32_t) capture_count; i++) {
-        d[i] = strdup(capture_info[i].name);
-        if (!d[i]) {
-            for (int32_t j = i - 1; j >= 0; j--) {
-                free(d[j]);
-            }
-            free(d);
-            ma_context_uninit(&context);
-            return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+            pv_recorder_static_mutex_lock(&shared_context_lock);
+            shared_context.device_change_callback = NULL;
+            shared_context.device_change_user_data = NULL;
+            pv_recorder_shared_context_release_locked();
+            pv_recorder_static_mutex_unlock(&shared_context_lock);
+            return ma_result_to_pv_recorder_status(result);
         }
+        shared_context.has_rescan_timer_thread = true;
     }
 
-    ma_context_uninit(&context);
+    return PV_RECORDER_STATUS_SUCCESS;
+}
 
-    *device_list_length = (int32_t) capture_count;
-    *device_list = d;
+PV_API pv_recorder_status_t pv_recorder_set_device_change_callback(
+        pv_recorder_device_change_callback_t device_change_callback,
+        void *user_data,
+        int32_t rescan_interval_ms) {
+    if (rescan_interval_ms < 0) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
 
-    return PV_RECORDER_STATUS_SUCCESS;
+    pv_recorder_static_mutex_lock(&device_change_callback_lock);
+    pv_recorder_status_t status = pv_recorder_set_device_change_callback_locked(
+            device_change_callback,
+            user_data,
+            rescan_interval_ms);
+    pv_recorder_static_mutex_unlock(&device_change_callback_lock);
+
+    return status;
 }
 
 PV_API void pv_recorder_free_available_devices(
@@ -369,6 +4080,81 @@ PV_API void pv_recorder_free_available_devices(
     }
 }
 
+PV_API pv_recorder_status_t pv_recorder_get_device_formats(
+        int32_t device_index,
+        int32_t *num_device_formats,
+        pv_recorder_device_format_t **device_formats) {
+    if (device_index < PV_RECORDER_DEFAULT_DEVICE_INDEX) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!num_device_formats) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!device_formats) {
+        return PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+
+    // Native formats are not filled in by enumeration on every backend, so the device is queried on its own.
+    pv_recorder_status_t status = pv_recorder_lock_device_cache();
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
+    if (device_index >= shared_context.num_devices) {
+        status = PV_RECORDER_STATUS_INVALID_ARGUMENT;
+    }
+    ma_device_id device_id;
+    memset(&device_id, 0, sizeof(device_id));
+    if ((status == PV_RECORDER_STATUS_SUCCESS) && (device_index != PV_RECORDER_DEFAULT_DEVICE_INDEX)) {
+        device_id = shared_context.devices[device_index].id;
+    }
+    if (status == PV_RECORDER_STATUS_SUCCESS) {
+        status = ma_result_to_pv_recorder_status(pv_recorder_shared_context_acquire_locked());
+    }
+    pv_recorder_static_mutex_unlock(&shared_context_lock);
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        return status;
+    }
+
+    // Queried on a reference to the context, without the lock, like enumeration.
+    ma_device_info info;
+    ma_result result = ma_context_get_device_info(
+            &(shared_context.context),
+            ma_device_type_capture,
+            (device_index == PV_RECORDER_DEFAULT_DEVICE_INDEX) ? NULL : &device_id,
+            &info);
+
+    pv_recorder_static_mutex_lock(&shared_context_lock);
+    pv_recorder_shared_context_release_locked();
+    pv_recorder_static_mutex_unlock(&shared_context_lock);
+
+    if (result != MA_SUCCESS) {
+        return ma_result_to_pv_recorder_status(result);
+    }
+
+    pv_recorder_device_format_t *f = calloc(info.nativeDataFormatCount + 1, sizeof(pv_recorder_device_format_t));
+    if (!f) {
+        return PV_RECORDER_STATUS_OUT_OF_MEMORY;
+    }
+
+    int32_t num_formats = 0;
+    for (ma_uint32 i = 0; i < info.nativeDataFormatCount; i++) {
+        if (pv_recorder_ma_format_to_sample_format(info.nativeDataFormats[i].format, &(f[num_formats].sample_format))) {
+            f[num_formats].sample_rate = (int32_t) info.nativeDataFormats[i].sampleRate;
+            f[num_formats].num_channels = (int32_t) info.nativeDataFormats[i].channels;
+            num_formats++;
+        }
+    }
+
+    *num_device_formats = num_formats;
+    *device_formats = f;
+
+    return PV_RECORDER_STATUS_SUCCESS;
+}
+
+PV_API void pv_recorder_free_device_formats(pv_recorder_device_format_t *device_formats) {
+    free(device_formats);
+}
+
 PV_API const char *pv_recorder_status_to_string(pv_recorder_status_t status) {
     static const char *const STRINGS[] = {
             "SUCCESS",
@@ -393,6 +4179,27 @@ PV_API int32_t pv_recorder_sample_rate(void) {
     return PV_RECORDER_SAMPLE_RATE;
 }
 
+PV_API int32_t pv_recorder_get_sample_rate(pv_recorder_t *object) {
+    if (!object) {
+        return 0;
+    }
+    return object->sample_rate;
+}
+
+PV_API int32_t pv_recorder_get_num_channels(pv_recorder_t *object) {
+    if (!object) {
+        return 0;
+    }
+    return object->num_channels;
+}
+
+PV_API pv_recorder_sample_format_t pv_recorder_get_sample_format(pv_recorder_t *object) {
+    if (!object) {
+        return PV_RECORDER_SAMPLE_FORMAT_S16;
+    }
+    return object->sample_format;
+}
+
 PV_API const char *pv_recorder_version(void) {
     return PV_RECORDER_VERSION;
 }
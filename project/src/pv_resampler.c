@@ -0,0 +1,374 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+
+#include <emmintrin.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+#define PV_RESAMPLER_AVX2
+
+#include <immintrin.h>
+
+#endif
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#define PV_RESAMPLER_NEON
+
+#include <arm_neon.h>
+
+#endif
+
+#include "pv_resampler.h"
+
+#define PV_RESAMPLER_TAP_ALIGNMENT (8)
+#define PV_RESAMPLER_MAX_COEFFICIENTS (1 << 20)
+
+static const double PI = 3.14159265358979323846;
+
+/**
+ * Kaiser-windowed sinc filter for each quality level. `zero_crossings` is the number of zero crossings of the sinc on
+ * each side, in samples of the lower of the two rates. `beta` sets the stopband attenuation, about 60, 80 and 95dB.
+ * `cutoff` is the cutoff as a fraction of the lower Nyquist frequency. It is set so that the transition band ends
+ * near the Nyquist frequency and what little aliasing remains falls into the transition band.
+ */
+typedef struct {
+    int32_t zero_crossings;
+    double beta;
+    double cutoff;
+} pv_resampler_filter_spec_t;
+
+static const pv_resampler_filter_spec_t FILTER_SPECS[] = {
+        {8, 6., 0.88},
+        {16, 8., 0.92},
+        {32, 10., 0.95},
+};
+
+typedef float (*pv_resampler_kernel_t)(const float *, const float *, int32_t);
+
+/**
+ * Output frame `n` is computed at input time `time = n * down / up`, kept in units of `1 / up` input samples relative
+ * to the start of `buffers`. Its integer part selects the first input sample under the filter and its fractional
+ * part selects one of the `up` phases of the filter, each `num_taps` long. `buffers` holds the input of each channel
+ * contiguously, starting with the last `num_taps - 1` samples that are still needed.
+ */
+struct pv_resampler {
+    int32_t num_channels;
+    int32_t up;
+    int32_t down;
+    int32_t num_taps;
+    int32_t max_input_frames;
+    int32_t capacity;
+    float *coefficients;
+    float *buffers;
+    int32_t fill;
+    int64_t time;
+    pv_resampler_kernel_t kernel;
+};
+
+/**
+ * Each kernel computes the dot product of a filter phase with the input under it. `num_taps` is a multiple of
+ * PV_RESAMPLER_TAP_ALIGNMENT.
+ */
+#if !defined(__SSE2__) && !defined(PV_RESAMPLER_NEON)
+
+static float pv_resampler_dot_scalar(const float *coefficients, const float *pcm, int32_t num_taps) {
+    float sum = 0.f;
+    for (int32_t i = 0; i < num_taps; i++) {
+        sum += coefficients[i] * pcm[i];
+    }
+    return sum;
+}
+
+#endif
+
+#if defined(__SSE2__)
+
+static float pv_resampler_dot_sse2(const float *coefficients, const float *pcm, int32_t num_taps) {
+    __m128 sum_low = _mm_setzero_ps();
+    __m128 sum_high = _mm_setzero_ps();
+    for (int32_t i = 0; i < num_taps; i += 8) {
+        sum_low = _mm_add_ps(sum_low, _mm_mul_ps(_mm_loadu_ps(coefficients + i), _mm_loadu_ps(pcm + i)));
+        sum_high = _mm_add_ps(sum_high, _mm_mul_ps(_mm_loadu_ps(coefficients + i + 4), _mm_loadu_ps(pcm + i + 4)));
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(sum_low, sum_high));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+#endif
+
+#if defined(PV_RESAMPLER_AVX2)
+
+__attribute__((target("avx2,fma")))
+static float pv_resampler_dot_avx2(const float *coefficients, const float *pcm, int32_t num_taps) {
+    // Two accumulators hide the latency of the fused multiply-add.
+    __m256 sum_even = _mm256_setzero_ps();
+    __m256 sum_odd = _mm256_setzero_ps();
+    int32_t i = 0;
+    for (; (i + 16) <= num_taps; i += 16) {
+        sum_even = _mm256_fmadd_ps(_mm256_loadu_ps(coefficients + i), _mm256_loadu_ps(pcm + i), sum_even);
+        sum_odd = _mm256_fmadd_ps(_mm256_loadu_ps(coefficients + i + 8), _mm256_loadu_ps(pcm + i + 8), sum_odd);
+    }
+    if (i < num_taps) {
+        sum_even = _mm256_fmadd_ps(_mm256_loadu_ps(coefficients + i), _mm256_loadu_ps(pcm + i), sum_even);
+    }
+
+    const __m256 sum = _mm256_add_ps(sum_even, sum_odd);
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1)));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+#endif
+
+#if defined(PV_RESAMPLER_NEON)
+
+static float pv_resampler_dot_neon(const float *coefficients, const float *pcm, int32_t num_taps) {
+    float32x4_t sum_low = vdupq_n_f32(0.f);
+    float32x4_t sum_high = vdupq_n_f32(0.f);
+    for (int32_t i = 0; i < num_taps; i += 8) {
+        sum_low = vmlaq_f32(sum_low, vld1q_f32(coefficients + i), vld1q_f32(pcm + i));
+        sum_high = vmlaq_f32(sum_high, vld1q_f32(coefficients + i + 4), vld1q_f32(pcm + i + 4));
+    }
+
+    float lanes[4];
+    vst1q_f32(lanes, vaddq_f32(sum_low, sum_high));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+#endif
+
+static pv_resampler_kernel_t pv_resampler_select_kernel(void) {
+
+#if defined(PV_RESAMPLER_AVX2)
+
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return pv_resampler_dot_avx2;
+    }
+
+#endif
+
+#if defined(__SSE2__)
+
+    return pv_resampler_dot_sse2;
+
+#elif defined(PV_RESAMPLER_NEON)
+
+    return pv_resampler_dot_neon;
+
+#else
+
+    return pv_resampler_dot_scalar;
+
+#endif
+
+}
+
+static int32_t pv_resampler_gcd(int32_t a, int32_t b) {
+    while (b != 0) {
+        const int32_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+static double pv_resampler_bessel_i0(double x) {
+    double sum = 1.;
+    double term = 1.;
+    for (int32_t k = 1; k < 64; k++) {
+        const double y = x / (2. * (double) k);
+        term *= y * y;
+        sum += term;
+        if (term < (1e-12 * sum)) {
+            break;
+        }
+    }
+    return sum;
+}
+
+/**
+ * Fills the coefficients of every phase, in the order of the input samples they multiply. Tap `k` of phase `p` is
+ * `k - (num_taps / 2 - 1) - p / up` input samples from the output time. Each phase is normalized to unit gain at DC,
+ * so that the gain does not vary with the phase.
+ */
+static void pv_resampler_design_filter(pv_resampler_t *object, const pv_resampler_filter_spec_t *spec) {
+    const double ratio = (object->up < object->down) ? ((double) object->up / (double) object->down) : 1.;
+    const double cutoff = spec->cutoff * 0.5 * ratio;
+    const double half_length = (double) object->num_taps / 2.;
+    const double window_scale = 1. / pv_resampler_bessel_i0(spec->beta);
+
+    for (int32_t p = 0; p < object->up; p++) {
+        float *coefficients = object->coefficients + ((size_t) p * (size_t) object->num_taps);
+        double sum = 0.;
+        for (int32_t k = 0; k < object->num_taps; k++) {
+            const double x = (double) k - (half_length - 1.) - ((double) p / (double) object->up);
+            const double y = 2. * cutoff * x;
+            const double sinc = (fabs(y) < 1e-9) ? 1. : (sin(PI * y) / (PI * y));
+            const double w = x / half_length;
+            const double window = (fabs(w) < 1.) ? pv_resampler_bessel_i0(spec->beta * sqrt(1. - (w * w))) : 1.;
+            const double h = 2. * cutoff * sinc * window * window_scale;
+            coefficients[k] = (float) h;
+            sum += h;
+        }
+        for (int32_t k = 0; k < object->num_taps; k++) {
+            coefficients[k] = (float) ((double) coefficients[k] / sum);
+        }
+    }
+}
+
+pv_resampler_status_t pv_resampler_init(
+        int32_t input_rate,
+        int32_t output_rate,
+        int32_t num_channels,
+        int32_t max_input_frames,
+        pv_resampler_quality_t quality,
+        pv_resampler_t **object) {
+    if ((input_rate <= 0) || (output_rate <= 0)) {
+        return PV_RESAMPLER_STATUS_INVALID_ARGUMENT;
+    }
+    if (num_channels <= 0) {
+        return PV_RESAMPLER_STATUS_INVALID_ARGUMENT;
+    }
+    if (max_input_frames <= 0) {
+        return PV_RESAMPLER_STATUS_INVALID_ARGUMENT;
+    }
+    if ((quality < PV_RESAMPLER_QUALITY_LOW) || (quality > PV_RESAMPLER_QUALITY_HIGH)) {
+        return PV_RESAMPLER_STATUS_INVALID_ARGUMENT;
+    }
+    if (!object) {
+        return PV_RESAMPLER_STATUS_INVALID_ARGUMENT;
+    }
+
+    *object = NULL;
+
+    const pv_resampler_filter_spec_t *spec = &FILTER_SPECS[quality];
+    const int32_t gcd = pv_resampler_gcd(input_rate, output_rate);
+    const int32_t up = output_rate / gcd;
+    const int32_t down = input_rate / gcd;
+
+    const double scale = (down > up) ? ((double) down / (double) up) : 1.;
+    int32_t num_taps = (int32_t) ceil(2. * (double) spec->zero_crossings * scale);
+    num_taps = ((num_taps + PV_RESAMPLER_TAP_ALIGNMENT - 1) / PV_RESAMPLER_TAP_ALIGNMENT) * PV_RESAMPLER_TAP_ALIGNMENT;
+    if (((int64_t) up * (int64_t) num_taps) > PV_RESAMPLER_MAX_COEFFICIENTS) {
+        return PV_RESAMPLER_STATUS_INVALID_ARGUMENT;
+    }
+    if (max_input_frames > (INT32_MAX / 2)) {
+        return PV_RESAMPLER_STATUS_INVALID_ARGUMENT;
+    }
+
+    pv_resampler_t *o = calloc(1, sizeof(pv_resampler_t));
+    if (!o) {
+        return PV_RESAMPLER_STATUS_OUT_OF_MEMORY;
+    }
+
+    o->num_channels = num_channels;
+    o->up = up;
+    o->down = down;
+    o->num_taps = num_taps;
+    o->max_input_frames = max_input_frames;
+    o->capacity = num_taps - 1 + max_input_frames;
+    o->kernel = pv_resampler_select_kernel();
+
+    o->coefficients = malloc((size_t) up * (size_t) num_taps * sizeof(float));
+    if (!(o->coefficients)) {
+        pv_resampler_delete(o);
+        return PV_RESAMPLER_STATUS_OUT_OF_MEMORY;
+    }
+    pv_resampler_design_filter(o, spec);
+
+    o->buffers = malloc((size_t) num_channels * (size_t) o->capacity * sizeof(float));
+    if (!(o->buffers)) {
+        pv_resampler_delete(o);
+        return PV_RESAMPLER_STATUS_OUT_OF_MEMORY;
+    }
+    pv_resampler_reset(o);
+
+    *object = o;
+
+    return PV_RESAMPLER_STATUS_SUCCESS;
+}
+
+void pv_resampler_delete(pv_resampler_t *object) {
+    if (object) {
+        free(object->coefficients);
+        free(object->buffers);
+        free(object);
+    }
+}
+
+void pv_resampler_reset(pv_resampler_t *object) {
+    // Silence before the first sample, so that the first output is centered on it.
+    object->fill = (object->num_taps / 2) - 1;
+    for (int32_t c = 0; c < object->num_channels; c++) {
+        memset(object->buffers + ((size_t) c * (size_t) object->capacity), 0, (size_t) object->fill * sizeof(float));
+    }
+    object->time = 0;
+}
+
+int32_t pv_resampler_get_max_output_frames(pv_resampler_t *object) {
+    return (int32_t) ((((int64_t) object->max_input_frames * object->up) + object->down - 1) / object->down) + 1;
+}
+
+int32_t pv_resampler_process(pv_resampler_t *object, const float *input, int32_t num_input_frames, float *output) {
+    const int32_t num_channels = object->num_channels;
+
+    for (int32_t c = 0; c < num_channels; c++) {
+        float *buffer = object->buffers + ((size_t) c * (size_t) object->capacity) + object->fill;
+        for (int32_t i = 0; i < num_input_frames; i++) {
+            buffer[i] = input[(i * num_channels) + c];
+        }
+    }
+    object->fill += num_input_frames;
+
+    int32_t num_output_frames = 0;
+    while (true) {
+        const int32_t start = (int32_t) (object->time / object->up);
+        if ((start + object->num_taps) > object->fill) {
+            break;
+        }
+
+        const float *coefficients =
+                object->coefficients + ((size_t) (object->time % object->up) * (size_t) object->num_taps);
+        for (int32_t c = 0; c < num_channels; c++) {
+            const float *buffer = object->buffers + ((size_t) c * (size_t) object->capacity) + start;
+            output[(num_output_frames * num_channels) + c] = object->kernel(coefficients, buffer, object->num_taps);
+        }
+        num_output_frames++;
+        object->time += object->down;
+    }
+
+    // Drops the input that no later output needs.
+    int32_t num_consumed = (int32_t) (object->time / object->up);
+    if (num_consumed > object->fill) {
+        num_consumed = object->fill;
+    }
+    if (num_consumed > 0) {
+        for (int32_t c = 0; c < num_channels; c++) {
+            float *buffer = object->buffers + ((size_t) c * (size_t) object->capacity);
+            memmove(buffer, buffer + num_consumed, (size_t) (object->fill - num_consumed) * sizeof(float));
+        }
+        object->fill -= num_consumed;
+        object->time -= (int64_t) num_consumed * object->up;
+    }
+
+    return num_output_frames;
+}
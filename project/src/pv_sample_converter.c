@@ -0,0 +1,477 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+
+#include <emmintrin.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+#define PV_SAMPLE_CONVERTER_AVX2
+
+#include <immintrin.h>
+
+#endif
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#define PV_SAMPLE_CONVERTER_NEON
+
+#include <arm_neon.h>
+
+#endif
+
+#include "pv_sample_converter.h"
+
+static const float S16_SCALE = 1.f / 32768.f;
+
+typedef int32_t (*pv_sample_converter_s16_kernel_t)(const int16_t *, int32_t, float *);
+
+/**
+ * Each kernel converts as many whole vectors as it can and returns the number of samples it consumed. The remainder is
+ * handled by the scalar loop.
+ */
+#if !defined(__SSE2__) && !defined(PV_SAMPLE_CONVERTER_NEON)
+
+static int32_t pv_sample_converter_s16_none(const int16_t *pcm, int32_t num_samples, float *output) {
+    (void) pcm;
+    (void) num_samples;
+    (void) output;
+    return 0;
+}
+
+#endif
+
+#if defined(__SSE2__)
+
+static int32_t pv_sample_converter_s16_sse2(const int16_t *pcm, int32_t num_samples, float *output) {
+    const __m128 scale = _mm_set1_ps(S16_SCALE);
+
+    int32_t i = 0;
+    for (; (i + 8) <= num_samples; i += 8) {
+        const __m128i x = _mm_loadu_si128((const __m128i *) (pcm + i));
+        // Interleaving with itself puts each sample in the high half of a 32-bit lane. The shift sign-extends it.
+        const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+        const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+    }
+
+    return i;
+}
+
+#endif
+
+#if defined(PV_SAMPLE_CONVERTER_AVX2)
+
+__attribute__((target("avx2")))
+static int32_t pv_sample_converter_s16_avx2(const int16_t *pcm, int32_t num_samples, float *output) {
+    const __m256 scale = _mm256_set1_ps(S16_SCALE);
+
+    int32_t i = 0;
+    for (; (i + 16) <= num_samples; i += 16) {
+        const __m256i low = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) (pcm + i)));
+        const __m256i high = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) (pcm + i + 8)));
+        _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(low), scale));
+        _mm256_storeu_ps(output + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(high), scale));
+    }
+
+    return i;
+}
+
+#endif
+
+#if defined(PV_SAMPLE_CONVERTER_NEON)
+
+static int32_t pv_sample_converter_s16_neon(const int16_t *pcm, int32_t num_samples, float *output) {
+    const float32x4_t scale = vdupq_n_f32(S16_SCALE);
+
+    int32_t i = 0;
+    for (; (i + 8) <= num_samples; i += 8) {
+        const int16x8_t x = vld1q_s16(pcm + i);
+        const int32x4_t low = vmovl_s16(vget_low_s16(x));
+        const int32x4_t high = vmovl_s16(vget_high_s16(x));
+        vst1q_f32(output + i, vmulq_f32(vcvtq_f32_s32(low), scale));
+        vst1q_f32(output + i + 4, vmulq_f32(vcvtq_f32_s32(high), scale));
+    }
+
+    return i;
+}
+
+#endif
+
+static pv_sample_converter_s16_kernel_t pv_sample_converter_select_s16_kernel(void) {
+
+#if defined(PV_SAMPLE_CONVERTER_AVX2)
+
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return pv_sample_converter_s16_avx2;
+    }
+
+#endif
+
+#if defined(__SSE2__)
+
+    return pv_sample_converter_s16_sse2;
+
+#elif defined(PV_SAMPLE_CONVERTER_NEON)
+
+    return pv_sample_converter_s16_neon;
+
+#else
+
+    return pv_sample_converter_s16_none;
+
+#endif
+
+}
+
+static pv_sample_converter_s16_kernel_t s16_kernel = NULL;
+
+void pv_sample_converter_s16_to_f32(const int16_t *pcm, int32_t num_samples, float *output) {
+    // Every thread selects the same kernel, so a race on the first call is harmless.
+    pv_sample_converter_s16_kernel_t kernel = __atomic_load_n(&s16_kernel, __ATOMIC_RELAXED);
+    if (!kernel) {
+        kernel = pv_sample_converter_select_s16_kernel();
+        __atomic_store_n(&s16_kernel, kernel, __ATOMIC_RELAXED);
+    }
+
+    int32_t i = kernel(pcm, num_samples, output);
+    for (; i < num_samples; i++) {
+        output[i] = (float) pcm[i] * S16_SCALE;
+    }
+}
+
+void pv_sample_converter_s32_to_f32(const int32_t *pcm, int32_t num_samples, int32_t num_bits, float *output) {
+    // A power of two, so the scaling itself is exact.
+    const float scale = 1.f / (float) (((int64_t) 1) << (num_bits - 1));
+
+    int32_t i = 0;
+
+#if defined(__SSE2__)
+
+    const __m128 scale_vector = _mm_set1_ps(scale);
+    for (; (i + 4) <= num_samples; i += 4) {
+        const __m128i x = _mm_loadu_si128((const __m128i *) (pcm + i));
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(x), scale_vector));
+    }
+
+#elif defined(PV_SAMPLE_CONVERTER_NEON)
+
+    const float32x4_t scale_vector = vdupq_n_f32(scale);
+    for (; (i + 4) <= num_samples; i += 4) {
+        vst1q_f32(output + i, vmulq_f32(vcvtq_f32_s32(vld1q_s32(pcm + i)), scale_vector));
+    }
+
+#endif
+
+    for (; i < num_samples; i++) {
+        output[i] = (float) pcm[i] * scale;
+    }
+}
+
+void pv_sample_converter_f32_to_s16(const float *pcm, int32_t num_samples, int16_t *output) {
+    int32_t i = 0;
+
+#if defined(__SSE2__)
+
+    // Clamping first keeps the conversion to 32 bits in range. Packing saturates 32768 to INT16_MAX.
+    const __m128 scale = _mm_set1_ps(32768.f);
+    const __m128 max = _mm_set1_ps(1.f);
+    const __m128 min = _mm_set1_ps(-1.f);
+    for (; (i + 8) <= num_samples; i += 8) {
+        const __m128 low = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(pcm + i), min), max);
+        const __m128 high = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(pcm + i + 4), min), max);
+        const __m128i x = _mm_packs_epi32(
+                _mm_cvtps_epi32(_mm_mul_ps(low, scale)),
+                _mm_cvtps_epi32(_mm_mul_ps(high, scale)));
+        _mm_storeu_si128((__m128i *) (output + i), x);
+    }
+
+#elif defined(PV_SAMPLE_CONVERTER_NEON) && defined(__aarch64__)
+
+    const float32x4_t scale = vdupq_n_f32(32768.f);
+    const float32x4_t max = vdupq_n_f32(1.f);
+    const float32x4_t min = vdupq_n_f32(-1.f);
+    for (; (i + 8) <= num_samples; i += 8) {
+        const float32x4_t low = vminq_f32(vmaxq_f32(vld1q_f32(pcm + i), min), max);
+        const float32x4_t high = vminq_f32(vmaxq_f32(vld1q_f32(pcm + i + 4), min), max);
+        const int16x8_t x = vcombine_s16(
+                vqmovn_s32(vcvtnq_s32_f32(vmulq_f32(low, scale))),
+                vqmovn_s32(vcvtnq_s32_f32(vmulq_f32(high, scale))));
+        vst1q_s16(output + i, x);
+    }
+
+#endif
+
+    for (; i < num_samples; i++) {
+        const float x = nearbyintf(pcm[i] * 32768.f);
+        output[i] = (int16_t) ((x >= 32767.f) ? 32767.f : ((x <= -32768.f) ? -32768.f : x));
+    }
+}
+
+void pv_sample_converter_f32_to_s32(const float *pcm, int32_t num_samples, int32_t num_bits, int32_t *output) {
+    // Computed in double, where every 32-bit value is exact.
+    const double scale = (double) (((int64_t) 1) << (num_bits - 1));
+    const double max = scale - 1.;
+    const double min = -scale;
+    for (int32_t i = 0; i < num_samples; i++) {
+        const double x = nearbyint((double) pcm[i] * scale);
+        output[i] = (int32_t) ((x >= max) ? max : ((x <= min) ? min : x));
+    }
+}
+
+/**
+ * De-interleave kernels handle the channel counts they have a vector layout for and return the number of frames they
+ * consumed, or 0 for other channel counts. The remainder is copied by the scalar loop.
+ */
+#if defined(__SSE2__)
+
+/**
+ * Splits the 16-bit samples of `a` followed by `b` into those at even and at odd positions. The even samples are
+ * sign-extended in place and the odd ones shifted down, so that packing them back to 16 bits never saturates.
+ */
+static void pv_sample_converter_split_s16_sse2(__m128i a, __m128i b, __m128i *even, __m128i *odd) {
+    *even = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16), _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+    *odd = _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16));
+}
+
+/**
+ * Same as `pv_sample_converter_split_s16_sse2()` for 32-bit samples. The samples are only moved, so a float shuffle
+ * is safe for any bit pattern.
+ */
+static void pv_sample_converter_split_32_sse2(__m128i a, __m128i b, __m128i *even, __m128i *odd) {
+    const __m128 x = _mm_castsi128_ps(a);
+    const __m128 y = _mm_castsi128_ps(b);
+    *even = _mm_castps_si128(_mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0)));
+    *odd = _mm_castps_si128(_mm_shuffle_ps(x, y, _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+/**
+ * Loads 4 vectors and splits them twice. The first split separates even from odd channels, the second one separates
+ * channel 0 from 2 and 1 from 3.
+ */
+static void pv_sample_converter_split4_sse2(
+        const void *pcm,
+        void (*split)(__m128i, __m128i, __m128i *, __m128i *),
+        __m128i *channels) {
+    const __m128i *p = (const __m128i *) pcm;
+    __m128i even_low;
+    __m128i odd_low;
+    __m128i even_high;
+    __m128i odd_high;
+    split(_mm_loadu_si128(p), _mm_loadu_si128(p + 1), &even_low, &odd_low);
+    split(_mm_loadu_si128(p + 2), _mm_loadu_si128(p + 3), &even_high, &odd_high);
+    split(even_low, even_high, &channels[0], &channels[2]);
+    split(odd_low, odd_high, &channels[1], &channels[3]);
+}
+
+static int32_t pv_sample_converter_deinterleave_16_sse2(
+        const int16_t *pcm,
+        int32_t num_frames,
+        int32_t num_channels,
+        int16_t **outputs) {
+    __m128i channels[4];
+
+    int32_t i = 0;
+    if (num_channels == 2) {
+        for (; (i + 8) <= num_frames; i += 8) {
+            const __m128i *p = (const __m128i *) (pcm + (2 * i));
+            pv_sample_converter_split_s16_sse2(_mm_loadu_si128(p), _mm_loadu_si128(p + 1), &channels[0], &channels[1]);
+            for (int32_t c = 0; c < 2; c++) {
+                if (outputs[c]) {
+                    _mm_storeu_si128((__m128i *) (outputs[c] + i), channels[c]);
+                }
+            }
+        }
+    } else if (num_channels == 4) {
+        for (; (i + 8) <= num_frames; i += 8) {
+            pv_sample_converter_split4_sse2(pcm + (4 * i), pv_sample_converter_split_s16_sse2, channels);
+            for (int32_t c = 0; c < 4; c++) {
+                if (outputs[c]) {
+                    _mm_storeu_si128((__m128i *) (outputs[c] + i), channels[c]);
+                }
+            }
+        }
+    }
+
+    return i;
+}
+
+static int32_t pv_sample_converter_deinterleave_32_sse2(
+        const int32_t *pcm,
+        int32_t num_frames,
+        int32_t num_channels,
+        int32_t **outputs) {
+    __m128i channels[4];
+
+    int32_t i = 0;
+    if (num_channels == 2) {
+        for (; (i + 4) <= num_frames; i += 4) {
+            const __m128i *p = (const __m128i *) (pcm + (2 * i));
+            pv_sample_converter_split_32_sse2(_mm_loadu_si128(p), _mm_loadu_si128(p + 1), &channels[0], &channels[1]);
+            for (int32_t c = 0; c < 2; c++) {
+                if (outputs[c]) {
+                    _mm_storeu_si128((__m128i *) (outputs[c] + i), channels[c]);
+                }
+            }
+        }
+    } else if (num_channels == 4) {
+        for (; (i + 4) <= num_frames; i += 4) {
+            pv_sample_converter_split4_sse2(pcm + (4 * i), pv_sample_converter_split_32_sse2, channels);
+            for (int32_t c = 0; c < 4; c++) {
+                if (outputs[c]) {
+                    _mm_storeu_si128((__m128i *) (outputs[c] + i), channels[c]);
+                }
+            }
+        }
+    }
+
+    return i;
+}
+
+#elif defined(PV_SAMPLE_CONVERTER_NEON)
+
+static int32_t pv_sample_converter_deinterleave_16_neon(
+        const int16_t *pcm,
+        int32_t num_frames,
+        int32_t num_channels,
+        int16_t **outputs) {
+    int32_t i = 0;
+    if (num_channels == 2) {
+        for (; (i + 8) <= num_frames; i += 8) {
+            const int16x8x2_t x = vld2q_s16(pcm + (2 * i));
+            for (int32_t c = 0; c < 2; c++) {
+                if (outputs[c]) {
+                    vst1q_s16(outputs[c] + i, x.val[c]);
+                }
+            }
+        }
+    } else if (num_channels == 3) {
+        for (; (i + 8) <= num_frames; i += 8) {
+            const int16x8x3_t x = vld3q_s16(pcm + (3 * i));
+            for (int32_t c = 0; c < 3; c++) {
+                if (outputs[c]) {
+                    vst1q_s16(outputs[c] + i, x.val[c]);
+                }
+            }
+        }
+    } else if (num_channels == 4) {
+        for (; (i + 8) <= num_frames; i += 8) {
+            const int16x8x4_t x = vld4q_s16(pcm + (4 * i));
+            for (int32_t c = 0; c < 4; c++) {
+                if (outputs[c]) {
+                    vst1q_s16(outputs[c] + i, x.val[c]);
+                }
+            }
+        }
+    }
+
+    return i;
+}
+
+static int32_t pv_sample_converter_deinterleave_32_neon(
+        const int32_t *pcm,
+        int32_t num_frames,
+        int32_t num_channels,
+        int32_t **outputs) {
+    int32_t i = 0;
+    if (num_channels == 2) {
+        for (; (i + 4) <= num_frames; i += 4) {
+            const int32x4x2_t x = vld2q_s32(pcm + (2 * i));
+            for (int32_t c = 0; c < 2; c++) {
+                if (outputs[c]) {
+                    vst1q_s32(outputs[c] + i, x.val[c]);
+                }
+            }
+        }
+    } else if (num_channels == 3) {
+        for (; (i + 4) <= num_frames; i += 4) {
+            const int32x4x3_t x = vld3q_s32(pcm + (3 * i));
+            for (int32_t c = 0; c < 3; c++) {
+                if (outputs[c]) {
+                    vst1q_s32(outputs[c] + i, x.val[c]);
+                }
+            }
+        }
+    } else if (num_channels == 4) {
+        for (; (i + 4) <= num_frames; i += 4) {
+            const int32x4x4_t x = vld4q_s32(pcm + (4 * i));
+            for (int32_t c = 0; c < 4; c++) {
+                if (outputs[c]) {
+                    vst1q_s32(outputs[c] + i, x.val[c]);
+                }
+            }
+        }
+    }
+
+    return i;
+}
+
+#endif
+
+void pv_sample_converter_deinterleave(
+        const void *pcm,
+        int32_t num_frames,
+        int32_t num_channels,
+        int32_t sample_size,
+        void **outputs) {
+    if (num_channels == 1) {
+        if (outputs[0]) {
+            memcpy(outputs[0], pcm, (size_t) num_frames * (size_t) sample_size);
+        }
+        return;
+    }
+
+    int32_t i = 0;
+
+#if defined(__SSE2__)
+
+    if (sample_size == 2) {
+        i = pv_sample_converter_deinterleave_16_sse2(pcm, num_frames, num_channels, (int16_t **) outputs);
+    } else {
+        i = pv_sample_converter_deinterleave_32_sse2(pcm, num_frames, num_channels, (int32_t **) outputs);
+    }
+
+#elif defined(PV_SAMPLE_CONVERTER_NEON)
+
+    if (sample_size == 2) {
+        i = pv_sample_converter_deinterleave_16_neon(pcm, num_frames, num_channels, (int16_t **) outputs);
+    } else {
+        i = pv_sample_converter_deinterleave_32_neon(pcm, num_frames, num_channels, (int32_t **) outputs);
+    }
+
+#endif
+
+    for (int32_t c = 0; c < num_channels; c++) {
+        if (!outputs[c]) {
+            continue;
+        }
+        if (sample_size == 2) {
+            const int16_t *input = (const int16_t *) pcm;
+            int16_t *output = (int16_t *) outputs[c];
+            for (int32_t j = i; j < num_frames; j++) {
+                output[j] = input[(j * num_channels) + c];
+            }
+        } else {
+            const int32_t *input = (const int32_t *) pcm;
+            int32_t *output = (int32_t *) outputs[c];
+            for (int32_t j = i; j < num_frames; j++) {
+                output[j] = input[(j * num_channels) + c];
+            }
+        }
+    }
+}
@@ -0,0 +1,149 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "pv_trace_log.h"
+
+#define PV_TRACE_LOG_CACHE_LINE_SIZE (64)
+#define PV_TRACE_LOG_MAX_CAPACITY (1 << 24)
+
+/**
+ * Bounded multi-producer queue. The sequence of a slot tells whose turn it is: a writer may fill the slot for event
+ * `index` when its sequence is `index`, and publishes it by setting the sequence to `index + 1`; the reader frees it by
+ * setting the sequence to `index + capacity`. Writers never wait for the reader. If the slot is still held by an
+ * unread event, the log is full and the new event is dropped.
+ */
+typedef struct {
+    uint64_t sequence;
+    int64_t timestamp_ns;
+    int64_t value;
+    int32_t type;
+} pv_trace_log_slot_t;
+
+struct pv_trace_log {
+    pv_trace_log_slot_t *slots;
+    uint64_t capacity;
+
+    __attribute__((aligned(PV_TRACE_LOG_CACHE_LINE_SIZE))) uint64_t write_count;
+    uint64_t dropped_count;
+
+    __attribute__((aligned(PV_TRACE_LOG_CACHE_LINE_SIZE))) uint64_t read_count;
+    uint64_t reported_dropped_count;
+};
+
+pv_trace_log_status_t pv_trace_log_init(int32_t capacity, pv_trace_log_t **object) {
+    if ((capacity <= 0) || (capacity > PV_TRACE_LOG_MAX_CAPACITY)) {
+        return PV_TRACE_LOG_STATUS_INVALID_ARGUMENT;
+    }
+    if (!object) {
+        return PV_TRACE_LOG_STATUS_INVALID_ARGUMENT;
+    }
+
+    *object = NULL;
+
+    pv_trace_log_t *o = calloc(1, sizeof(pv_trace_log_t));
+    if (!o) {
+        return PV_TRACE_LOG_STATUS_OUT_OF_MEMORY;
+    }
+
+    o->capacity = 1;
+    while (o->capacity < (uint64_t) capacity) {
+        o->capacity <<= 1;
+    }
+
+    o->slots = calloc(o->capacity, sizeof(pv_trace_log_slot_t));
+    if (!o->slots) {
+        pv_trace_log_delete(o);
+        return PV_TRACE_LOG_STATUS_OUT_OF_MEMORY;
+    }
+    for (uint64_t i = 0; i < o->capacity; i++) {
+        o->slots[i].sequence = i;
+    }
+
+    *object = o;
+
+    return PV_TRACE_LOG_STATUS_SUCCESS;
+}
+
+void pv_trace_log_delete(pv_trace_log_t *object) {
+    if (object) {
+        free(object->slots);
+        free(object);
+    }
+}
+
+void pv_trace_log_write(pv_trace_log_t *object, int32_t type, int64_t timestamp_ns, int64_t value) {
+    uint64_t index = __atomic_load_n(&object->write_count, __ATOMIC_RELAXED);
+    pv_trace_log_slot_t *slot = NULL;
+    while (true) {
+        slot = &object->slots[index & (object->capacity - 1)];
+        const int64_t difference = (int64_t) (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) - index);
+        if (difference == 0) {
+            if (__atomic_compare_exchange_n(
+                    &object->write_count,
+                    &index,
+                    index + 1,
+                    true,
+                    __ATOMIC_RELAXED,
+                    __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (difference < 0) {
+            __atomic_fetch_add(&object->dropped_count, 1, __ATOMIC_RELAXED);
+            return;
+        } else {
+            // Another writer claimed this event first.
+            index = __atomic_load_n(&object->write_count, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->timestamp_ns = timestamp_ns;
+    slot->value = value;
+    slot->type = type;
+    __atomic_store_n(&slot->sequence, index + 1, __ATOMIC_RELEASE);
+}
+
+int32_t pv_trace_log_read(
+        pv_trace_log_t *object,
+        pv_trace_log_event_t *events,
+        int32_t max_events,
+        uint64_t *num_lost_events) {
+    uint64_t read_count = object->read_count;
+    int32_t num_events = 0;
+
+    while (num_events < max_events) {
+        pv_trace_log_slot_t *slot = &object->slots[read_count & (object->capacity - 1)];
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != (read_count + 1)) {
+            // Either the log is empty or the writer that claimed this event has not finished it.
+            break;
+        }
+
+        events[num_events].timestamp_ns = slot->timestamp_ns;
+        events[num_events].value = slot->value;
+        events[num_events].type = slot->type;
+        num_events++;
+
+        __atomic_store_n(&slot->sequence, read_count + object->capacity, __ATOMIC_RELEASE);
+        read_count++;
+    }
+
+    object->read_count = read_count;
+
+    if (num_lost_events) {
+        const uint64_t dropped_count = __atomic_load_n(&object->dropped_count, __ATOMIC_RELAXED);
+        *num_lost_events = dropped_count - object->reported_dropped_count;
+        object->reported_dropped_count = dropped_count;
+    }
+
+    return num_events;
+}
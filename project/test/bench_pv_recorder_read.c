@@ -0,0 +1,217 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#if !defined(_WIN32)
+
+#define _POSIX_C_SOURCE 200809L
+
+#endif
+
+#define MINIAUDIO_IMPLEMENTATION
+#define MA_NO_DECODING
+#define MA_NO_ENCODING
+#define MA_NO_GENERATION
+
+#include "miniaudio.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+
+#include <windows.h>
+
+#else
+
+#include <time.h>
+
+#endif
+
+#include "pv_circular_buffer.h"
+
+static const int32_t FRAME_LENGTH = 512;
+static const int32_t BUFFERED_FRAMES_COUNT = 10;
+static const int32_t NUM_FRAMES = 100;
+static const int32_t PERIOD_LENGTH = 160;
+static const double PERIOD_MS = 10.;
+static const int32_t POLL_SLEEP_MILLI_SECONDS = 2;
+
+static double get_time_ms(void) {
+
+#if defined(_WIN32)
+
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double) counter.QuadPart * 1000. / (double) frequency.QuadPart;
+
+#else
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double) ts.tv_sec * 1000.) + ((double) ts.tv_nsec / 1e6);
+
+#endif
+
+}
+
+/**
+ * A simulated device and its reader. The device writes 16kHz audio in periods of `PERIOD_LENGTH` and records in
+ * `frame_complete_ms` when each frame of `FRAME_LENGTH` became available. `is_reader_waiting` and `event` are the
+ * handshake that `pv_recorder_read()` uses.
+ */
+typedef struct {
+    pv_circular_buffer_t *buffer;
+    double *frame_complete_ms;
+    ma_event event;
+    bool is_reader_waiting;
+} bench_t;
+
+static ma_thread_result MA_THREADCALL device_thread(void *data) {
+    bench_t *bench = (bench_t *) data;
+
+    int16_t *period = calloc((size_t) PERIOD_LENGTH, sizeof(int16_t));
+    if (!period) {
+        fprintf(stderr, "Failed to allocate memory.\n");
+        exit(1);
+    }
+
+    const uint64_t num_samples = (uint64_t) NUM_FRAMES * (uint64_t) FRAME_LENGTH;
+    const double start = get_time_ms();
+    uint64_t num_written = 0;
+    for (int64_t i = 1; num_written < num_samples; i++) {
+        // Periods follow a fixed schedule, as they do on a device.
+        const double remaining_ms = (start + ((double) i * PERIOD_MS)) - get_time_ms();
+        if (remaining_ms > 0.) {
+            ma_sleep((ma_uint32) (remaining_ms + 0.5));
+        }
+
+        const uint64_t num_frames = (num_written + (uint64_t) PERIOD_LENGTH) / (uint64_t) FRAME_LENGTH;
+        if ((num_frames > (num_written / (uint64_t) FRAME_LENGTH)) && (num_frames <= (uint64_t) NUM_FRAMES)) {
+            bench->frame_complete_ms[num_frames - 1] = get_time_ms();
+        }
+        pv_circular_buffer_write(bench->buffer, period, PERIOD_LENGTH);
+        num_written += (uint64_t) PERIOD_LENGTH;
+
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&bench->is_reader_waiting, __ATOMIC_RELAXED) &&
+            (pv_circular_buffer_get_count(bench->buffer) >= FRAME_LENGTH) &&
+            __atomic_exchange_n(&bench->is_reader_waiting, false, __ATOMIC_RELAXED)) {
+            ma_event_signal(&bench->event);
+        }
+    }
+
+    free(period);
+
+    return (ma_thread_result) 0;
+}
+
+/**
+ * The read loop `pv_recorder_read()` had before it waited on an event: take whatever is buffered and sleep for
+ * `POLL_SLEEP_MILLI_SECONDS` until the frame is complete. Returns the number of times the reader woke up.
+ */
+static int32_t read_polling(bench_t *bench, int16_t *frame) {
+    int32_t num_wakeups = 0;
+    int32_t processed = 0;
+    while (true) {
+        processed += pv_circular_buffer_read(bench->buffer, frame + processed, FRAME_LENGTH - processed);
+        if (processed == FRAME_LENGTH) {
+            break;
+        }
+        ma_sleep((ma_uint32) POLL_SLEEP_MILLI_SECONDS);
+        num_wakeups++;
+    }
+
+    return num_wakeups;
+}
+
+/**
+ * The read loop of `pv_recorder_read()`: wait on the event until the device has buffered a whole frame.
+ */
+static int32_t read_waiting(bench_t *bench, int16_t *frame) {
+    int32_t num_wakeups = 0;
+    while (pv_circular_buffer_get_count(bench->buffer) < FRAME_LENGTH) {
+        __atomic_store_n(&bench->is_reader_waiting, true, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (pv_circular_buffer_get_count(bench->buffer) >= FRAME_LENGTH) {
+            __atomic_store_n(&bench->is_reader_waiting, false, __ATOMIC_RELAXED);
+            break;
+        }
+        ma_event_wait(&bench->event);
+        num_wakeups++;
+    }
+    pv_circular_buffer_read(bench->buffer, frame, FRAME_LENGTH);
+
+    return num_wakeups;
+}
+
+static void run(const char *name, bool is_polling) {
+    bench_t bench;
+    memset(&bench, 0, sizeof(bench));
+
+    if (pv_circular_buffer_init(FRAME_LENGTH * BUFFERED_FRAMES_COUNT, sizeof(int16_t), &(bench.buffer)) !=
+        PV_CIRCULAR_BUFFER_STATUS_SUCCESS) {
+        fprintf(stderr, "Failed to initialize the circular buffer.\n");
+        exit(1);
+    }
+    bench.frame_complete_ms = calloc((size_t) NUM_FRAMES, sizeof(double));
+    int16_t *frame = calloc((size_t) FRAME_LENGTH, sizeof(int16_t));
+    if (!bench.frame_complete_ms || !frame) {
+        fprintf(stderr, "Failed to allocate memory.\n");
+        exit(1);
+    }
+    if (ma_event_init(&(bench.event)) != MA_SUCCESS) {
+        fprintf(stderr, "Failed to initialize the event.\n");
+        exit(1);
+    }
+
+    ma_thread thread;
+    if (ma_thread_create(&thread, ma_thread_priority_default, 0, device_thread, &bench, NULL) != MA_SUCCESS) {
+        fprintf(stderr, "Failed to start the device thread.\n");
+        exit(1);
+    }
+
+    const double start = get_time_ms();
+    int64_t num_wakeups = 0;
+    double total_latency_ms = 0.;
+    for (int32_t i = 0; i < NUM_FRAMES; i++) {
+        num_wakeups += is_polling ? read_polling(&bench, frame) : read_waiting(&bench, frame);
+        total_latency_ms += get_time_ms() - bench.frame_complete_ms[i];
+    }
+    const double elapsed_ms = get_time_ms() - start;
+
+    ma_thread_wait(&thread);
+
+    printf("%-8s %8.1f reader wakeups/s %8.3f ms mean callback-to-return latency\n",
+           name,
+           ((double) num_wakeups * 1000.) / elapsed_ms,
+           total_latency_ms / (double) NUM_FRAMES);
+
+    ma_event_uninit(&(bench.event));
+    free(frame);
+    free(bench.frame_complete_ms);
+    pv_circular_buffer_delete(bench.buffer);
+}
+
+int main(void) {
+    printf("Reading %d frames of %d samples at 16kHz from a simulated device with %.0fms periods\n\n",
+           NUM_FRAMES,
+           FRAME_LENGTH,
+           PERIOD_MS);
+
+    run("polling", true);
+    run("event", false);
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#if !defined(_WIN32)
+
+#define _POSIX_C_SOURCE 200809L
+
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+
+#include <windows.h>
+
+#else
+
+#include <time.h>
+
+#endif
+
+#include "pv_recorder.h"
+
+static const int32_t NUM_ITERATIONS = 20;
+
+static double get_time_ms(void) {
+
+#if defined(_WIN32)
+
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double) counter.QuadPart * 1000. / (double) frequency.QuadPart;
+
+#else
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double) ts.tv_sec * 1000.) + ((double) ts.tv_nsec / 1e6);
+
+#endif
+
+}
+
+static void check_status(pv_recorder_status_t status, const char *message) {
+    if (status != PV_RECORDER_STATUS_SUCCESS) {
+        fprintf(stderr, "%s failed with %s.\n", message, pv_recorder_status_to_string(status));
+        exit(1);
+    }
+}
+
+static double time_enumeration(void) {
+    int32_t device_list_length = 0;
+    char **device_list = NULL;
+
+    const double start = get_time_ms();
+    check_status(pv_recorder_get_available_devices(&device_list_length, &device_list), "get_available_devices");
+    const double elapsed = get_time_ms() - start;
+
+    pv_recorder_free_available_devices(device_list_length, device_list);
+
+    return elapsed;
+}
+
+static double time_refreshed_enumeration(void) {
+    const double start = get_time_ms();
+    check_status(pv_recorder_refresh_available_devices(), "refresh_available_devices");
+    const double elapsed = get_time_ms() - start;
+
+    return elapsed + time_enumeration();
+}
+
+static double time_init(int32_t device_index) {
+    pv_recorder_t *recorder = NULL;
+
+    const double start = get_time_ms();
+    check_status(pv_recorder_init(512, device_index, 10, &recorder), "init");
+    const double elapsed = get_time_ms() - start;
+
+    pv_recorder_delete(recorder);
+
+    return elapsed;
+}
+
+static void print_result(const char *name, double total_ms) {
+    printf("%-52s %10.3f ms\n", name, total_ms / (double) NUM_ITERATIONS);
+}
+
+int main(int argc, char *argv[]) {
+    const int32_t device_index = (argc > 1) ? (int32_t) strtol(argv[1], NULL, 10) : 0;
+
+    printf("Startup latency, averaged over %d iterations\n\n", NUM_ITERATIONS);
+
+    // Without any recorder alive, every enumeration that is not served from the cache creates and destroys a context,
+    // which is what every call cost before contexts were shared.
+    double total_ms = 0.;
+    for (int32_t i = 0; i < NUM_ITERATIONS; i++) {
+        total_ms += time_refreshed_enumeration();
+    }
+    print_result("get_available_devices, uncached, no recorder", total_ms);
+
+    total_ms = 0.;
+    for (int32_t i = 0; i < NUM_ITERATIONS; i++) {
+        total_ms += time_enumeration();
+    }
+    print_result("get_available_devices, cached", total_ms);
+
+    total_ms = 0.;
+    for (int32_t i = 0; i < NUM_ITERATIONS; i++) {
+        total_ms += time_init(device_index);
+    }
+    print_result("init, no other recorder", total_ms);
+
+    pv_recorder_t *recorder = NULL;
+    check_status(pv_recorder_init(512, device_index, 10, &recorder), "init");
+
+    total_ms = 0.;
+    for (int32_t i = 0; i < NUM_ITERATIONS; i++) {
+        total_ms += time_refreshed_enumeration();
+    }
+    print_result("get_available_devices, uncached, shared context", total_ms);
+
+    total_ms = 0.;
+    for (int32_t i = 0; i < NUM_ITERATIONS; i++) {
+        total_ms += time_init(device_index);
+    }
+    print_result("init, shared context", total_ms);
+
+    pv_recorder_delete(recorder);
+
+    return 0;
+}
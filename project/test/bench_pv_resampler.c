@@ -0,0 +1,283 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#if !defined(_WIN32)
+
+#define _POSIX_C_SOURCE 200809L
+
+#endif
+
+#define MINIAUDIO_IMPLEMENTATION
+#define MA_NO_DECODING
+#define MA_NO_ENCODING
+#define MA_NO_GENERATION
+
+#include "miniaudio.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+
+#include <windows.h>
+
+#else
+
+#include <time.h>
+
+#endif
+
+#include "pv_resampler.h"
+
+#define NUM_RESAMPLERS (4)
+#define PERIOD_MS (10)
+
+static const double PI = 3.14159265358979323846;
+static const int32_t OUTPUT_RATE = 16000;
+static const int32_t INPUT_RATES[] = {48000, 44100};
+static const int32_t NUM_SECONDS = 10;
+static const int32_t NUM_ITERATIONS = 5;
+static const double TONE_AMPLITUDE = 0.5;
+static const double PASSBAND_FREQUENCY = 1000.;
+static const double EDGE_FREQUENCY = 7000.;
+static const double ALIAS_FREQUENCY = 12000.;
+static const char *RESAMPLER_NAMES[NUM_RESAMPLERS] = {"miniaudio linear", "polyphase low", "polyphase medium",
+                                                      "polyphase high"};
+
+static double get_time_ms(void) {
+
+#if defined(_WIN32)
+
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double) counter.QuadPart * 1000. / (double) frequency.QuadPart;
+
+#else
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double) ts.tv_sec * 1000.) + ((double) ts.tv_nsec / 1e6);
+
+#endif
+
+}
+
+typedef struct {
+    int32_t index;
+    int32_t input_rate;
+    ma_resampler ma;
+    pv_resampler_t *pv;
+} resampler_t;
+
+static void resampler_init(resampler_t *resampler, int32_t index, int32_t input_rate) {
+    resampler->index = index;
+    resampler->input_rate = input_rate;
+
+    if (index == 0) {
+        // The same filter order that the device's data converter uses.
+        ma_resampler_config config = ma_resampler_config_init(
+                ma_format_f32,
+                1,
+                (ma_uint32) input_rate,
+                (ma_uint32) OUTPUT_RATE,
+                ma_resample_algorithm_linear);
+        config.linear.lpfOrder = ma_device_config_init(ma_device_type_capture).resampling.linear.lpfOrder;
+        if (ma_resampler_init(&config, NULL, &(resampler->ma)) != MA_SUCCESS) {
+            fprintf(stderr, "Failed to initialize miniaudio's resampler.\n");
+            exit(1);
+        }
+    } else {
+        const int32_t max_input_frames = (input_rate * PERIOD_MS) / 1000;
+        if (pv_resampler_init(
+                input_rate,
+                OUTPUT_RATE,
+                1,
+                max_input_frames,
+                (pv_resampler_quality_t) (index - 1),
+                &(resampler->pv)) != PV_RESAMPLER_STATUS_SUCCESS) {
+            fprintf(stderr, "Failed to initialize the polyphase resampler.\n");
+            exit(1);
+        }
+    }
+}
+
+static void resampler_delete(resampler_t *resampler) {
+    if (resampler->index == 0) {
+        ma_resampler_uninit(&(resampler->ma), NULL);
+    } else {
+        pv_resampler_delete(resampler->pv);
+    }
+}
+
+/**
+ * Resamples `num_input_frames` in periods of `PERIOD_MS`, as the audio callback does, and returns the number of output
+ * frames.
+ */
+static int32_t resampler_run(resampler_t *resampler, const float *input, int32_t num_input_frames, float *output) {
+    const int32_t period_length = (resampler->input_rate * PERIOD_MS) / 1000;
+
+    int32_t num_output_frames = 0;
+    for (int32_t i = 0; i < num_input_frames; i += period_length) {
+        const int32_t length = ((num_input_frames - i) < period_length) ? (num_input_frames - i) : period_length;
+        if (resampler->index == 0) {
+            ma_uint64 frame_count_in = (ma_uint64) length;
+            ma_uint64 frame_count_out = (ma_uint64) period_length;
+            ma_resampler_process_pcm_frames(
+                    &(resampler->ma),
+                    input + i,
+                    &frame_count_in,
+                    output + num_output_frames,
+                    &frame_count_out);
+            num_output_frames += (int32_t) frame_count_out;
+        } else {
+            num_output_frames += pv_resampler_process(resampler->pv, input + i, length, output + num_output_frames);
+        }
+    }
+
+    return num_output_frames;
+}
+
+static void generate_tone(double frequency, int32_t sample_rate, int32_t num_samples, float *pcm) {
+    for (int32_t i = 0; i < num_samples; i++) {
+        pcm[i] = (float) (TONE_AMPLITUDE * sin(2. * PI * frequency * (double) i / (double) sample_rate));
+    }
+}
+
+/**
+ * Fits a sinusoid of the given frequency to the signal by least squares. Returns its amplitude and sets the power of
+ * what is left, i.e. noise, distortion and aliasing.
+ */
+static double fit_tone(const float *pcm, int32_t num_samples, double frequency, double *residual_power) {
+    double cc = 0.;
+    double ss = 0.;
+    double cs = 0.;
+    double xc = 0.;
+    double xs = 0.;
+    for (int32_t i = 0; i < num_samples; i++) {
+        const double phase = 2. * PI * frequency * (double) i / (double) OUTPUT_RATE;
+        const double c = cos(phase);
+        const double s = sin(phase);
+        cc += c * c;
+        ss += s * s;
+        cs += c * s;
+        xc += pcm[i] * c;
+        xs += pcm[i] * s;
+    }
+    const double determinant = (cc * ss) - (cs * cs);
+    const double a = ((xc * ss) - (xs * cs)) / determinant;
+    const double b = ((xs * cc) - (xc * cs)) / determinant;
+
+    double power = 0.;
+    for (int32_t i = 0; i < num_samples; i++) {
+        const double phase = 2. * PI * frequency * (double) i / (double) OUTPUT_RATE;
+        const double residual = pcm[i] - ((a * cos(phase)) + (b * sin(phase)));
+        power += residual * residual;
+    }
+    *residual_power = power / (double) num_samples;
+
+    return sqrt((a * a) + (b * b));
+}
+
+static double to_db(double ratio) {
+    return 20. * log10((ratio > 1e-12) ? ratio : 1e-12);
+}
+
+/**
+ * Measures the resampler on a tone, skipping the first 100ms so that the filters have settled. The frequency used to
+ * fit the output is the input frequency folded into the output band.
+ */
+static double measure_tone(
+        int32_t index,
+        int32_t input_rate,
+        double frequency,
+        float *input,
+        float *output,
+        double *residual_power) {
+    const int32_t num_input_frames = input_rate;
+    generate_tone(frequency, input_rate, num_input_frames, input);
+
+    resampler_t resampler;
+    resampler_init(&resampler, index, input_rate);
+    const int32_t num_output_frames = resampler_run(&resampler, input, num_input_frames, output);
+    resampler_delete(&resampler);
+
+    const double folded_frequency = (frequency < (OUTPUT_RATE / 2)) ? frequency : (OUTPUT_RATE - frequency);
+    const int32_t skip = OUTPUT_RATE / 10;
+    return fit_tone(output + skip, num_output_frames - skip, folded_frequency, residual_power);
+}
+
+int main(void) {
+    const int32_t max_input_frames = INPUT_RATES[0] * NUM_SECONDS;
+    float *input = malloc((size_t) max_input_frames * sizeof(float));
+    float *output = malloc((size_t) ((OUTPUT_RATE * NUM_SECONDS) + OUTPUT_RATE) * sizeof(float));
+    if (!input || !output) {
+        fprintf(stderr, "Failed to allocate memory.\n");
+        exit(1);
+    }
+
+    printf("%-18s %8s %14s %10s %12s %12s\n", "resampler", "rate", "us per second", "SNR (dB)", "7kHz (dB)",
+           "alias (dB)");
+    for (size_t r = 0; r < (sizeof(INPUT_RATES) / sizeof(INPUT_RATES[0])); r++) {
+        const int32_t input_rate = INPUT_RATES[r];
+        const int32_t num_input_frames = input_rate * NUM_SECONDS;
+
+        for (int32_t index = 0; index < NUM_RESAMPLERS; index++) {
+            for (int32_t i = 0; i < num_input_frames; i++) {
+                input[i] = (float) ((double) rand() / RAND_MAX - 0.5);
+            }
+
+            double best_ms = 0.;
+            for (int32_t i = 0; i < NUM_ITERATIONS; i++) {
+                resampler_t resampler;
+                resampler_init(&resampler, index, input_rate);
+                const double start = get_time_ms();
+                resampler_run(&resampler, input, num_input_frames, output);
+                const double elapsed = get_time_ms() - start;
+                resampler_delete(&resampler);
+                if ((i == 0) || (elapsed < best_ms)) {
+                    best_ms = elapsed;
+                }
+            }
+
+            double residual_power = 0.;
+            const double amplitude = measure_tone(
+                    index,
+                    input_rate,
+                    PASSBAND_FREQUENCY,
+                    input,
+                    output,
+                    &residual_power);
+            const double snr_db = 10. * log10((amplitude * amplitude / 2.) / residual_power);
+
+            double unused = 0.;
+            const double edge_db = to_db(
+                    measure_tone(index, input_rate, EDGE_FREQUENCY, input, output, &unused) / TONE_AMPLITUDE);
+            const double alias_db = to_db(
+                    measure_tone(index, input_rate, ALIAS_FREQUENCY, input, output, &unused) / TONE_AMPLITUDE);
+
+            printf("%-18s %8d %14.1f %10.1f %12.2f %12.1f\n",
+                   RESAMPLER_NAMES[index],
+                   input_rate,
+                   best_ms * 1000. / NUM_SECONDS,
+                   snr_db,
+                   edge_db,
+                   alias_db);
+        }
+    }
+
+    free(input);
+    free(output);
+
+    return 0;
+}
@@ -9,6 +9,8 @@
     specific language governing permissions and limitations under the License.
 */
 
+#include <pthread.h>
+
 #include "pv_circular_buffer.h"
 #include "test_helper.h"
 
@@ -186,6 +188,366 @@ static void test_pv_circular_buffer_zeros(void) {
     pv_circular_buffer_delete(cb);
 }
 
+static void test_pv_circular_buffer_get_count(void) {
+    pv_circular_buffer_t *cb;
+    pv_circular_buffer_status_t status = pv_circular_buffer_init(10, sizeof(int16_t), &cb);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
+
+    int16_t in_buffer[] = {5, 7, -20, 35, 70, 100, 0, 1, -100};
+    int32_t in_size = sizeof(in_buffer) / sizeof(in_buffer[0]);
+    int16_t out_buffer[4];
+
+    check_condition(pv_circular_buffer_get_count(cb) == 0, __FUNCTION__ , __LINE__, "Expected empty buffer.");
+
+    pv_circular_buffer_write(cb, in_buffer, in_size);
+    check_condition(pv_circular_buffer_get_count(cb) == in_size, __FUNCTION__ , __LINE__, "Incorrect count after write.");
+
+    pv_circular_buffer_read(cb, out_buffer, 4);
+    check_condition(pv_circular_buffer_get_count(cb) == (in_size - 4), __FUNCTION__ , __LINE__, "Incorrect count after read.");
+
+    pv_circular_buffer_write(cb, in_buffer, in_size);
+    check_condition(pv_circular_buffer_get_count(cb) == 10, __FUNCTION__ , __LINE__, "Count should not exceed capacity.");
+
+    pv_circular_buffer_reset(cb);
+    check_condition(pv_circular_buffer_get_count(cb) == 0, __FUNCTION__ , __LINE__, "Expected empty buffer after reset.");
+
+    pv_circular_buffer_delete(cb);
+}
+
+static void test_pv_circular_buffer_peek_commit(void) {
+    pv_circular_buffer_t *cb;
+    pv_circular_buffer_status_t status = pv_circular_buffer_init(2048, sizeof(int16_t), &cb);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
+
+    int32_t in_size = 1500;
+    int16_t in_buffer[in_size];
+    for (int32_t i = 0; i < in_size; i++) {
+        in_buffer[i] = (int16_t) ((rand() % (2000 + 1)) - 1000);
+    }
+    int16_t out_buffer[in_size];
+
+    pv_circular_buffer_write(cb, in_buffer, in_size);
+    pv_circular_buffer_read(cb, out_buffer, in_size);
+
+    // the second write wraps around the end of the storage
+    status = pv_circular_buffer_write(cb, in_buffer, in_size);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to write to buffer.");
+
+    int32_t processed = 0;
+    while (processed < in_size) {
+        const void *peeked = NULL;
+        int32_t length = pv_circular_buffer_peek(cb, &peeked, in_size - processed);
+        check_condition(length > 0, __FUNCTION__ , __LINE__, "Buffer peek returned no elements.");
+
+        for (int32_t i = 0; i < length; i++) {
+            check_condition(in_buffer[processed + i] == ((const int16_t *) peeked)[i],
+                            __FUNCTION__ ,
+                            __LINE__,
+                            "Peeked buffer has different values at index %d.",
+                            processed + i);
+        }
+
+        status = pv_circular_buffer_commit(cb, length);
+        check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to commit.");
+        processed += length;
+    }
+
+    check_condition(pv_circular_buffer_get_count(cb) == 0, __FUNCTION__ , __LINE__, "Expected empty buffer.");
+
+    pv_circular_buffer_delete(cb);
+}
+
+static void test_pv_circular_buffer_commit_overflow(void) {
+    pv_circular_buffer_t *cb;
+    pv_circular_buffer_status_t status = pv_circular_buffer_init(10, sizeof(int16_t), &cb);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
+
+    int16_t in_buffer[] = {5, 7, -20, 35, 70, 100, 0, 1, -100};
+    int32_t in_size = sizeof(in_buffer) / sizeof(in_buffer[0]);
+
+    pv_circular_buffer_write(cb, in_buffer, 5);
+
+    const void *peeked = NULL;
+    int32_t length = pv_circular_buffer_peek(cb, &peeked, 5);
+    check_condition(length == 5, __FUNCTION__ , __LINE__, "Buffer peek received incorrect output length.");
+
+    pv_circular_buffer_write(cb, in_buffer, in_size);
+
+    status = pv_circular_buffer_commit(cb, length);
+    check_condition(
+            status == PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW,
+            __FUNCTION__ ,
+            __LINE__,
+            "Expected overflow when committing overwritten elements.");
+    check_condition(pv_circular_buffer_get_count(cb) == 10, __FUNCTION__ , __LINE__, "Expected a full buffer.");
+
+    pv_circular_buffer_delete(cb);
+}
+
+static const int32_t STRESS_ELEMENT_COUNT = 4000000;
+static const int32_t STRESS_MAX_CHUNK_LENGTH = 97;
+
+typedef struct {
+    pv_circular_buffer_t *cb;
+    volatile bool is_done;
+} stress_context_t;
+
+static void *stress_producer(void *arg) {
+    stress_context_t *context = (stress_context_t *) arg;
+
+    int32_t chunk[STRESS_MAX_CHUNK_LENGTH];
+    int32_t value = 0;
+    while (value < STRESS_ELEMENT_COUNT) {
+        int32_t length = 1 + (rand() % STRESS_MAX_CHUNK_LENGTH);
+        if (length > (STRESS_ELEMENT_COUNT - value)) {
+            length = STRESS_ELEMENT_COUNT - value;
+        }
+        for (int32_t i = 0; i < length; i++) {
+            chunk[i] = value++;
+        }
+        pv_circular_buffer_status_t status = pv_circular_buffer_write(context->cb, chunk, length);
+        check_condition(
+                (status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS) || (status == PV_CIRCULAR_BUFFER_STATUS_WRITE_OVERFLOW),
+                __FUNCTION__,
+                __LINE__,
+                "Failed to write to buffer.");
+    }
+
+    __atomic_store_n(&context->is_done, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void test_pv_circular_buffer_read_position(void) {
+    pv_circular_buffer_t *cb;
+    pv_circular_buffer_status_t status = pv_circular_buffer_init(10, sizeof(int16_t), &cb);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
+
+    int16_t in_buffer[12] = {0};
+    int16_t out_buffer[10];
+
+    pv_circular_buffer_write(cb, in_buffer, 4);
+    pv_circular_buffer_read(cb, out_buffer, 2);
+    check_condition(
+            pv_circular_buffer_get_read_position(cb) == 2,
+            __FUNCTION__ ,
+            __LINE__,
+            "Buffer read position is incorrect.");
+    check_condition(
+            pv_circular_buffer_get_dropped_count(cb) == 0,
+            __FUNCTION__ ,
+            __LINE__,
+            "Buffer dropped count is incorrect.");
+
+    pv_circular_buffer_write(cb, in_buffer, 10);
+    pv_circular_buffer_write(cb, in_buffer, 2);
+    pv_circular_buffer_read(cb, out_buffer, 5);
+    check_condition(
+            pv_circular_buffer_get_read_position(cb) == 11,
+            __FUNCTION__ ,
+            __LINE__,
+            "Buffer read position is incorrect after overflow.");
+    check_condition(
+            pv_circular_buffer_get_dropped_count(cb) == 4,
+            __FUNCTION__ ,
+            __LINE__,
+            "Buffer dropped count is incorrect after overflow.");
+
+    pv_circular_buffer_reset(cb);
+    check_condition(
+            pv_circular_buffer_get_read_position(cb) == 16,
+            __FUNCTION__ ,
+            __LINE__,
+            "Buffer read position is incorrect after reset.");
+    check_condition(
+            pv_circular_buffer_get_dropped_count(cb) == 4,
+            __FUNCTION__ ,
+            __LINE__,
+            "Buffer reset must not count as dropped.");
+
+    pv_circular_buffer_write(cb, in_buffer, 3);
+    check_condition(
+            pv_circular_buffer_discard_until(cb, 18) && (pv_circular_buffer_get_read_position(cb) == 18),
+            __FUNCTION__ ,
+            __LINE__,
+            "Buffer read position is incorrect after discard.");
+    check_condition(
+            !pv_circular_buffer_discard_until(cb, 17) && (pv_circular_buffer_get_count(cb) == 1),
+            __FUNCTION__ ,
+            __LINE__,
+            "Buffer discard must not move the read position back.");
+    check_condition(
+            pv_circular_buffer_get_dropped_count(cb) == 4,
+            __FUNCTION__ ,
+            __LINE__,
+            "Buffer discard must not count as dropped.");
+
+    pv_circular_buffer_write(cb, in_buffer, 2);
+    pv_circular_buffer_drop(cb, 2);
+    check_condition(
+            (pv_circular_buffer_get_read_position(cb) == 20) && (pv_circular_buffer_get_count(cb) == 1),
+            __FUNCTION__ ,
+            __LINE__,
+            "Buffer read position is incorrect after drop.");
+    check_condition(
+            pv_circular_buffer_get_dropped_count(cb) == 6,
+            __FUNCTION__ ,
+            __LINE__,
+            "Buffer drop must count as dropped.");
+
+    pv_circular_buffer_delete(cb);
+}
+
+static void test_pv_circular_buffer_read_history(void) {
+    pv_circular_buffer_t *cb;
+    pv_circular_buffer_status_t status = pv_circular_buffer_init_with_history(10, 6, sizeof(int16_t), &cb);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
+
+    int16_t in_buffer[10];
+    int16_t out_buffer[10];
+    int16_t history[6] = {0};
+
+    for (int32_t i = 0; i < 10; i++) {
+        in_buffer[i] = (int16_t) (i + 1);
+    }
+
+    int32_t length = pv_circular_buffer_read_history(cb, history, 7);
+    check_condition(
+            length == PV_CIRCULAR_BUFFER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__ ,
+            __LINE__,
+            "Reading more history than kept must fail.");
+
+    pv_circular_buffer_write(cb, in_buffer, 4);
+    pv_circular_buffer_read(cb, out_buffer, 4);
+    length = pv_circular_buffer_read_history(cb, history, 6);
+    check_condition(length == 4, __FUNCTION__ , __LINE__, "Buffer history length is incorrect.");
+    for (int32_t i = 0; i < 4; i++) {
+        check_condition(history[2 + i] == in_buffer[i], __FUNCTION__ , __LINE__, "Buffer history is incorrect.");
+    }
+
+    // Fill the buffer so that the history only survives in the extra slots.
+    pv_circular_buffer_write(cb, in_buffer, 10);
+    length = pv_circular_buffer_read_history(cb, history, 4);
+    check_condition(length == 4, __FUNCTION__ , __LINE__, "Buffer history length is incorrect when full.");
+    for (int32_t i = 0; i < 4; i++) {
+        check_condition(history[i] == in_buffer[i], __FUNCTION__ , __LINE__, "Buffer history is incorrect when full.");
+    }
+
+    pv_circular_buffer_read(cb, out_buffer, 7);
+    length = pv_circular_buffer_read_history(cb, history, 6);
+    check_condition(length == 6, __FUNCTION__ , __LINE__, "Buffer history length is incorrect.");
+    for (int32_t i = 0; i < 6; i++) {
+        check_condition(history[i] == in_buffer[1 + i], __FUNCTION__ , __LINE__, "Buffer history is incorrect.");
+    }
+    check_condition(
+            pv_circular_buffer_get_count(cb) == 3,
+            __FUNCTION__ ,
+            __LINE__,
+            "Reading history must not consume elements.");
+
+    pv_circular_buffer_delete(cb);
+}
+
+static void test_pv_circular_buffer_read_at(void) {
+    pv_circular_buffer_t *cb;
+    pv_circular_buffer_status_t status = pv_circular_buffer_init(10, sizeof(int16_t), &cb);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
+
+    int16_t in_buffer[10];
+    int16_t out_buffer[10];
+
+    for (int32_t i = 0; i < 10; i++) {
+        in_buffer[i] = (int16_t) (i + 1);
+    }
+
+    uint64_t fast = pv_circular_buffer_get_write_position(cb);
+    uint64_t slow = fast;
+
+    pv_circular_buffer_write(cb, in_buffer, 6);
+    int32_t length = pv_circular_buffer_read_at(cb, &fast, out_buffer, 6);
+    check_condition((length == 6) && (fast == 6), __FUNCTION__ , __LINE__, "Cursor read is incorrect.");
+    for (int32_t i = 0; i < 6; i++) {
+        check_condition(out_buffer[i] == in_buffer[i], __FUNCTION__ , __LINE__, "Cursor read contents are incorrect.");
+    }
+    check_condition(
+            (pv_circular_buffer_get_count_at(cb, &slow) == 6) && (pv_circular_buffer_get_count(cb) == 6),
+            __FUNCTION__ ,
+            __LINE__,
+            "Reading from a cursor must not affect other readers.");
+
+    // The slow cursor is lapped and skips the overwritten elements.
+    pv_circular_buffer_write(cb, in_buffer, 8);
+    length = pv_circular_buffer_read_at(cb, &slow, out_buffer, 10);
+    check_condition((length == 10) && (slow == 14), __FUNCTION__ , __LINE__, "Lapped cursor read is incorrect.");
+    check_condition(out_buffer[0] == in_buffer[4], __FUNCTION__ , __LINE__, "Lapped cursor read contents are incorrect.");
+
+    length = pv_circular_buffer_read_at(cb, &fast, out_buffer, 10);
+    check_condition((length == 8) && (fast == 14), __FUNCTION__ , __LINE__, "Cursor read is incorrect.");
+
+    pv_circular_buffer_delete(cb);
+}
+
+static void test_pv_circular_buffer_spsc_stress(void) {
+    pv_circular_buffer_t *cb;
+    pv_circular_buffer_status_t status = pv_circular_buffer_init(1024, sizeof(int32_t), &cb);
+    check_condition(status == PV_CIRCULAR_BUFFER_STATUS_SUCCESS, __FUNCTION__ , __LINE__, "Failed to initialize buffer.");
+
+    stress_context_t context = {cb, false};
+
+    pthread_t producer;
+    check_condition(
+            pthread_create(&producer, NULL, stress_producer, &context) == 0,
+            __FUNCTION__,
+            __LINE__,
+            "Failed to create producer thread.");
+
+    int32_t out_buffer[128];
+    int32_t last = -1;
+    int64_t received = 0;
+    while (true) {
+        const bool is_done = __atomic_load_n(&context.is_done, __ATOMIC_ACQUIRE);
+        const int32_t length = pv_circular_buffer_read(cb, out_buffer, 1 + (rand() % 128));
+        for (int32_t i = 0; i < length; i++) {
+            // elements may be dropped on overflow, but must never be repeated, reordered or torn
+            check_condition(
+                    out_buffer[i] > last,
+                    __FUNCTION__,
+                    __LINE__,
+                    "Read %d after %d.",
+                    out_buffer[i],
+                    last);
+            if (i > 0) {
+                check_condition(
+                        out_buffer[i] == (out_buffer[i - 1] + 1),
+                        __FUNCTION__,
+                        __LINE__,
+                        "Read is not contiguous at index %d: %d after %d.",
+                        i,
+                        out_buffer[i],
+                        out_buffer[i - 1]);
+            }
+            last = out_buffer[i];
+        }
+        received += length;
+        if (is_done && (length == 0)) {
+            break;
+        }
+    }
+
+    pthread_join(producer, NULL);
+
+    check_condition(
+            last == (STRESS_ELEMENT_COUNT - 1),
+            __FUNCTION__,
+            __LINE__,
+            "Expected last element to be %d, got %d.",
+            STRESS_ELEMENT_COUNT - 1,
+            last);
+    check_condition(received > 0, __FUNCTION__, __LINE__, "Consumer did not receive any elements.");
+
+    pv_circular_buffer_delete(cb);
+}
+
 int main() {
     srand(time(NULL));
 
@@ -195,6 +557,13 @@ int main() {
     test_pv_circular_buffer_read_write();
     test_pv_circular_buffer_read_write_one_by_one();
     test_pv_circular_buffer_zeros();
+    test_pv_circular_buffer_get_count();
+    test_pv_circular_buffer_peek_commit();
+    test_pv_circular_buffer_commit_overflow();
+    test_pv_circular_buffer_read_position();
+    test_pv_circular_buffer_read_history();
+    test_pv_circular_buffer_read_at();
+    test_pv_circular_buffer_spsc_stress();
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,228 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <math.h>
+#include <string.h>
+
+#include "pv_decimator.h"
+#include "test_helper.h"
+
+#define NUM_STAGES (2)
+
+static const double PI = 3.14159265358979323846;
+
+/**
+ * Runs `num_input_frames` of `input` through the decimator in chunks of random length and collects the output of
+ * every stage. Returns the number of frames of each stage in `num_frames`.
+ */
+static void decimate(
+        pv_decimator_t *decimator,
+        const float *input,
+        int32_t num_input_frames,
+        int32_t num_channels,
+        int32_t max_chunk_frames,
+        float **outputs,
+        int32_t *num_frames) {
+    for (int32_t s = 0; s <= NUM_STAGES; s++) {
+        num_frames[s] = 0;
+    }
+
+    int32_t i = 0;
+    while (i < num_input_frames) {
+        int32_t length = 1 + (rand() % max_chunk_frames);
+        if (length > (num_input_frames - i)) {
+            length = num_input_frames - i;
+        }
+        pv_decimator_process(decimator, input + (i * num_channels), length);
+        for (int32_t s = 0; s <= NUM_STAGES; s++) {
+            int32_t num_stage_frames = 0;
+            const float *stage_output = pv_decimator_get_output(decimator, s, &num_stage_frames);
+            memcpy(outputs[s] + (num_frames[s] * num_channels),
+                   stage_output,
+                   (size_t) num_stage_frames * (size_t) num_channels * sizeof(float));
+            num_frames[s] += num_stage_frames;
+        }
+        i += length;
+    }
+}
+
+static void test_pv_decimator_init(void) {
+    pv_decimator_t *decimator = NULL;
+
+    pv_decimator_status_t status = pv_decimator_init(0, NUM_STAGES, 256, &decimator);
+    check_condition(status == PV_DECIMATOR_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Accepted 0 channels.");
+
+    status = pv_decimator_init(1, 0, 256, &decimator);
+    check_condition(status == PV_DECIMATOR_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Accepted 0 stages.");
+
+    status = pv_decimator_init(1, NUM_STAGES, 0, &decimator);
+    check_condition(status == PV_DECIMATOR_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Accepted 0 frames.");
+
+    status = pv_decimator_init(1, NUM_STAGES, 256, NULL);
+    check_condition(status == PV_DECIMATOR_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Accepted NULL object.");
+
+    status = pv_decimator_init(2, NUM_STAGES, 255, &decimator);
+    check_condition(status == PV_DECIMATOR_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize decimator.");
+
+    const int32_t max_output_frames = pv_decimator_get_max_output_frames(decimator, NUM_STAGES);
+    check_condition(
+            max_output_frames == 64,
+            __FUNCTION__,
+            __LINE__,
+            "Maximum output of stage %d is %d - expected 64.",
+            NUM_STAGES,
+            max_output_frames);
+
+    pv_decimator_delete(decimator);
+}
+
+/**
+ * From 16kHz, a tone in the passband of a stage comes out at the same amplitude and time as the ideal tone at the
+ * stage's rate, and a tone above the stage's Nyquist frequency is removed.
+ */
+static void test_pv_decimator_tones(void) {
+    const int32_t num_input_frames = 16000;
+    const double frequencies[3] = {1000., 3000., 6000.};
+    float *input = malloc((size_t) num_input_frames * sizeof(float));
+    float *outputs[NUM_STAGES + 1];
+    for (int32_t s = 0; s <= NUM_STAGES; s++) {
+        outputs[s] = malloc((size_t) num_input_frames * sizeof(float));
+        check_condition(outputs[s] != NULL, __FUNCTION__, __LINE__, "Failed to allocate memory.");
+    }
+    check_condition(input != NULL, __FUNCTION__, __LINE__, "Failed to allocate memory.");
+
+    pv_decimator_t *decimator = NULL;
+    pv_decimator_status_t status = pv_decimator_init(1, NUM_STAGES, 256, &decimator);
+    check_condition(status == PV_DECIMATOR_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize decimator.");
+
+    for (int32_t t = 0; t < 3; t++) {
+        for (int32_t i = 0; i < num_input_frames; i++) {
+            input[i] = (float) (0.5 * sin(2. * PI * frequencies[t] * (double) i / 16000.));
+        }
+
+        pv_decimator_reset(decimator);
+        int32_t num_frames[NUM_STAGES + 1];
+        decimate(decimator, input, num_input_frames, 1, 256, outputs, num_frames);
+
+        for (int32_t s = 1; s <= NUM_STAGES; s++) {
+            const int32_t sample_rate = 16000 >> s;
+            const int32_t expected_num_frames = num_input_frames >> s;
+            check_condition(
+                    (num_frames[s] <= expected_num_frames) && (num_frames[s] > (expected_num_frames - 50)),
+                    __FUNCTION__,
+                    __LINE__,
+                    "Stage %d produced %d frames - expected about %d.",
+                    s,
+                    num_frames[s],
+                    expected_num_frames);
+
+            const bool is_passband = frequencies[t] < (0.85 * (sample_rate / 2));
+            const bool is_stopband = frequencies[t] > (1.15 * (sample_rate / 2));
+            if (!is_passband && !is_stopband) {
+                continue;
+            }
+
+            // Skips the start, where the filters run over the silence before the first sample.
+            double max_error = 0.;
+            for (int32_t i = 100; i < num_frames[s]; i++) {
+                const double expected = is_passband ?
+                        (0.5 * sin(2. * PI * frequencies[t] * (double) i / (double) sample_rate)) :
+                        0.;
+                const double error = fabs((double) outputs[s][i] - expected);
+                if (error > max_error) {
+                    max_error = error;
+                }
+            }
+            check_condition(
+                    max_error < 1e-4,
+                    __FUNCTION__,
+                    __LINE__,
+                    "Error of %g for a %gHz tone at %dHz.",
+                    max_error,
+                    frequencies[t],
+                    sample_rate);
+        }
+    }
+
+    pv_decimator_delete(decimator);
+    free(input);
+    for (int32_t s = 0; s <= NUM_STAGES; s++) {
+        free(outputs[s]);
+    }
+}
+
+/**
+ * The output does not depend on how the input is split into blocks, and channels are filtered independently.
+ */
+static void test_pv_decimator_blocks_and_channels(void) {
+    const int32_t num_input_frames = 3000;
+    float input[2 * 3000];
+    float mono_input[3000];
+    float stereo_outputs[NUM_STAGES + 1][2 * 3000];
+    float mono_outputs[NUM_STAGES + 1][3000];
+    float *outputs[NUM_STAGES + 1];
+    float *mono_output_pointers[NUM_STAGES + 1];
+    for (int32_t s = 0; s <= NUM_STAGES; s++) {
+        outputs[s] = stereo_outputs[s];
+        mono_output_pointers[s] = mono_outputs[s];
+    }
+
+    for (int32_t i = 0; i < num_input_frames; i++) {
+        input[2 * i] = (float) ((rand() % 2001) - 1000) / 1000.f;
+        input[(2 * i) + 1] = (float) ((rand() % 2001) - 1000) / 1000.f;
+        mono_input[i] = input[(2 * i) + 1];
+    }
+
+    pv_decimator_t *decimator = NULL;
+    pv_decimator_t *mono_decimator = NULL;
+    pv_decimator_status_t status = pv_decimator_init(2, NUM_STAGES, 300, &decimator);
+    check_condition(status == PV_DECIMATOR_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize decimator.");
+    status = pv_decimator_init(1, NUM_STAGES, 1, &mono_decimator);
+    check_condition(status == PV_DECIMATOR_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize decimator.");
+
+    int32_t num_frames[NUM_STAGES + 1];
+    int32_t num_mono_frames[NUM_STAGES + 1];
+    decimate(decimator, input, num_input_frames, 2, 300, outputs, num_frames);
+    decimate(mono_decimator, mono_input, num_input_frames, 1, 1, mono_output_pointers, num_mono_frames);
+
+    for (int32_t s = 1; s <= NUM_STAGES; s++) {
+        check_condition(
+                num_frames[s] == num_mono_frames[s],
+                __FUNCTION__,
+                __LINE__,
+                "Stage %d produced %d and %d frames from the same input.",
+                s,
+                num_frames[s],
+                num_mono_frames[s]);
+        for (int32_t i = 0; i < num_frames[s]; i++) {
+            check_condition(
+                    outputs[s][(2 * i) + 1] == mono_outputs[s][i],
+                    __FUNCTION__,
+                    __LINE__,
+                    "Frame %d of stage %d differs between block sizes.",
+                    i,
+                    s);
+        }
+    }
+
+    pv_decimator_delete(decimator);
+    pv_decimator_delete(mono_decimator);
+}
+
+int main() {
+    srand(time(NULL));
+
+    test_pv_decimator_init();
+    test_pv_decimator_tones();
+    test_pv_decimator_blocks_and_channels();
+
+    return 0;
+}
@@ -0,0 +1,165 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <math.h>
+
+#include "pv_level_meter.h"
+#include "test_helper.h"
+
+static bool is_close(double a, double b) {
+    return fabs(a - b) <= (1e-6 * (fabs(a) + fabs(b) + 1e-9));
+}
+
+static void test_pv_level_meter_s16(void) {
+    int16_t pcm[1031];
+
+    for (int32_t num_samples = 0; num_samples <= 1031; num_samples += ((num_samples < 40) ? 1 : 97)) {
+        int32_t expected_peak = 0;
+        double expected_sum_squares = 0.;
+        int32_t expected_num_clipped = 0;
+        for (int32_t i = 0; i < num_samples; i++) {
+            pcm[i] = (int16_t) ((rand() % 65536) - 32768);
+            if ((i % 13) == 0) {
+                pcm[i] = (i % 2) ? INT16_MIN : INT16_MAX;
+            }
+            const int32_t magnitude = abs(pcm[i]);
+            if (magnitude > expected_peak) {
+                expected_peak = magnitude;
+            }
+            expected_sum_squares += (double) pcm[i] * (double) pcm[i];
+            if ((pcm[i] == INT16_MAX) || (pcm[i] == INT16_MIN)) {
+                expected_num_clipped++;
+            }
+        }
+
+        pv_level_meter_result_t result = {0};
+        pv_level_meter_measure_s16(pcm, num_samples, &result);
+
+        check_condition(
+                result.num_samples == num_samples,
+                __FUNCTION__,
+                __LINE__,
+                "Level meter counted %d samples - expected %d.",
+                result.num_samples,
+                num_samples);
+        check_condition(
+                result.peak == ((float) expected_peak / 32768.f),
+                __FUNCTION__,
+                __LINE__,
+                "Level meter peak is incorrect for %d samples.",
+                num_samples);
+        check_condition(
+                is_close(result.sum_squares, expected_sum_squares / (32768. * 32768.)),
+                __FUNCTION__,
+                __LINE__,
+                "Level meter sum of squares is incorrect for %d samples.",
+                num_samples);
+        check_condition(
+                result.num_clipped == expected_num_clipped,
+                __FUNCTION__,
+                __LINE__,
+                "Level meter counted %d clipped samples - expected %d.",
+                result.num_clipped,
+                expected_num_clipped);
+    }
+}
+
+static void test_pv_level_meter_s16_accumulate(void) {
+    int16_t pcm[64];
+    for (int32_t i = 0; i < 64; i++) {
+        pcm[i] = (int16_t) ((i < 32) ? 1000 : -2000);
+    }
+
+    pv_level_meter_result_t whole = {0};
+    pv_level_meter_measure_s16(pcm, 64, &whole);
+
+    pv_level_meter_result_t pieces = {0};
+    pv_level_meter_measure_s16(pcm, 32, &pieces);
+    pv_level_meter_measure_s16(pcm + 32, 32, &pieces);
+
+    check_condition(
+            (whole.peak == pieces.peak) &&
+            is_close(whole.sum_squares, pieces.sum_squares) &&
+            (whole.num_samples == pieces.num_samples),
+            __FUNCTION__,
+            __LINE__,
+            "Level meter results differ when measured in pieces.");
+}
+
+static void test_pv_level_meter_s32(void) {
+    const int32_t pcm[] = {0, 8388607, -8388608, 4194304, -4194304};
+    const int32_t num_samples = sizeof(pcm) / sizeof(pcm[0]);
+
+    pv_level_meter_result_t result = {0};
+    pv_level_meter_measure_s32(pcm, num_samples, 24, &result);
+
+    check_condition(result.peak == 1.f, __FUNCTION__, __LINE__, "Level meter peak is incorrect.");
+    check_condition(
+            is_close(result.sum_squares, ((8388607. * 8388607.) / (8388608. * 8388608.)) + 1. + 0.25 + 0.25),
+            __FUNCTION__,
+            __LINE__,
+            "Level meter sum of squares is incorrect.");
+    check_condition(result.num_clipped == 2, __FUNCTION__, __LINE__, "Level meter clipped count is incorrect.");
+}
+
+static void test_pv_level_meter_f32(void) {
+    float pcm[103];
+
+    for (int32_t num_samples = 0; num_samples <= 103; num_samples++) {
+        float expected_peak = 0.f;
+        double expected_sum_squares = 0.;
+        int32_t expected_num_clipped = 0;
+        for (int32_t i = 0; i < num_samples; i++) {
+            pcm[i] = ((float) rand() / (float) RAND_MAX) * 2.2f - 1.1f;
+            if (fabsf(pcm[i]) > expected_peak) {
+                expected_peak = fabsf(pcm[i]);
+            }
+            expected_sum_squares += (double) pcm[i] * (double) pcm[i];
+            if (fabsf(pcm[i]) >= 1.f) {
+                expected_num_clipped++;
+            }
+        }
+
+        pv_level_meter_result_t result = {0};
+        pv_level_meter_measure_f32(pcm, num_samples, &result);
+
+        check_condition(
+                result.peak == expected_peak,
+                __FUNCTION__,
+                __LINE__,
+                "Level meter peak is incorrect for %d samples.",
+                num_samples);
+        check_condition(
+                fabs(result.sum_squares - expected_sum_squares) <= (1e-5 * (expected_sum_squares + 1.)),
+                __FUNCTION__,
+                __LINE__,
+                "Level meter sum of squares is incorrect for %d samples.",
+                num_samples);
+        check_condition(
+                result.num_clipped == expected_num_clipped,
+                __FUNCTION__,
+                __LINE__,
+                "Level meter counted %d clipped samples - expected %d.",
+                result.num_clipped,
+                expected_num_clipped);
+    }
+}
+
+int main() {
+    srand(time(NULL));
+
+    test_pv_level_meter_s16();
+    test_pv_level_meter_s16_accumulate();
+    test_pv_level_meter_s32();
+    test_pv_level_meter_f32();
+
+    return 0;
+}
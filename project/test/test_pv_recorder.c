@@ -9,7 +9,16 @@
     specific language governing permissions and limitations under the License.
 */
 
+#include <pthread.h>
+
 #include "string.h"
+#include "time.h"
+
+#if defined(__PV_RECORDER_PLATFORM_LINUX__) || defined(__PV_RECORDER_PLATFORM_RASPBERRYPI__)
+
+#include <poll.h>
+
+#endif
 
 #include "pv_recorder.h"
 #include "test_helper.h"
@@ -63,6 +72,209 @@ static void test_pv_recorder_init(void) {
             pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
 }
 
+static void test_pv_recorder_init_ex(void) {
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_status_t status;
+    pv_recorder_options_t options = pv_recorder_options_init();
+
+    printf("Initialize with null options\n");
+    status = pv_recorder_init_ex(512, 0, 10, NULL, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    printf("Initialize with invalid number of channels\n");
+    options.num_channels = -1;
+    status = pv_recorder_init_ex(512, 0, 10, &options, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    printf("Initialize with invalid sample format\n");
+    options = pv_recorder_options_init();
+    options.sample_format = (pv_recorder_sample_format_t) 100;
+    status = pv_recorder_init_ex(512, 0, 10, &options, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    printf("Initialize with 48kHz stereo float\n");
+    options = pv_recorder_options_init();
+    options.sample_rate = 48000;
+    options.num_channels = 2;
+    options.sample_format = PV_RECORDER_SAMPLE_FORMAT_F32;
+    status = pv_recorder_init_ex(512, 0, 10, &options, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    check_condition(
+            (pv_recorder_get_sample_rate(recorder) == 48000) &&
+            (pv_recorder_get_num_channels(recorder) == 2) &&
+            (pv_recorder_get_sample_format(recorder) == PV_RECORDER_SAMPLE_FORMAT_F32),
+            __FUNCTION__,
+            __LINE__,
+            "Recorder audio format does not match the options.");
+
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call read with a non 16-bit format\n");
+    int16_t frame[512];
+    status = pv_recorder_read(recorder, frame);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+    printf("Call read_pcm with a non 16-bit format\n");
+    float pcm[512 * 2];
+    status = pv_recorder_read_pcm(recorder, pcm);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read_pcm returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    for (int32_t i = 0; i < (512 * 2); i++) {
+        check_condition(
+                (pcm[i] >= -1.f) && (pcm[i] <= 1.f),
+                __FUNCTION__,
+                __LINE__,
+                "Sample %d is out of range.",
+                i);
+    }
+
+    pv_recorder_delete(recorder);
+
+    printf("Initialize with the native rate and channels\n");
+    options = pv_recorder_options_init();
+    options.sample_rate = 0;
+    options.num_channels = 0;
+    options.sample_format = PV_RECORDER_SAMPLE_FORMAT_S24_32;
+    status = pv_recorder_init_ex(512, 0, 10, &options, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    check_condition(
+            (pv_recorder_get_sample_rate(recorder) > 0) && (pv_recorder_get_num_channels(recorder) > 0),
+            __FUNCTION__,
+            __LINE__,
+            "Recorder did not resolve the native audio format.");
+
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call read_pcm with 24-bit samples\n");
+    const int32_t num_samples = 512 * pv_recorder_get_num_channels(recorder);
+    int32_t *samples = malloc(num_samples * sizeof(int32_t));
+    status = pv_recorder_read_pcm(recorder, samples);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read_pcm returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    for (int32_t i = 0; i < num_samples; i++) {
+        check_condition(
+                (samples[i] >= -8388608) && (samples[i] <= 8388607),
+                __FUNCTION__,
+                __LINE__,
+                "Sample %d is not a 24-bit value.",
+                i);
+    }
+    free(samples);
+
+    pv_recorder_delete(recorder);
+    recorder = NULL;
+
+    printf("Initialize with an invalid period configuration\n");
+    options = pv_recorder_options_init();
+    options.period_length = -1;
+    status = pv_recorder_init_ex(512, 0, 10, &options, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    options = pv_recorder_options_init();
+    options.performance_profile = (pv_recorder_performance_profile_t) 100;
+    status = pv_recorder_init_ex(512, 0, 10, &options, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    printf("Initialize with the period aligned to the frame\n");
+    options = pv_recorder_options_init();
+    options.num_periods = 2;
+    options.is_period_aligned_to_frame = true;
+    status = pv_recorder_init_ex(256, 0, 10, &options, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    int32_t period_length = 0;
+    int32_t num_periods = 0;
+    status = pv_recorder_get_period(recorder, &period_length, &num_periods);
+    check_condition(
+            (status == PV_RECORDER_STATUS_SUCCESS) && (period_length > 0) && (num_periods > 0),
+            __FUNCTION__,
+            __LINE__,
+            "Recorder get_period returned %s with %d samples and %d periods.",
+            pv_recorder_status_to_string(status),
+            period_length,
+            num_periods);
+
+    pv_recorder_delete(recorder);
+}
+
 static void test_pv_recorder_start_stop(void) {
     pv_recorder_t *recorder = NULL;
     pv_recorder_status_t status;
@@ -192,9 +404,14 @@ static void test_pv_recorder_start_stop(void) {
     pv_recorder_delete(recorder);
 }
 
-static void test_pv_recorder_set_debug_logging(void) {
+static void test_pv_recorder_read_with_info(void) {
     pv_recorder_t *recorder = NULL;
-    pv_recorder_status_t status = pv_recorder_init(512, 0, 10, &recorder);
+    pv_recorder_status_t status;
+    int16_t frame[512];
+    pv_recorder_frame_info_t info;
+    pv_recorder_frame_info_t previous_info;
+
+    status = pv_recorder_init(512, 0, 10, &recorder);
     check_condition(
             status == PV_RECORDER_STATUS_SUCCESS,
             __FUNCTION__,
@@ -203,82 +420,2544 @@ static void test_pv_recorder_set_debug_logging(void) {
             pv_recorder_status_to_string(status),
             pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
 
-    pv_recorder_set_debug_logging(NULL, true);
-    pv_recorder_set_debug_logging(recorder, true);
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
 
-    pv_recorder_delete(recorder);
-}
+    printf("Call read_with_info with null info\n");
+    status = pv_recorder_read_with_info(recorder, frame, NULL);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read_with_info returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
 
-static void test_pv_recorder_get_selected_device(void) {
-    pv_recorder_t *recorder = NULL;
-    pv_recorder_status_t status = pv_recorder_init(512, 0, 10, &recorder);
+    printf("Call read_with_info with valid args\n");
+    status = pv_recorder_read_with_info(recorder, frame, &previous_info);
     check_condition(
             status == PV_RECORDER_STATUS_SUCCESS,
             __FUNCTION__,
             __LINE__,
-            "Recorder initialization returned %s - expected %s.",
+            "Recorder read_with_info returned %s - expected %s.",
             pv_recorder_status_to_string(status),
             pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
 
+    for (int32_t i = 0; i < 3; i++) {
+        status = pv_recorder_read_with_info(recorder, frame, &info);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder read_with_info returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+        check_condition(
+                (info.dropped_samples == 0) && (info.sample_index == (previous_info.sample_index + 512)),
+                __FUNCTION__,
+                __LINE__,
+                "Frames are not contiguous.");
+        check_condition(
+                info.timestamp_ns > previous_info.timestamp_ns,
+                __FUNCTION__,
+                __LINE__,
+                "Frame timestamps are not increasing.");
+        previous_info = info;
+    }
+
+    printf("Call read_with_info after an overflow\n");
+    const time_t deadline = time(NULL) + 2;
+    while (time(NULL) < deadline) {
+        continue;
+    }
+    status = pv_recorder_read_with_info(recorder, frame, &info);
     check_condition(
-            pv_recorder_get_selected_device(NULL) == NULL,
+            status == PV_RECORDER_STATUS_SUCCESS,
             __FUNCTION__,
             __LINE__,
-            "pv_recorder_get_selected_device should have returned NULL.");
+            "Recorder read_with_info returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    check_condition(
+            (info.dropped_samples > 0) &&
+            (info.sample_index == (previous_info.sample_index + 512 + info.dropped_samples)),
+            __FUNCTION__,
+            __LINE__,
+            "Dropped samples were not reported.");
 
+    status = pv_recorder_stop(recorder);
     check_condition(
-            strcmp(pv_recorder_get_selected_device(recorder), "") != 0,
+            status == PV_RECORDER_STATUS_SUCCESS,
             __FUNCTION__,
             __LINE__,
-            "pv_recorder_get_selected_device should have returned a device name");
+            "Recorder stop returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
 
     pv_recorder_delete(recorder);
 }
 
-static void test_pv_recorder_get_available_devices(void) {
+static void test_pv_recorder_read_frames(void) {
+    pv_recorder_t *recorder = NULL;
     pv_recorder_status_t status;
-    int32_t device_list_length = -1;
-    char **device_list = NULL;
+    int16_t pcm[4 * 512];
+    int32_t num_frames_read = 0;
 
-    status = pv_recorder_get_available_devices(NULL, &device_list);
+    status = pv_recorder_init(512, 0, 10, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call read_frames with more frames than are buffered\n");
+    status = pv_recorder_read_frames(recorder, pcm, 11, true, &num_frames_read);
     check_condition(
             status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
             __FUNCTION__,
             __LINE__,
-            "pv_recorder_get_available_devices returned %s - expected %s.",
+            "Recorder read_frames returned %s - expected %s.",
             pv_recorder_status_to_string(status),
             pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
 
-    status = pv_recorder_get_available_devices(&device_list_length, NULL);
+    printf("Call read_frames waiting for a full buffer\n");
+    status = pv_recorder_read_frames(recorder, pcm, 10, true, &num_frames_read);
     check_condition(
             status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
             __FUNCTION__,
             __LINE__,
-            "pv_recorder_get_available_devices returned %s - expected %s.",
+            "Recorder read_frames returned %s - expected %s.",
             pv_recorder_status_to_string(status),
             pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
 
-    status = pv_recorder_get_available_devices(&device_list_length, &device_list);
+    printf("Call read_frames waiting for all frames\n");
+    status = pv_recorder_read_frames(recorder, pcm, 4, true, &num_frames_read);
+    check_condition(
+            (status == PV_RECORDER_STATUS_SUCCESS) && (num_frames_read == 4),
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read_frames returned %s with %d frames - expected %s with 4 frames.",
+            pv_recorder_status_to_string(status),
+            num_frames_read,
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call read_frames returning available frames\n");
+    status = pv_recorder_read_frames(recorder, pcm, 4, false, &num_frames_read);
+    check_condition(
+            (status == PV_RECORDER_STATUS_SUCCESS) && (num_frames_read >= 1) && (num_frames_read <= 4),
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read_frames returned %s with %d frames - expected %s with 1 to 4 frames.",
+            pv_recorder_status_to_string(status),
+            num_frames_read,
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    pv_recorder_stop(recorder);
+    pv_recorder_delete(recorder);
+}
+
+static void test_pv_recorder_read_after_overflow(void) {
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_status_t status;
+    int16_t pcm[2 * 512];
+    int32_t num_frames_read = 0;
+    pv_recorder_frame_info_t info;
+    uint64_t num_dropped_samples = 0;
+
+    status = pv_recorder_init(512, 0, 4, &recorder);
     check_condition(
             status == PV_RECORDER_STATUS_SUCCESS,
             __FUNCTION__,
             __LINE__,
-            "pv_recorder_get_available_devices returned %s - expected %s.",
+            "Recorder initialization returned %s - expected %s.",
             pv_recorder_status_to_string(status),
             pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    status = pv_recorder_start(recorder);
     check_condition(
-            device_list_length >= 0,
+            status == PV_RECORDER_STATUS_SUCCESS,
             __FUNCTION__,
             __LINE__,
-            "device_list_length should have been greater than 0, instead got %d",
-            device_list_length);
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    // The buffer holds 128ms, so every delay overflows it, and the callback period need not divide the frame length.
+    printf("Call read and read_frames after overflows\n");
+    const struct timespec delay = {.tv_sec = 0, .tv_nsec = 300000000};
+    for (int32_t i = 0; i < 3; i++) {
+        nanosleep(&delay, NULL);
+        status = pv_recorder_read_with_info(recorder, pcm, &info);
+        check_condition(
+                (status == PV_RECORDER_STATUS_SUCCESS) && (info.dropped_samples > 0) &&
+                ((info.sample_index % 512) == 0),
+                __FUNCTION__,
+                __LINE__,
+                "Recorder read_with_info returned %s at sample %llu after %llu dropped - expected %s at a frame start.",
+                pv_recorder_status_to_string(status),
+                (unsigned long long) info.sample_index,
+                (unsigned long long) info.dropped_samples,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+        num_dropped_samples += info.dropped_samples;
+
+        nanosleep(&delay, NULL);
+        status = pv_recorder_read_frames(recorder, pcm, 2, true, &num_frames_read);
+        check_condition(
+                (status == PV_RECORDER_STATUS_SUCCESS) && (num_frames_read == 2),
+                __FUNCTION__,
+                __LINE__,
+                "Recorder read_frames returned %s with %d frames - expected %s with 2 frames.",
+                pv_recorder_status_to_string(status),
+                num_frames_read,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+        const uint64_t sample_index = info.sample_index;
+        status = pv_recorder_read_with_info(recorder, pcm, &info);
+        check_condition(
+                (status == PV_RECORDER_STATUS_SUCCESS) && ((info.sample_index % 512) == 0) &&
+                (info.sample_index >= (sample_index + (3 * 512))),
+                __FUNCTION__,
+                __LINE__,
+                "Recorder read_with_info returned %s at sample %llu - expected %s at a frame boundary.",
+                pv_recorder_status_to_string(status),
+                (unsigned long long) info.sample_index,
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+        num_dropped_samples += info.dropped_samples;
+    }
+
+    // Samples skipped to reach a frame boundary are lost to the reader as much as overwritten ones.
+    pv_recorder_stats_t stats;
+    status = pv_recorder_get_stats(recorder, &stats);
     check_condition(
-            device_list != NULL,
+            (status == PV_RECORDER_STATUS_SUCCESS) && (stats.dropped_samples >= num_dropped_samples),
             __FUNCTION__,
             __LINE__,
-            "device_list should have not been NULL");
+            "Recorder stats count %llu dropped samples - expected at least the %llu reported by reads.",
+            (unsigned long long) stats.dropped_samples,
+            (unsigned long long) num_dropped_samples);
 
-    pv_recorder_free_available_devices(device_list_length, device_list);
+    pv_recorder_stop(recorder);
+    pv_recorder_delete(recorder);
+}
+
+static void test_pv_recorder_read_float(void) {
+    const pv_recorder_sample_format_t sample_formats[3] = {
+            PV_RECORDER_SAMPLE_FORMAT_S16,
+            PV_RECORDER_SAMPLE_FORMAT_S24_32,
+            PV_RECORDER_SAMPLE_FORMAT_F32,
+    };
+    float pcm[2 * 512];
+
+    for (int32_t i = 0; i < 3; i++) {
+        pv_recorder_t *recorder = NULL;
+        pv_recorder_options_t options = pv_recorder_options_init();
+        options.num_channels = 2;
+        options.sample_format = sample_formats[i];
+        pv_recorder_status_t status = pv_recorder_init_ex(512, 0, 10, &options, &recorder);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder initialization returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+        printf("Call read_float before start\n");
+        status = pv_recorder_read_float(recorder, pcm);
+        check_condition(
+                status == PV_RECORDER_STATUS_INVALID_STATE,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder read_float returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+        status = pv_recorder_start(recorder);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder start returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+        printf("Call read_float with null buffer\n");
+        status = pv_recorder_read_float(recorder, NULL);
+        check_condition(
+                status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder read_float returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+        printf("Call read_float with sample format %d\n", (int32_t) sample_formats[i]);
+        for (int32_t j = 0; j < 3; j++) {
+            status = pv_recorder_read_float(recorder, pcm);
+            check_condition(
+                    status == PV_RECORDER_STATUS_SUCCESS,
+                    __FUNCTION__,
+                    __LINE__,
+                    "Recorder read_float returned %s - expected %s.",
+                    pv_recorder_status_to_string(status),
+                    pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+            for (int32_t k = 0; k < (2 * 512); k++) {
+                check_condition(
+                        (pcm[k] >= -1.f) && (pcm[k] <= 1.f),
+                        __FUNCTION__,
+                        __LINE__,
+                        "Sample %d is %f - expected a value in [-1, 1].",
+                        k,
+                        pcm[k]);
+            }
+        }
+
+        pv_recorder_stop(recorder);
+        pv_recorder_delete(recorder);
+    }
+}
+
+static void test_pv_recorder_resampler(void) {
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_options_t options = pv_recorder_options_init();
+    options.resampler = (pv_recorder_resampler_t) (PV_RECORDER_RESAMPLER_POLYPHASE_HIGH + 1);
+    printf("Call init_ex with invalid resampler\n");
+    pv_recorder_status_t status = pv_recorder_init_ex(512, 0, 10, &options, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    options = pv_recorder_options_init();
+    options.resampler = PV_RECORDER_RESAMPLER_POLYPHASE_LOW;
+    options.is_period_aligned_to_frame = true;
+    printf("Call init_ex with a resampler and a frame-aligned period\n");
+    status = pv_recorder_init_ex(512, 0, 10, &options, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    const pv_recorder_sample_format_t sample_formats[2] = {
+            PV_RECORDER_SAMPLE_FORMAT_S16,
+            PV_RECORDER_SAMPLE_FORMAT_F32,
+    };
+    float pcm[512];
+
+    for (int32_t i = 0; i < 2; i++) {
+        options = pv_recorder_options_init();
+        options.sample_format = sample_formats[i];
+        options.resampler = PV_RECORDER_RESAMPLER_POLYPHASE_HIGH;
+        status = pv_recorder_init_ex(512, 0, 10, &options, &recorder);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder initialization returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+        pv_recorder_device_format_t device_format;
+        bool is_conversion_needed = false;
+        status = pv_recorder_get_device_format(recorder, &device_format, &is_conversion_needed);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder get_device_format returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+        if (device_format.sample_rate != 16000) {
+            check_condition(
+                    is_conversion_needed,
+                    __FUNCTION__,
+                    __LINE__,
+                    "Device captures at %d - expected conversion to be reported.",
+                    device_format.sample_rate);
+        }
+
+        status = pv_recorder_start(recorder);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder start returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+        printf("Call read_float with polyphase resampler and sample format %d\n", (int32_t) sample_formats[i]);
+        for (int32_t j = 0; j < 3; j++) {
+            status = pv_recorder_read_float(recorder, pcm);
+            check_condition(
+                    status == PV_RECORDER_STATUS_SUCCESS,
+                    __FUNCTION__,
+                    __LINE__,
+                    "Recorder read_float returned %s - expected %s.",
+                    pv_recorder_status_to_string(status),
+                    pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+            for (int32_t k = 0; k < 512; k++) {
+                check_condition(
+                        (pcm[k] >= -1.f) && (pcm[k] <= 1.f),
+                        __FUNCTION__,
+                        __LINE__,
+                        "Sample %d is %f - expected a value in [-1, 1].",
+                        k,
+                        pcm[k]);
+            }
+        }
+
+        // Restarting resets the filter history.
+        pv_recorder_stop(recorder);
+        status = pv_recorder_start(recorder);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder start returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+        status = pv_recorder_read_float(recorder, pcm);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder read_float returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+        pv_recorder_stop(recorder);
+        pv_recorder_delete(recorder);
+    }
+}
+
+static void test_pv_recorder_small_buffer(void) {
+    // Both the 24-bit conversion and the resampler write in chunks longer than this buffer.
+    const pv_recorder_sample_format_t sample_formats[2] = {
+            PV_RECORDER_SAMPLE_FORMAT_S24_32,
+            PV_RECORDER_SAMPLE_FORMAT_S16,
+    };
+    const pv_recorder_resampler_t resamplers[2] = {
+            PV_RECORDER_RESAMPLER_DEFAULT,
+            PV_RECORDER_RESAMPLER_POLYPHASE_LOW,
+    };
+    float pcm[32];
+
+    for (int32_t i = 0; i < 2; i++) {
+        pv_recorder_t *recorder = NULL;
+        pv_recorder_options_t options = pv_recorder_options_init();
+        options.sample_format = sample_formats[i];
+        options.resampler = resamplers[i];
+        pv_recorder_status_t status = pv_recorder_init_ex(32, 0, 1, &options, &recorder);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder initialization returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+        status = pv_recorder_start(recorder);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder start returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+        printf("Call read_float with a one-frame buffer, sample format %d and resampler %d\n",
+               (int32_t) sample_formats[i],
+               (int32_t) resamplers[i]);
+        for (int32_t j = 0; j < 3; j++) {
+            status = pv_recorder_read_float(recorder, pcm);
+            check_condition(
+                    status == PV_RECORDER_STATUS_SUCCESS,
+                    __FUNCTION__,
+                    __LINE__,
+                    "Recorder read_float returned %s - expected %s.",
+                    pv_recorder_status_to_string(status),
+                    pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+        }
+
+        pv_recorder_stop(recorder);
+        pv_recorder_delete(recorder);
+    }
+}
+
+static void test_pv_recorder_read_planar(void) {
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_options_t options = pv_recorder_options_init();
+    options.num_channels = 4;
+    pv_recorder_status_t status = pv_recorder_init_ex(512, 0, 10, &options, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    int16_t planar[4][512];
+    void *pcm[4] = {planar[0], planar[1], planar[2], planar[3]};
+
+    printf("Call read_planar before start\n");
+    status = pv_recorder_read_planar(recorder, NULL, 4, pcm);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read_planar returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    const int32_t out_of_range[2] = {0, 4};
+    const int32_t duplicate[2] = {1, 1};
+    const int32_t subset[2] = {3, 1};
+
+    printf("Call read_planar with invalid channels\n");
+    const pv_recorder_status_t invalid_statuses[5] = {
+            pv_recorder_read_planar(recorder, NULL, 4, NULL),
+            pv_recorder_read_planar(recorder, NULL, 0, pcm),
+            pv_recorder_read_planar(recorder, NULL, 5, pcm),
+            pv_recorder_read_planar(recorder, out_of_range, 2, pcm),
+            pv_recorder_read_planar(recorder, duplicate, 2, pcm),
+    };
+    for (int32_t i = 0; i < 5; i++) {
+        check_condition(
+                invalid_statuses[i] == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder read_planar returned %s - expected %s.",
+                pv_recorder_status_to_string(invalid_statuses[i]),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+    }
+
+    printf("Call read_planar with all channels\n");
+    status = pv_recorder_read_planar(recorder, NULL, 4, pcm);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read_planar returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call read_planar with a subset of channels\n");
+    status = pv_recorder_read_planar(recorder, subset, 2, pcm);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read_planar returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    pv_recorder_stop(recorder);
+    pv_recorder_delete(recorder);
+}
+
+static void test_pv_recorder_peek_release(void) {
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_status_t status;
+    const int16_t *frame = NULL;
+
+    status = pv_recorder_init(512, 0, 10, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call peek before start\n");
+    status = pv_recorder_peek(recorder, &frame);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder peek returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+    printf("Call release without peek\n");
+    status = pv_recorder_release(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder release returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call peek with null frame\n");
+    status = pv_recorder_peek(recorder, NULL);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder peek returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    printf("Call peek and release with valid args\n");
+    for (int32_t i = 0; i < 5; i++) {
+        status = pv_recorder_peek(recorder, &frame);
+        check_condition(
+                (status == PV_RECORDER_STATUS_SUCCESS) && (frame != NULL),
+                __FUNCTION__,
+                __LINE__,
+                "Recorder peek returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+        status = pv_recorder_release(recorder);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder release returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    }
+
+    printf("Call read while a frame is peeked\n");
+    int16_t pcm[512];
+    status = pv_recorder_peek(recorder, &frame);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder peek returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    status = pv_recorder_read(recorder, pcm);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+    status = pv_recorder_release(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder release returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    status = pv_recorder_read(recorder, pcm);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call release after stop\n");
+    status = pv_recorder_peek(recorder, &frame);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder peek returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    pv_recorder_stop(recorder);
+    status = pv_recorder_release(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder release returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+    pv_recorder_delete(recorder);
+}
+
+#if defined(__PV_RECORDER_PLATFORM_LINUX__) || defined(__PV_RECORDER_PLATFORM_RASPBERRYPI__)
+
+static void test_pv_recorder_get_fd(void) {
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_status_t status;
+    int16_t frame[512];
+    int32_t fd = -1;
+
+    status = pv_recorder_init(512, 0, 10, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call get_fd on null object\n");
+    status = pv_recorder_get_fd(NULL, &fd);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder get_fd returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    printf("Call get_fd with valid args\n");
+    status = pv_recorder_get_fd(recorder, &fd);
+    check_condition(
+            (status == PV_RECORDER_STATUS_SUCCESS) && (fd >= 0),
+            __FUNCTION__,
+            __LINE__,
+            "Recorder get_fd returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Poll fd and read frames\n");
+    for (int32_t i = 0; i < 5; i++) {
+        struct pollfd poll_fd = {.fd = fd, .events = POLLIN};
+        const int num_ready = poll(&poll_fd, 1, 2000);
+        check_condition(
+                (num_ready == 1) && (poll_fd.revents & POLLIN),
+                __FUNCTION__,
+                __LINE__,
+                "Recorder fd did not become readable.");
+
+        status = pv_recorder_read(recorder, frame);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder read returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    }
+
+    status = pv_recorder_stop(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder stop returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Poll fd after stop\n");
+    struct pollfd poll_fd = {.fd = fd, .events = POLLIN};
+    check_condition(
+            poll(&poll_fd, 1, 0) == 1,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder fd is not readable after stop.");
+
+    pv_recorder_delete(recorder);
+}
+
+#endif
+
+static void frame_callback(const int16_t *frame, void *user_data) {
+    (void) frame;
+    __atomic_add_fetch((int32_t *) user_data, 1, __ATOMIC_RELAXED);
+}
+
+static void test_pv_recorder_read_history(void) {
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_status_t status;
+    pv_recorder_options_t options = pv_recorder_options_init();
+    int16_t frame[512];
+    int16_t history[1024];
+
+    options.history_ms = 64;
+    status = pv_recorder_init_ex(512, 0, 10, &options, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call read_history with null pcm\n");
+    status = pv_recorder_read_history(recorder, NULL, 1024);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read_history returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    printf("Call read_history with more samples than kept\n");
+    status = pv_recorder_read_history(recorder, history, 1025);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read_history returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    for (int32_t i = 0; i < 3; i++) {
+        status = pv_recorder_read(recorder, frame);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder read returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    }
+
+    printf("Call read_history with valid args\n");
+    status = pv_recorder_read_history(recorder, history, 1024);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read_history returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    check_condition(
+            memcmp(history + 512, frame, sizeof(frame)) == 0,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder history does not end with the last frame read.");
+
+    status = pv_recorder_stop(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder stop returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    pv_recorder_delete(recorder);
+}
+
+static void test_pv_recorder_subscribe(void) {
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_subscriber_t *subscriber = NULL;
+    pv_recorder_subscriber_t *other_subscriber = NULL;
+    pv_recorder_status_t status;
+    int16_t frame[512];
+    int16_t other_frame[512];
+    uint64_t dropped_samples = 0;
+
+    status = pv_recorder_init(512, 0, 10, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call subscribe with invalid frame length\n");
+    status = pv_recorder_subscribe(recorder, 0, &subscriber);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder subscribe returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    printf("Call subscribe with valid args\n");
+    status = pv_recorder_subscribe(recorder, 512, &subscriber);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder subscribe returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    status = pv_recorder_subscribe(recorder, 256, &other_subscriber);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder subscribe returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call subscriber_read before start\n");
+    status = pv_recorder_subscriber_read(subscriber, frame);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder subscriber_read returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call subscribe while recording\n");
+    pv_recorder_subscriber_t *late_subscriber = NULL;
+    status = pv_recorder_subscribe(recorder, 512, &late_subscriber);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder subscribe returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+    printf("Call subscriber_read with valid args\n");
+    status = pv_recorder_subscriber_read(subscriber, frame);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder subscriber_read returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    for (int32_t i = 0; i < 2; i++) {
+        status = pv_recorder_subscriber_read(other_subscriber, other_frame + (i * 256));
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder subscriber_read returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    }
+    check_condition(
+            memcmp(frame, other_frame, sizeof(frame)) == 0,
+            __FUNCTION__,
+            __LINE__,
+            "Subscribers with different frame lengths read different audio.");
+
+    status = pv_recorder_read(recorder, other_frame);
+    check_condition(
+            (status == PV_RECORDER_STATUS_SUCCESS) && (memcmp(frame, other_frame, sizeof(frame)) == 0),
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read does not match the subscribers.");
+
+    status = pv_recorder_subscriber_get_dropped_samples(subscriber, &dropped_samples);
+    check_condition(
+            (status == PV_RECORDER_STATUS_SUCCESS) && (dropped_samples == 0),
+            __FUNCTION__,
+            __LINE__,
+            "Recorder subscriber dropped %llu samples - expected none.",
+            (unsigned long long) dropped_samples);
+
+    // Leaves the subscribers at different positions when recording stops.
+    status = pv_recorder_subscriber_read(subscriber, frame);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder subscriber_read returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    status = pv_recorder_stop(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder stop returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call subscriber_read after stop\n");
+    status = pv_recorder_subscriber_read(other_subscriber, other_frame);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder subscriber_read returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call subscriber_read after restart\n");
+    status = pv_recorder_subscriber_read(subscriber, frame);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder subscriber_read returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    for (int32_t i = 0; i < 2; i++) {
+        status = pv_recorder_subscriber_read(other_subscriber, other_frame + (i * 256));
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder subscriber_read returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    }
+    // The audio left unread at the stop was discarded, so both subscribers start at the new recording.
+    check_condition(
+            memcmp(frame, other_frame, sizeof(frame)) == 0,
+            __FUNCTION__,
+            __LINE__,
+            "Subscribers read different audio after a restart.");
+
+    status = pv_recorder_subscriber_get_dropped_samples(other_subscriber, &dropped_samples);
+    check_condition(
+            (status == PV_RECORDER_STATUS_SUCCESS) && (dropped_samples == 0),
+            __FUNCTION__,
+            __LINE__,
+            "Recorder subscriber dropped %llu samples - expected none.",
+            (unsigned long long) dropped_samples);
+
+    status = pv_recorder_stop(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder stop returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call unsubscribe with valid args\n");
+    status = pv_recorder_unsubscribe(subscriber);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder unsubscribe returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    pv_recorder_delete(recorder);
+}
+
+static void test_pv_recorder_outputs(void) {
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_output_t *outputs[3] = {NULL, NULL, NULL};
+    const int32_t sample_rates[3] = {8000, 4000, 6000};
+    const int32_t frame_lengths[3] = {256, 128, 192};
+    pv_recorder_status_t status;
+    int16_t frame[512];
+    uint64_t dropped_samples = 0;
+
+    pv_recorder_options_t options = pv_recorder_options_init();
+    options.sample_format = PV_RECORDER_SAMPLE_FORMAT_F32;
+    status = pv_recorder_init_ex(512, 0, 10, &options, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call add_output with a float recorder\n");
+    status = pv_recorder_add_output(recorder, 8000, 256, &outputs[0]);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder add_output returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+    pv_recorder_delete(recorder);
+
+    status = pv_recorder_init(512, 0, 10, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call add_output with a rate above the recorder's\n");
+    status = pv_recorder_add_output(recorder, pv_recorder_get_sample_rate(recorder) + 1, 256, &outputs[0]);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder add_output returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    printf("Call add_output with invalid frame length\n");
+    status = pv_recorder_add_output(recorder, 8000, 0, &outputs[0]);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder add_output returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    printf("Call add_output with valid args\n");
+    for (int32_t i = 0; i < 3; i++) {
+        status = pv_recorder_add_output(recorder, sample_rates[i], frame_lengths[i], &outputs[i]);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder add_output returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    }
+
+    printf("Call output_read before start\n");
+    status = pv_recorder_output_read(outputs[0], frame);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder output_read returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+    for (int32_t run = 0; run < 2; run++) {
+        status = pv_recorder_start(recorder);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder start returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+        printf("Call output_read with valid args\n");
+        for (int32_t i = 0; i < 4; i++) {
+            status = pv_recorder_read(recorder, frame);
+            check_condition(
+                    status == PV_RECORDER_STATUS_SUCCESS,
+                    __FUNCTION__,
+                    __LINE__,
+                    "Recorder read returned %s - expected %s.",
+                    pv_recorder_status_to_string(status),
+                    pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+            for (int32_t j = 0; j < 3; j++) {
+                status = pv_recorder_output_read(outputs[j], frame);
+                check_condition(
+                        status == PV_RECORDER_STATUS_SUCCESS,
+                        __FUNCTION__,
+                        __LINE__,
+                        "Recorder output_read returned %s - expected %s.",
+                        pv_recorder_status_to_string(status),
+                        pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+            }
+        }
+
+        for (int32_t j = 0; j < 3; j++) {
+            status = pv_recorder_output_get_dropped_samples(outputs[j], &dropped_samples);
+            check_condition(
+                    (status == PV_RECORDER_STATUS_SUCCESS) && (dropped_samples == 0),
+                    __FUNCTION__,
+                    __LINE__,
+                    "Recorder output dropped %llu samples - expected none.",
+                    (unsigned long long) dropped_samples);
+        }
+
+        printf("Call remove_output while recording\n");
+        status = pv_recorder_remove_output(outputs[2]);
+        check_condition(
+                status == PV_RECORDER_STATUS_INVALID_STATE,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder remove_output returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+        status = pv_recorder_stop(recorder);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder stop returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+        // Audio buffered before the stop is discarded.
+        status = pv_recorder_output_read(outputs[0], frame);
+        check_condition(
+                status == PV_RECORDER_STATUS_INVALID_STATE,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder output_read returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+    }
+
+    printf("Call remove_output with valid args\n");
+    status = pv_recorder_remove_output(outputs[0]);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder remove_output returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    pv_recorder_delete(recorder);
+}
+
+#define DEQUEUE_STRESS_NUM_WORKERS (2)
+#define DEQUEUE_STRESS_NUM_SESSIONS (4)
+#define DEQUEUE_STRESS_MAX_FRAMES (256)
+
+typedef struct {
+    pv_recorder_t *recorder;
+    int32_t worker_id;
+    int32_t *session;
+    bool *is_done;
+    uint8_t claims[DEQUEUE_STRESS_NUM_SESSIONS][DEQUEUE_STRESS_MAX_FRAMES];
+    int32_t num_frames;
+    int32_t num_out_of_range;
+} dequeue_stress_context_t;
+
+static void *dequeue_stress_worker(void *data) {
+    dequeue_stress_context_t *context = (dequeue_stress_context_t *) data;
+    int16_t frame[512];
+
+    // Keeps calling dequeue across stop and start, as an application's worker pool would.
+    while (!__atomic_load_n(context->is_done, __ATOMIC_ACQUIRE)) {
+        const int32_t session = __atomic_load_n(context->session, __ATOMIC_ACQUIRE);
+        uint64_t sequence_number = 0;
+        pv_recorder_status_t status = pv_recorder_dequeue(
+                context->recorder,
+                context->worker_id,
+                frame,
+                &sequence_number);
+        if (status != PV_RECORDER_STATUS_SUCCESS) {
+            const struct timespec delay = {.tv_sec = 0, .tv_nsec = 1000000};
+            nanosleep(&delay, NULL);
+            continue;
+        }
+
+        // Only frames whose session is certain are checked.
+        if (session != __atomic_load_n(context->session, __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+        if (sequence_number >= DEQUEUE_STRESS_MAX_FRAMES) {
+            context->num_out_of_range++;
+            continue;
+        }
+        context->claims[session][sequence_number]++;
+        context->num_frames++;
+    }
+
+    return NULL;
+}
+
+static void test_pv_recorder_dequeue_stop_start(void) {
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_status_t status;
+    int16_t frame[512];
+    uint64_t sequence_number = 0;
+
+    status = pv_recorder_init(512, 0, 10, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    status = pv_recorder_set_num_workers(recorder, DEQUEUE_STRESS_NUM_WORKERS);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder set_num_workers returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call dequeue after stop with unclaimed frames\n");
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    status = pv_recorder_dequeue(recorder, 0, frame, &sequence_number);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder dequeue returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    const struct timespec delay = {.tv_sec = 0, .tv_nsec = 200000000};
+    nanosleep(&delay, NULL);
+    pv_recorder_stop(recorder);
+    status = pv_recorder_dequeue(recorder, 0, frame, &sequence_number);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder dequeue returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+    printf("Call stop and start with concurrent workers\n");
+    int32_t session = 0;
+    bool is_done = false;
+    dequeue_stress_context_t contexts[DEQUEUE_STRESS_NUM_WORKERS];
+    pthread_t workers[DEQUEUE_STRESS_NUM_WORKERS];
+    memset(contexts, 0, sizeof(contexts));
+    for (int32_t i = 0; i < DEQUEUE_STRESS_NUM_WORKERS; i++) {
+        contexts[i].recorder = recorder;
+        contexts[i].worker_id = i;
+        contexts[i].session = &session;
+        contexts[i].is_done = &is_done;
+        check_condition(
+                pthread_create(&workers[i], NULL, dequeue_stress_worker, &contexts[i]) == 0,
+                __FUNCTION__,
+                __LINE__,
+                "Failed to create worker thread.");
+    }
+
+    for (int32_t i = 0; i < DEQUEUE_STRESS_NUM_SESSIONS; i++) {
+        __atomic_store_n(&session, i, __ATOMIC_RELEASE);
+        status = pv_recorder_start(recorder);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder start returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+        nanosleep(&delay, NULL);
+        pv_recorder_stop(recorder);
+    }
+
+    __atomic_store_n(&is_done, true, __ATOMIC_RELEASE);
+    for (int32_t i = 0; i < DEQUEUE_STRESS_NUM_WORKERS; i++) {
+        pthread_join(workers[i], NULL);
+    }
+
+    int32_t num_frames = 0;
+    for (int32_t i = 0; i < DEQUEUE_STRESS_NUM_WORKERS; i++) {
+        num_frames += contexts[i].num_frames;
+        check_condition(
+                contexts[i].num_out_of_range == 0,
+                __FUNCTION__,
+                __LINE__,
+                "Worker %d got %d sequence numbers that did not restart at 0.",
+                i,
+                contexts[i].num_out_of_range);
+    }
+    check_condition(num_frames > 0, __FUNCTION__, __LINE__, "Workers did not dequeue any frames.");
+
+    // Every frame of a recording is handed to exactly one worker.
+    for (int32_t s = 0; s < DEQUEUE_STRESS_NUM_SESSIONS; s++) {
+        for (int32_t n = 0; n < DEQUEUE_STRESS_MAX_FRAMES; n++) {
+            int32_t num_claims = 0;
+            for (int32_t i = 0; i < DEQUEUE_STRESS_NUM_WORKERS; i++) {
+                num_claims += contexts[i].claims[s][n];
+            }
+            check_condition(
+                    num_claims <= 1,
+                    __FUNCTION__,
+                    __LINE__,
+                    "Frame %d of recording %d was dequeued %d times.",
+                    n,
+                    s,
+                    num_claims);
+        }
+    }
+
+    pv_recorder_delete(recorder);
+}
+
+static void test_pv_recorder_dequeue(void) {
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_status_t status;
+    int16_t frame[512];
+    uint64_t sequence_number = 0;
+
+    status = pv_recorder_init(512, 0, 10, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call set_num_workers with too many workers\n");
+    status = pv_recorder_set_num_workers(recorder, PV_RECORDER_MAX_WORKERS + 1);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder set_num_workers returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    printf("Call set_num_workers with valid args\n");
+    status = pv_recorder_set_num_workers(recorder, 2);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder set_num_workers returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call dequeue with invalid worker id\n");
+    status = pv_recorder_dequeue(recorder, 2, frame, &sequence_number);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder dequeue returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    printf("Call dequeue before start\n");
+    status = pv_recorder_dequeue(recorder, 0, frame, &sequence_number);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder dequeue returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call dequeue with valid args\n");
+    for (uint64_t i = 0; i < 4; i++) {
+        status = pv_recorder_dequeue(recorder, (int32_t) (i % 2), frame, &sequence_number);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder dequeue returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+        check_condition(
+                sequence_number == i,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder dequeue returned sequence number %llu - expected %llu.",
+                (unsigned long long) sequence_number,
+                (unsigned long long) i);
+    }
+
+    printf("Call set_num_workers while recording\n");
+    status = pv_recorder_set_num_workers(recorder, 0);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder set_num_workers returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+    status = pv_recorder_stop(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder stop returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    pv_recorder_delete(recorder);
+}
+
+static void test_pv_recorder_set_frame_callback(void) {
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_status_t status;
+    int16_t frame[512];
+    int32_t num_frames = 0;
+
+    status = pv_recorder_init(512, 0, 10, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call set_frame_callback on null object\n");
+    status = pv_recorder_set_frame_callback(NULL, frame_callback, &num_frames);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder set_frame_callback returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    printf("Call set_frame_callback with valid args\n");
+    status = pv_recorder_set_frame_callback(recorder, frame_callback, &num_frames);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder set_frame_callback returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call set_frame_callback while recording\n");
+    status = pv_recorder_set_frame_callback(recorder, NULL, NULL);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder set_frame_callback returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+    printf("Call read in push mode\n");
+    status = pv_recorder_read(recorder, frame);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+    printf("Wait for frames to be delivered\n");
+    const time_t deadline = time(NULL) + 5;
+    while ((__atomic_load_n(&num_frames, __ATOMIC_RELAXED) < 5) && (time(NULL) < deadline)) {
+        continue;
+    }
+    check_condition(
+            __atomic_load_n(&num_frames, __ATOMIC_RELAXED) >= 5,
+            __FUNCTION__,
+            __LINE__,
+            "Frame callback was called %d times - expected at least 5.",
+            num_frames);
+
+    status = pv_recorder_stop(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder stop returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    pv_recorder_delete(recorder);
+}
+
+static void test_pv_recorder_get_thread_config_status(void) {
+    pv_recorder_status_t status;
+    pv_recorder_t *recorder = NULL;
+
+    pv_recorder_options_t options = pv_recorder_options_init();
+    options.thread_priority = 100;
+    status = pv_recorder_init_ex(512, 0, 10, &options, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    options = pv_recorder_options_init();
+    options.thread_scheduling = PV_RECORDER_THREAD_SCHEDULING_FIFO;
+    options.thread_cpu_mask = 1;
+    status = pv_recorder_init_ex(512, 0, 10, &options, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    pv_recorder_thread_config_status_t config_status;
+    status = pv_recorder_get_thread_config_status(recorder, NULL);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder get_thread_config_status returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    int16_t frame[512];
+    status = pv_recorder_read(recorder, frame);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    // Whether the request succeeds depends on the privileges of the process, but once audio has been captured it has
+    // been attempted.
+    status = pv_recorder_get_thread_config_status(recorder, &config_status);
+    check_condition(
+            (status == PV_RECORDER_STATUS_SUCCESS) &&
+            (config_status.capture_scheduling != PV_RECORDER_THREAD_CONFIG_NOT_REQUESTED) &&
+            (config_status.capture_scheduling != PV_RECORDER_THREAD_CONFIG_PENDING) &&
+            (config_status.capture_affinity != PV_RECORDER_THREAD_CONFIG_NOT_REQUESTED) &&
+            (config_status.capture_affinity != PV_RECORDER_THREAD_CONFIG_PENDING) &&
+            (config_status.consumer_scheduling == PV_RECORDER_THREAD_CONFIG_NOT_REQUESTED),
+            __FUNCTION__,
+            __LINE__,
+            "Recorder thread configuration was not attempted.");
+
+#if defined(__PV_RECORDER_PLATFORM_DARWIN__)
+
+    // Core Audio runs the callback on its own audio thread, which must keep its scheduling.
+    check_condition(
+            config_status.capture_scheduling == PV_RECORDER_THREAD_CONFIG_UNSUPPORTED,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder configured the Core Audio thread.");
+
+#endif
+
+    pv_recorder_delete(recorder);
+}
+
+static void test_pv_recorder_drain_trace_log(void) {
+    pv_recorder_status_t status;
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_trace_event_t events[256];
+    int32_t num_events = 0;
+    uint64_t num_lost_events = 0;
+
+    status = pv_recorder_init(512, 0, 10, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    status = pv_recorder_drain_trace_log(recorder, events, 256, &num_events, &num_lost_events);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder drain_trace_log returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+    pv_recorder_delete(recorder);
+    recorder = NULL;
+
+    pv_recorder_options_t options = pv_recorder_options_init();
+    options.trace_log_length = 1024;
+    status = pv_recorder_init_ex(512, 0, 10, &options, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    const char *trace_path = "test_pv_recorder_trace.json";
+    remove(trace_path);
+
+    // Nothing has been traced before start, so this writes the header alone.
+    status = pv_recorder_write_trace_log(recorder, trace_path, PV_RECORDER_TRACE_FORMAT_CHROME_TRACE);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder write_trace_log returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    int16_t frame[512];
+    for (int32_t i = 0; i < 3; i++) {
+        status = pv_recorder_read(recorder, frame);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "Recorder read returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    }
+
+    status = pv_recorder_drain_trace_log(recorder, events, 256, &num_events, &num_lost_events);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder drain_trace_log returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    int32_t num_callbacks = 0;
+    int32_t num_reads = 0;
+    for (int32_t i = 0; i < num_events; i++) {
+        num_callbacks += events[i].type == PV_RECORDER_TRACE_EVENT_CALLBACK_BEGIN;
+        num_reads += events[i].type == PV_RECORDER_TRACE_EVENT_READ;
+    }
+    check_condition(
+            (num_callbacks > 0) && (num_reads == 3),
+            __FUNCTION__,
+            __LINE__,
+            "Trace has %d callbacks and %d reads - expected at least 1 and 3.",
+            num_callbacks,
+            num_reads);
+
+    status = pv_recorder_read(recorder, frame);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder read returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    status = pv_recorder_write_trace_log(recorder, trace_path, PV_RECORDER_TRACE_FORMAT_CHROME_TRACE);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder write_trace_log returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    char trace[4];
+    FILE *trace_file = fopen(trace_path, "rb");
+    const size_t trace_length = trace_file ? fread(trace, 1, sizeof(trace), trace_file) : 0;
+    if (trace_file) {
+        fclose(trace_file);
+    }
+    remove(trace_path);
+    check_condition(
+            (trace_length == sizeof(trace)) && (memcmp(trace, "[\n{\"", sizeof(trace)) == 0),
+            __FUNCTION__,
+            __LINE__,
+            "Trace does not start with its first event right after the header.");
+
+    status = pv_recorder_write_trace_log(recorder, NULL, PV_RECORDER_TRACE_FORMAT_CSV);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder write_trace_log returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    pv_recorder_delete(recorder);
+}
+
+static void test_pv_recorder_get_stats(void) {
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_status_t status;
+    int16_t frame[512];
+    pv_recorder_stats_t stats;
+
+    status = pv_recorder_init(512, 0, 10, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call get_stats with null stats\n");
+    status = pv_recorder_get_stats(recorder, NULL);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder get_stats returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    const int32_t num_reads = 5;
+    for (int32_t i = 0; i < num_reads; i++) {
+        pv_recorder_read(recorder, frame);
+    }
+
+    status = pv_recorder_stop(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder stop returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call get_stats with valid args\n");
+    status = pv_recorder_get_stats(recorder, &stats);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder get_stats returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    uint64_t num_periods = 0;
+    for (int32_t i = 0; i < PV_RECORDER_STATS_PERIOD_HISTOGRAM_SIZE; i++) {
+        num_periods += stats.period_size_histogram[i];
+    }
+    check_condition(
+            (stats.callback_count > 0) && (num_periods == stats.callback_count),
+            __FUNCTION__,
+            __LINE__,
+            "Period size histogram does not match callback count.");
+
+    uint64_t num_latencies = 0;
+    for (int32_t i = 0; i < PV_RECORDER_STATS_LATENCY_HISTOGRAM_SIZE; i++) {
+        num_latencies += stats.read_latency_histogram[i];
+    }
+    check_condition(
+            num_latencies == (uint64_t) num_reads,
+            __FUNCTION__,
+            __LINE__,
+            "Read latency histogram has %d entries - expected %d.",
+            (int32_t) num_latencies,
+            num_reads);
+
+    check_condition(
+            (stats.callback_duration_min_ns <= stats.callback_duration_avg_ns) &&
+            (stats.callback_duration_avg_ns <= stats.callback_duration_max_ns),
+            __FUNCTION__,
+            __LINE__,
+            "Callback durations are inconsistent.");
+    check_condition(
+            (stats.buffer_high_water_mark >= 512) && (stats.buffer_high_water_mark <= stats.buffer_capacity),
+            __FUNCTION__,
+            __LINE__,
+            "Buffer high-water mark %d is out of range.",
+            stats.buffer_high_water_mark);
+    check_condition(
+            (stats.overflow_count == 0) == (stats.dropped_samples == 0),
+            __FUNCTION__,
+            __LINE__,
+            "Overflow count %d does not match %d dropped samples.",
+            (int32_t) stats.overflow_count,
+            (int32_t) stats.dropped_samples);
+
+    pv_recorder_delete(recorder);
+}
+
+static void test_pv_recorder_get_level(void) {
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_status_t status;
+    int16_t frame[512];
+    pv_recorder_level_t level;
+
+    status = pv_recorder_init(512, 0, 10, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call get_level with null level\n");
+    status = pv_recorder_get_level(recorder, NULL);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder get_level returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    for (int32_t i = 0; i < 3; i++) {
+        pv_recorder_read(recorder, frame);
+    }
+
+    printf("Call get_level with valid args\n");
+    status = pv_recorder_get_level(recorder, &level);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder get_level returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    check_condition(
+            (level.peak >= 0.f) && (level.peak <= 1.f) && (level.rms >= 0.f) && (level.rms <= level.peak),
+            __FUNCTION__,
+            __LINE__,
+            "Recorder level is out of range: peak %f, rms %f.",
+            level.peak,
+            level.rms);
+
+    status = pv_recorder_stop(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder stop returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    pv_recorder_delete(recorder);
+}
+
+static void test_pv_recorder_set_vad_gate(void) {
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_status_t status;
+    pv_recorder_vad_gate_options_t options = pv_recorder_vad_gate_options_init();
+    pv_recorder_stats_t stats;
+
+    status = pv_recorder_init(512, 0, 10, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call set_vad_gate with null object\n");
+    status = pv_recorder_set_vad_gate(NULL, &options);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder set_vad_gate returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    printf("Call set_vad_gate with close threshold above open threshold\n");
+    options.close_threshold_db = options.open_threshold_db + 1.f;
+    status = pv_recorder_set_vad_gate(recorder, &options);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder set_vad_gate returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    printf("Call set_vad_gate with pre-roll longer than the buffer\n");
+    options = pv_recorder_vad_gate_options_init();
+    options.pre_roll_frames = 10;
+    status = pv_recorder_set_vad_gate(recorder, &options);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder set_vad_gate returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    printf("Call set_vad_gate with valid args\n");
+    options = pv_recorder_vad_gate_options_init();
+    status = pv_recorder_set_vad_gate(recorder, &options);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder set_vad_gate returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    status = pv_recorder_start(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder start returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call set_vad_gate while recording\n");
+    status = pv_recorder_set_vad_gate(recorder, NULL);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder set_vad_gate returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+    status = pv_recorder_stop(recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder stop returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    printf("Call set_vad_gate with null options\n");
+    status = pv_recorder_set_vad_gate(recorder, NULL);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder set_vad_gate returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    status = pv_recorder_get_stats(recorder, &stats);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder get_stats returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    pv_recorder_delete(recorder);
+}
+
+static void test_pv_recorder_set_debug_logging(void) {
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_status_t status = pv_recorder_init(512, 0, 10, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    pv_recorder_set_debug_logging(NULL, true);
+    pv_recorder_set_debug_logging(recorder, true);
+
+    pv_recorder_delete(recorder);
+}
+
+static void test_pv_recorder_get_selected_device(void) {
+    pv_recorder_t *recorder = NULL;
+    pv_recorder_status_t status = pv_recorder_init(512, 0, 10, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder initialization returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    check_condition(
+            pv_recorder_get_selected_device(NULL) == NULL,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_get_selected_device should have returned NULL.");
+
+    check_condition(
+            strcmp(pv_recorder_get_selected_device(recorder), "") != 0,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_get_selected_device should have returned a device name");
+
+    pv_recorder_delete(recorder);
+}
+
+static void test_pv_recorder_get_available_devices(void) {
+    pv_recorder_status_t status;
+    int32_t device_list_length = -1;
+    char **device_list = NULL;
+
+    status = pv_recorder_get_available_devices(NULL, &device_list);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_get_available_devices returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    status = pv_recorder_get_available_devices(&device_list_length, NULL);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_get_available_devices returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    status = pv_recorder_get_available_devices(&device_list_length, &device_list);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_get_available_devices returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    check_condition(
+            device_list_length >= 0,
+            __FUNCTION__,
+            __LINE__,
+            "device_list_length should have been greater than 0, instead got %d",
+            device_list_length);
+    check_condition(
+            device_list != NULL,
+            __FUNCTION__,
+            __LINE__,
+            "device_list should have not been NULL");
+
+    pv_recorder_free_available_devices(device_list_length, device_list);
+
+    const int32_t cached_device_list_length = device_list_length;
+
+    status = pv_recorder_refresh_available_devices();
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_refresh_available_devices returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    status = pv_recorder_get_available_devices(&device_list_length, &device_list);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_get_available_devices returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    check_condition(
+            device_list_length == cached_device_list_length,
+            __FUNCTION__,
+            __LINE__,
+            "device_list_length changed from %d to %d after refreshing",
+            cached_device_list_length,
+            device_list_length);
+
+    pv_recorder_free_available_devices(device_list_length, device_list);
+}
+
+static void test_pv_recorder_get_available_device_ids(void) {
+    pv_recorder_status_t status;
+    int32_t device_list_length = -1;
+    char **device_id_list = NULL;
+
+    status = pv_recorder_get_available_device_ids(NULL, &device_id_list);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_get_available_device_ids returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    status = pv_recorder_get_available_device_ids(&device_list_length, &device_id_list);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_get_available_device_ids returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    for (int32_t i = 0; i < device_list_length; i++) {
+        check_condition(
+                strchr(device_id_list[i], ':') != NULL,
+                __FUNCTION__,
+                __LINE__,
+                "Device ID '%s' has no backend prefix.",
+                device_id_list[i]);
+    }
+
+    pv_recorder_options_t options = pv_recorder_options_init();
+    pv_recorder_t *recorder = NULL;
+
+    if (device_list_length > 0) {
+        options.device_id = device_id_list[device_list_length - 1];
+        status = pv_recorder_init_ex(512, -1, 10, &options, &recorder);
+        check_condition(
+                status == PV_RECORDER_STATUS_SUCCESS,
+                __FUNCTION__,
+                __LINE__,
+                "pv_recorder_init_ex returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+        pv_recorder_delete(recorder);
+        recorder = NULL;
+
+        status = pv_recorder_init_ex(512, 0, 10, &options, &recorder);
+        check_condition(
+                status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+                __FUNCTION__,
+                __LINE__,
+                "pv_recorder_init_ex returned %s - expected %s.",
+                pv_recorder_status_to_string(status),
+                pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+    }
+
+    options.device_id = "not a device";
+    status = pv_recorder_init_ex(512, -1, 10, &options, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_init_ex returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    pv_recorder_free_available_devices(device_list_length, device_id_list);
+}
+
+static void device_change_callback(void *user_data) {
+    (void) user_data;
+}
+
+static void test_pv_recorder_set_device_change_callback(void) {
+    pv_recorder_status_t status;
+
+    status = pv_recorder_set_device_change_callback(device_change_callback, NULL, -1);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_set_device_change_callback returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    status = pv_recorder_set_device_change_callback(device_change_callback, NULL, 100);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_set_device_change_callback returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    status = pv_recorder_set_device_change_callback(device_change_callback, NULL, 0);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_set_device_change_callback returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    status = pv_recorder_set_device_change_callback(NULL, NULL, 0);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_set_device_change_callback returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+}
+
+static void test_pv_recorder_set_backends(void) {
+    pv_recorder_status_t status;
+    pv_recorder_backend_t backend;
+
+    status = pv_recorder_get_backend(NULL);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_get_backend returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    status = pv_recorder_get_backend(&backend);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_get_backend returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    check_condition(
+            pv_recorder_backend_to_string(backend) != NULL,
+            __FUNCTION__,
+            __LINE__,
+            "Backend %d has no string representation.",
+            backend);
+
+    status = pv_recorder_set_backends(NULL, 1);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_set_backends returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    const pv_recorder_backend_t invalid_backend = (pv_recorder_backend_t) 100;
+    status = pv_recorder_set_backends(&invalid_backend, 1);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_set_backends returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    status = pv_recorder_set_backends(&backend, 1);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_set_backends returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    pv_recorder_t *recorder = NULL;
+    status = pv_recorder_init(512, -1, 10, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_init returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    pv_recorder_backend_t selected_backend = PV_RECORDER_BACKEND_WASAPI;
+    status = pv_recorder_get_backend(&selected_backend);
+    check_condition(
+            (status == PV_RECORDER_STATUS_SUCCESS) && (selected_backend == backend),
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_get_backend returned %s with %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_backend_to_string(selected_backend),
+            pv_recorder_backend_to_string(backend));
+
+    status = pv_recorder_set_backends(NULL, 0);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_STATE,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_set_backends returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_STATE));
+
+    pv_recorder_delete(recorder);
+
+    status = pv_recorder_set_backends(NULL, 0);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_set_backends returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+}
+
+static void test_pv_recorder_get_device_formats(void) {
+    pv_recorder_status_t status;
+    int32_t num_device_formats = -1;
+    pv_recorder_device_format_t *device_formats = NULL;
+
+    status = pv_recorder_get_device_formats(-2, &num_device_formats, &device_formats);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_get_device_formats returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    status = pv_recorder_get_device_formats(-1, &num_device_formats, &device_formats);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_get_device_formats returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    for (int32_t i = 0; i < num_device_formats; i++) {
+        check_condition(
+                (device_formats[i].sample_rate >= 0) && (device_formats[i].num_channels >= 0),
+                __FUNCTION__,
+                __LINE__,
+                "Device format %d is invalid.",
+                i);
+    }
+    pv_recorder_free_device_formats(device_formats);
+
+    pv_recorder_t *recorder = NULL;
+    status = pv_recorder_init(512, -1, 10, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_init returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    pv_recorder_device_format_t device_format;
+    bool is_conversion_needed = false;
+    status = pv_recorder_get_device_format(recorder, &device_format, NULL);
+    check_condition(
+            status == PV_RECORDER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_get_device_format returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_INVALID_ARGUMENT));
+
+    status = pv_recorder_get_device_format(recorder, &device_format, &is_conversion_needed);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_get_device_format returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+    pv_recorder_delete(recorder);
+    recorder = NULL;
+
+    // Capturing in the device's own format needs no conversion.
+    pv_recorder_options_t options = pv_recorder_options_init();
+    options.sample_rate = 0;
+    options.num_channels = 0;
+    options.sample_format = device_format.sample_format;
+    status = pv_recorder_init_ex(512, -1, 10, &options, &recorder);
+    check_condition(
+            status == PV_RECORDER_STATUS_SUCCESS,
+            __FUNCTION__,
+            __LINE__,
+            "pv_recorder_init_ex returned %s - expected %s.",
+            pv_recorder_status_to_string(status),
+            pv_recorder_status_to_string(PV_RECORDER_STATUS_SUCCESS));
+
+    status = pv_recorder_get_device_format(recorder, &device_format, &is_conversion_needed);
+    check_condition(
+            (status == PV_RECORDER_STATUS_SUCCESS) && !is_conversion_needed,
+            __FUNCTION__,
+            __LINE__,
+            "Recorder in the device format should not convert audio.");
+    pv_recorder_delete(recorder);
 }
 
 static void test_pv_recorder_sample_rate(void) {
@@ -303,11 +2982,38 @@ static void test_pv_recorder_version(void) {
 int main() {
     srand(time(NULL));
     test_pv_recorder_get_available_devices();
+    test_pv_recorder_get_available_device_ids();
+    test_pv_recorder_set_device_change_callback();
+    test_pv_recorder_set_backends();
     test_pv_recorder_sample_rate();
     test_pv_recorder_version();
     test_pv_recorder_init();
+    test_pv_recorder_init_ex();
     test_pv_recorder_start_stop();
+    test_pv_recorder_read_with_info();
+    test_pv_recorder_read_frames();
+    test_pv_recorder_read_after_overflow();
+    test_pv_recorder_read_float();
+    test_pv_recorder_resampler();
+    test_pv_recorder_small_buffer();
+    test_pv_recorder_read_planar();
+    test_pv_recorder_peek_release();
+    test_pv_recorder_read_history();
+    test_pv_recorder_subscribe();
+    test_pv_recorder_outputs();
+    test_pv_recorder_dequeue();
+    test_pv_recorder_dequeue_stop_start();
+    test_pv_recorder_set_frame_callback();
+#if defined(__PV_RECORDER_PLATFORM_LINUX__) || defined(__PV_RECORDER_PLATFORM_RASPBERRYPI__)
+    test_pv_recorder_get_fd();
+#endif
+    test_pv_recorder_get_thread_config_status();
+    test_pv_recorder_get_stats();
+    test_pv_recorder_drain_trace_log();
+    test_pv_recorder_get_level();
+    test_pv_recorder_set_vad_gate();
     test_pv_recorder_set_debug_logging();
     test_pv_recorder_get_selected_device();
+    test_pv_recorder_get_device_formats();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,214 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <math.h>
+
+#include "pv_resampler.h"
+#include "test_helper.h"
+
+static const double PI = 3.14159265358979323846;
+
+/**
+ * Resamples `num_input_frames` of `input` in chunks of random length and returns the number of output frames.
+ */
+static int32_t resample(
+        pv_resampler_t *resampler,
+        const float *input,
+        int32_t num_input_frames,
+        int32_t num_channels,
+        int32_t max_chunk_frames,
+        float *output) {
+    int32_t num_output_frames = 0;
+    int32_t i = 0;
+    while (i < num_input_frames) {
+        int32_t length = 1 + (rand() % max_chunk_frames);
+        if (length > (num_input_frames - i)) {
+            length = num_input_frames - i;
+        }
+        num_output_frames += pv_resampler_process(
+                resampler,
+                input + (i * num_channels),
+                length,
+                output + (num_output_frames * num_channels));
+        i += length;
+    }
+    return num_output_frames;
+}
+
+static void test_pv_resampler_init(void) {
+    pv_resampler_t *resampler = NULL;
+
+    pv_resampler_status_t status = pv_resampler_init(0, 16000, 1, 256, PV_RESAMPLER_QUALITY_LOW, &resampler);
+    check_condition(status == PV_RESAMPLER_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Accepted rate 0.");
+
+    status = pv_resampler_init(48000, 16000, 0, 256, PV_RESAMPLER_QUALITY_LOW, &resampler);
+    check_condition(status == PV_RESAMPLER_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Accepted 0 channels.");
+
+    status = pv_resampler_init(48000, 16000, 1, 0, PV_RESAMPLER_QUALITY_LOW, &resampler);
+    check_condition(status == PV_RESAMPLER_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Accepted 0 frames.");
+
+    status = pv_resampler_init(48000, 16000, 1, 256, (pv_resampler_quality_t) 10, &resampler);
+    check_condition(status == PV_RESAMPLER_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Accepted quality 10.");
+
+    status = pv_resampler_init(48000, 16000, 1, 256, PV_RESAMPLER_QUALITY_LOW, NULL);
+    check_condition(status == PV_RESAMPLER_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Accepted NULL object.");
+
+    status = pv_resampler_init(44100, 16001, 1, 256, PV_RESAMPLER_QUALITY_HIGH, &resampler);
+    check_condition(
+            status == PV_RESAMPLER_STATUS_INVALID_ARGUMENT,
+            __FUNCTION__,
+            __LINE__,
+            "Accepted a ratio that needs an oversized filter bank.");
+
+    status = pv_resampler_init(44100, 16000, 2, 256, PV_RESAMPLER_QUALITY_HIGH, &resampler);
+    check_condition(status == PV_RESAMPLER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize resampler.");
+
+    pv_resampler_delete(resampler);
+}
+
+/**
+ * A tone in the passband comes out at the same amplitude and time as the ideal resampled tone, and a tone above the
+ * output Nyquist frequency is removed.
+ */
+static void test_pv_resampler_tones(void) {
+    const int32_t input_rates[3] = {48000, 44100, 8000};
+    const int32_t num_input_frames = 48000;
+    float *input = malloc((size_t) num_input_frames * sizeof(float));
+    float *output = malloc((size_t) (num_input_frames * 2) * sizeof(float));
+    check_condition((input != NULL) && (output != NULL), __FUNCTION__, __LINE__, "Failed to allocate memory.");
+
+    for (int32_t r = 0; r < 3; r++) {
+        for (int32_t quality = PV_RESAMPLER_QUALITY_LOW; quality <= PV_RESAMPLER_QUALITY_HIGH; quality++) {
+            const int32_t input_rate = input_rates[r];
+            const double frequencies[2] = {1000., 12000.};
+            const int32_t num_tones = (input_rate > 16000) ? 2 : 1;
+
+            for (int32_t t = 0; t < num_tones; t++) {
+                pv_resampler_t *resampler = NULL;
+                pv_resampler_status_t status = pv_resampler_init(
+                        input_rate,
+                        16000,
+                        1,
+                        256,
+                        (pv_resampler_quality_t) quality,
+                        &resampler);
+                check_condition(
+                        status == PV_RESAMPLER_STATUS_SUCCESS,
+                        __FUNCTION__,
+                        __LINE__,
+                        "Failed to initialize resampler.");
+
+                for (int32_t i = 0; i < num_input_frames; i++) {
+                    input[i] = (float) (0.5 * sin(2. * PI * frequencies[t] * (double) i / (double) input_rate));
+                }
+
+                const int32_t num_output_frames = resample(resampler, input, num_input_frames, 1, 256, output);
+                const int32_t expected_num_output_frames = (int32_t) ((int64_t) num_input_frames * 16000 / input_rate);
+                check_condition(
+                        (num_output_frames <= expected_num_output_frames) &&
+                        (num_output_frames > (expected_num_output_frames - 200)),
+                        __FUNCTION__,
+                        __LINE__,
+                        "Produced %d frames from %d - expected about %d.",
+                        num_output_frames,
+                        num_input_frames,
+                        expected_num_output_frames);
+
+                // Skips the start, where the filter runs over the silence before the first sample.
+                double max_error = 0.;
+                for (int32_t i = 200; i < num_output_frames; i++) {
+                    const double expected = (t == 0) ? (0.5 * sin(2. * PI * frequencies[t] * (double) i / 16000.)) : 0.;
+                    const double error = fabs((double) output[i] - expected);
+                    if (error > max_error) {
+                        max_error = error;
+                    }
+                }
+                check_condition(
+                        max_error < ((quality == PV_RESAMPLER_QUALITY_LOW) ? 1e-3 : 1e-4),
+                        __FUNCTION__,
+                        __LINE__,
+                        "Error of %g for a %gHz tone from %dHz at quality %d.",
+                        max_error,
+                        frequencies[t],
+                        input_rate,
+                        quality);
+
+                pv_resampler_delete(resampler);
+            }
+        }
+    }
+
+    free(input);
+    free(output);
+}
+
+/**
+ * The output does not depend on how the input is split into blocks, and channels are resampled independently.
+ */
+static void test_pv_resampler_blocks_and_channels(void) {
+    const int32_t num_input_frames = 4410;
+    float input[2 * 4410];
+    float mono_input[4410];
+    float output[2 * 1700];
+    float mono_output[1700];
+
+    for (int32_t i = 0; i < num_input_frames; i++) {
+        input[2 * i] = (float) ((rand() % 2001) - 1000) / 1000.f;
+        input[(2 * i) + 1] = (float) ((rand() % 2001) - 1000) / 1000.f;
+        mono_input[i] = input[(2 * i) + 1];
+    }
+
+    pv_resampler_t *resampler = NULL;
+    pv_resampler_t *mono_resampler = NULL;
+    pv_resampler_status_t status = pv_resampler_init(44100, 16000, 2, 300, PV_RESAMPLER_QUALITY_MEDIUM, &resampler);
+    check_condition(status == PV_RESAMPLER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize resampler.");
+    status = pv_resampler_init(44100, 16000, 1, 1, PV_RESAMPLER_QUALITY_MEDIUM, &mono_resampler);
+    check_condition(status == PV_RESAMPLER_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize resampler.");
+
+    const int32_t num_output_frames = resample(resampler, input, num_input_frames, 2, 300, output);
+    const int32_t num_mono_output_frames = resample(mono_resampler, mono_input, num_input_frames, 1, 1, mono_output);
+    check_condition(
+            num_output_frames == num_mono_output_frames,
+            __FUNCTION__,
+            __LINE__,
+            "Produced %d and %d frames from the same input.",
+            num_output_frames,
+            num_mono_output_frames);
+    for (int32_t i = 0; i < num_output_frames; i++) {
+        check_condition(
+                output[(2 * i) + 1] == mono_output[i],
+                __FUNCTION__,
+                __LINE__,
+                "Frame %d differs between block sizes.",
+                i);
+    }
+
+    pv_resampler_reset(resampler);
+    const int32_t num_reset_output_frames = resample(resampler, input, num_input_frames, 2, 300, output);
+    check_condition(
+            (num_reset_output_frames == num_output_frames) && (output[(2 * 10) + 1] == mono_output[10]),
+            __FUNCTION__,
+            __LINE__,
+            "Output after reset differs.");
+
+    pv_resampler_delete(resampler);
+    pv_resampler_delete(mono_resampler);
+}
+
+int main() {
+    srand(time(NULL));
+
+    test_pv_resampler_init();
+    test_pv_resampler_tones();
+    test_pv_resampler_blocks_and_channels();
+
+    return 0;
+}
@@ -0,0 +1,204 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <math.h>
+#include <string.h>
+
+#include "pv_sample_converter.h"
+#include "test_helper.h"
+
+static void test_pv_sample_converter_s16_to_f32(void) {
+    int16_t pcm[1031] = {0};
+    float output[1032];
+
+    for (int32_t num_samples = 0; num_samples <= 1031; num_samples += ((num_samples < 40) ? 1 : 97)) {
+        for (int32_t i = 0; i < num_samples; i++) {
+            pcm[i] = (int16_t) ((rand() % 65536) - 32768);
+            if ((i % 13) == 0) {
+                pcm[i] = (i % 2) ? INT16_MIN : INT16_MAX;
+            }
+        }
+        output[num_samples] = 2.f;
+
+        pv_sample_converter_s16_to_f32(pcm, num_samples, output);
+
+        for (int32_t i = 0; i < num_samples; i++) {
+            check_condition(
+                    output[i] == ((float) pcm[i] / 32768.f),
+                    __FUNCTION__,
+                    __LINE__,
+                    "Sample %d of %d is %f - expected %f.",
+                    i,
+                    num_samples,
+                    output[i],
+                    (float) pcm[i] / 32768.f);
+        }
+        check_condition(output[num_samples] == 2.f, __FUNCTION__, __LINE__, "Wrote past %d samples.", num_samples);
+    }
+
+    const int16_t limits[2] = {INT16_MIN, INT16_MAX};
+    float limits_output[2];
+    pv_sample_converter_s16_to_f32(limits, 2, limits_output);
+    check_condition(
+            (limits_output[0] == -1.f) && (limits_output[1] < 1.f),
+            __FUNCTION__,
+            __LINE__,
+            "Full scale is not mapped to [-1, 1).");
+}
+
+static void test_pv_sample_converter_s32_to_f32(void) {
+    int32_t pcm[259];
+    float output[259];
+
+    for (int32_t num_samples = 0; num_samples <= 259; num_samples += 37) {
+        for (int32_t i = 0; i < num_samples; i++) {
+            pcm[i] = (rand() % (1 << 24)) - (1 << 23);
+        }
+
+        pv_sample_converter_s32_to_f32(pcm, num_samples, 24, output);
+
+        for (int32_t i = 0; i < num_samples; i++) {
+            check_condition(
+                    output[i] == ((float) pcm[i] / 8388608.f),
+                    __FUNCTION__,
+                    __LINE__,
+                    "Sample %d of %d is %f - expected %f.",
+                    i,
+                    num_samples,
+                    output[i],
+                    (float) pcm[i] / 8388608.f);
+        }
+    }
+
+    const int32_t limits[2] = {INT32_MIN, INT32_MAX};
+    float limits_output[2];
+    pv_sample_converter_s32_to_f32(limits, 2, 32, limits_output);
+    check_condition(
+            (limits_output[0] == -1.f) && (limits_output[1] == 1.f),
+            __FUNCTION__,
+            __LINE__,
+            "32-bit full scale was converted to %f and %f.",
+            limits_output[0],
+            limits_output[1]);
+}
+
+static void test_pv_sample_converter_f32_to_s16(void) {
+    float pcm[259];
+    int16_t output[259];
+
+    for (int32_t num_samples = 0; num_samples <= 259; num_samples += 37) {
+        for (int32_t i = 0; i < num_samples; i++) {
+            pcm[i] = (float) ((rand() % 2401) - 1200) / 1000.f;
+        }
+        pcm[0] = 1.f;
+
+        pv_sample_converter_f32_to_s16(pcm, num_samples, output);
+
+        for (int32_t i = 0; i < num_samples; i++) {
+            const float x = pcm[i] * 32768.f;
+            const int32_t expected = (x >= 32767.f) ? 32767 : ((x <= -32768.f) ? -32768 : (int32_t) nearbyintf(x));
+            check_condition(
+                    output[i] == expected,
+                    __FUNCTION__,
+                    __LINE__,
+                    "Sample %d of %d is %d - expected %d.",
+                    i,
+                    num_samples,
+                    output[i],
+                    expected);
+        }
+    }
+}
+
+static void test_pv_sample_converter_f32_to_s32(void) {
+    const float pcm[5] = {-2.f, -1.f, 0.5f, 0.99999994f, 1.f};
+    const int32_t expected[5] = {-8388608, -8388608, 4194304, 8388607, 8388607};
+    int32_t output[5];
+
+    pv_sample_converter_f32_to_s32(pcm, 5, 24, output);
+
+    for (int32_t i = 0; i < 5; i++) {
+        check_condition(
+                output[i] == expected[i],
+                __FUNCTION__,
+                __LINE__,
+                "Sample %d is %d - expected %d.",
+                i,
+                output[i],
+                expected[i]);
+    }
+}
+
+static void test_pv_sample_converter_deinterleave(void) {
+    int32_t pcm[6 * 37];
+    int32_t planar[6][38];
+
+    for (int32_t sample_size = 2; sample_size <= 4; sample_size += 2) {
+        for (int32_t num_channels = 1; num_channels <= 6; num_channels++) {
+            for (int32_t num_frames = 0; num_frames <= 37; num_frames += 3) {
+                for (int32_t i = 0; i < (num_frames * num_channels); i++) {
+                    if (sample_size == 2) {
+                        ((int16_t *) pcm)[i] = (int16_t) ((rand() % 65536) - 32768);
+                    } else {
+                        pcm[i] = rand() - (RAND_MAX / 2);
+                    }
+                }
+
+                // Skips channel 1 to check that unselected channels are left untouched.
+                void *outputs[6];
+                for (int32_t c = 0; c < num_channels; c++) {
+                    memset(planar[c], 0x55, sizeof(planar[c]));
+                    outputs[c] = ((c == 1) && (num_channels > 2)) ? NULL : planar[c];
+                }
+
+                pv_sample_converter_deinterleave(pcm, num_frames, num_channels, sample_size, outputs);
+
+                for (int32_t c = 0; c < num_channels; c++) {
+                    for (int32_t i = 0; i < 38; i++) {
+                        const bool is_written = (outputs[c] != NULL) && (i < num_frames);
+                        int32_t expected = 0x55555555;
+                        int32_t actual = planar[c][i];
+                        if (sample_size == 2) {
+                            expected = is_written ? ((int16_t *) pcm)[(i * num_channels) + c] : (int16_t) 0x5555;
+                            actual = ((int16_t *) planar[c])[i];
+                        } else if (is_written) {
+                            expected = pcm[(i * num_channels) + c];
+                        }
+                        check_condition(
+                                actual == expected,
+                                __FUNCTION__,
+                                __LINE__,
+                                "Sample %d of channel %d is %d - expected %d (%d channels, %d frames, %d bytes).",
+                                i,
+                                c,
+                                actual,
+                                expected,
+                                num_channels,
+                                num_frames,
+                                sample_size);
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main() {
+    srand(time(NULL));
+
+    test_pv_sample_converter_s16_to_f32();
+    test_pv_sample_converter_s32_to_f32();
+    test_pv_sample_converter_f32_to_s16();
+    test_pv_sample_converter_f32_to_s32();
+    test_pv_sample_converter_deinterleave();
+
+    return 0;
+}
@@ -0,0 +1,174 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <pthread.h>
+
+#include "pv_trace_log.h"
+#include "test_helper.h"
+
+static void test_pv_trace_log_init(void) {
+    pv_trace_log_t *log = NULL;
+
+    pv_trace_log_status_t status = pv_trace_log_init(0, &log);
+    check_condition(status == PV_TRACE_LOG_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Accepted capacity 0.");
+
+    status = pv_trace_log_init(10, NULL);
+    check_condition(status == PV_TRACE_LOG_STATUS_INVALID_ARGUMENT, __FUNCTION__, __LINE__, "Accepted NULL object.");
+
+    status = pv_trace_log_init(10, &log);
+    check_condition(status == PV_TRACE_LOG_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize log.");
+
+    pv_trace_log_delete(log);
+}
+
+static void test_pv_trace_log_read_write(void) {
+    pv_trace_log_t *log = NULL;
+    pv_trace_log_status_t status = pv_trace_log_init(16, &log);
+    check_condition(status == PV_TRACE_LOG_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize log.");
+
+    pv_trace_log_event_t events[16];
+    uint64_t num_lost_events = 1;
+    int32_t num_events = pv_trace_log_read(log, events, 16, &num_lost_events);
+    check_condition(
+            (num_events == 0) && (num_lost_events == 0),
+            __FUNCTION__,
+            __LINE__,
+            "Read %d events from an empty log.",
+            num_events);
+
+    for (int32_t i = 0; i < 10; i++) {
+        pv_trace_log_write(log, i % 3, 1000 + i, -i);
+    }
+
+    num_events = pv_trace_log_read(log, events, 4, &num_lost_events);
+    check_condition(num_events == 4, __FUNCTION__, __LINE__, "Read %d events - expected 4.", num_events);
+    num_events += pv_trace_log_read(log, events + 4, 12, &num_lost_events);
+    check_condition(num_events == 10, __FUNCTION__, __LINE__, "Read %d events - expected 10.", num_events);
+    check_condition(num_lost_events == 0, __FUNCTION__, __LINE__, "Lost events without overflow.");
+
+    for (int32_t i = 0; i < 10; i++) {
+        check_condition(
+                (events[i].type == (i % 3)) && (events[i].timestamp_ns == (1000 + i)) && (events[i].value == -i),
+                __FUNCTION__,
+                __LINE__,
+                "Event %d is incorrect.",
+                i);
+    }
+
+    pv_trace_log_delete(log);
+}
+
+static void test_pv_trace_log_overflow(void) {
+    pv_trace_log_t *log = NULL;
+    pv_trace_log_status_t status = pv_trace_log_init(16, &log);
+    check_condition(status == PV_TRACE_LOG_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize log.");
+
+    for (int32_t i = 0; i < 40; i++) {
+        pv_trace_log_write(log, 0, i, i);
+    }
+
+    pv_trace_log_event_t events[16];
+    uint64_t num_lost_events = 0;
+    const int32_t num_events = pv_trace_log_read(log, events, 16, &num_lost_events);
+    check_condition(
+            (num_events == 16) && (num_lost_events == 24),
+            __FUNCTION__,
+            __LINE__,
+            "Read %d events and lost %d - expected 16 and 24.",
+            num_events,
+            (int32_t) num_lost_events);
+    check_condition(events[0].value == 0, __FUNCTION__, __LINE__, "Oldest event should have been kept.");
+
+    pv_trace_log_delete(log);
+}
+
+static const int32_t STRESS_NUM_WRITERS = 4;
+static const int32_t STRESS_EVENT_COUNT = 200000;
+
+typedef struct {
+    pv_trace_log_t *log;
+    int32_t writer;
+} stress_context_t;
+
+static void *stress_writer(void *arg) {
+    stress_context_t *context = (stress_context_t *) arg;
+    for (int32_t i = 0; i < STRESS_EVENT_COUNT; i++) {
+        // The value is derived from the other fields, so a torn event can be detected.
+        pv_trace_log_write(context->log, context->writer, i, ((int64_t) context->writer << 32) | i);
+    }
+    return NULL;
+}
+
+static void test_pv_trace_log_stress(void) {
+    pv_trace_log_t *log = NULL;
+    pv_trace_log_status_t status = pv_trace_log_init(1024, &log);
+    check_condition(status == PV_TRACE_LOG_STATUS_SUCCESS, __FUNCTION__, __LINE__, "Failed to initialize log.");
+
+    pthread_t writers[STRESS_NUM_WRITERS];
+    stress_context_t contexts[STRESS_NUM_WRITERS];
+    for (int32_t i = 0; i < STRESS_NUM_WRITERS; i++) {
+        contexts[i].log = log;
+        contexts[i].writer = i;
+        check_condition(
+                pthread_create(&writers[i], NULL, stress_writer, &contexts[i]) == 0,
+                __FUNCTION__,
+                __LINE__,
+                "Failed to create writer thread.");
+    }
+
+    int64_t last[STRESS_NUM_WRITERS];
+    for (int32_t i = 0; i < STRESS_NUM_WRITERS; i++) {
+        last[i] = -1;
+    }
+
+    pv_trace_log_event_t events[256];
+    uint64_t total = 0;
+    while (total < (uint64_t) (STRESS_NUM_WRITERS * STRESS_EVENT_COUNT)) {
+        uint64_t num_lost_events = 0;
+        const int32_t num_events = pv_trace_log_read(log, events, 256, &num_lost_events);
+        for (int32_t i = 0; i < num_events; i++) {
+            const int32_t writer = events[i].type;
+            check_condition(
+                    (writer >= 0) && (writer < STRESS_NUM_WRITERS) &&
+                    (events[i].value == (((int64_t) writer << 32) | events[i].timestamp_ns)),
+                    __FUNCTION__,
+                    __LINE__,
+                    "Event is torn.");
+            // Events of one writer may be dropped but never reordered.
+            check_condition(
+                    events[i].timestamp_ns > last[writer],
+                    __FUNCTION__,
+                    __LINE__,
+                    "Events of writer %d are out of order.",
+                    writer);
+            last[writer] = events[i].timestamp_ns;
+        }
+        // Every event is either read or counted as lost.
+        total += (uint64_t) num_events + num_lost_events;
+    }
+
+    for (int32_t i = 0; i < STRESS_NUM_WRITERS; i++) {
+        pthread_join(writers[i], NULL);
+    }
+
+    pv_trace_log_delete(log);
+}
+
+int main() {
+    srand(time(NULL));
+
+    test_pv_trace_log_init();
+    test_pv_trace_log_read_write();
+    test_pv_trace_log_overflow();
+    test_pv_trace_log_stress();
+
+    return 0;
+}